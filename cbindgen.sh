@@ -7,7 +7,9 @@ set -x
 # the way...
 mv -f Cargo.lock Cargo.lock.org
 
-cargo run --manifest-path=utils/cgen/Cargo.toml
+# Headers of programs whose sources are unchanged since their manifest was
+# written are skipped, pass --force to regenerate everything
+cargo run --manifest-path=utils/cgen/Cargo.toml -- "$@"
 exitcode=$?
 
 mv -f Cargo.lock.org Cargo.lock
@@ -14,6 +14,12 @@ set -x
 # Build all C examples
 make -C examples/c
 
+# Test the C libraries, against the Criterion the examples' tests use, which
+# the Solana install of ci/install-program-deps.sh provides
+make -C token/indexer
+make -C token/program/test
+make -C token-swap/program/test
+
 # Build/test all host crates
 cargo +"$rust_stable" build
 cargo +"$rust_stable" test -- --nocapture
@@ -25,12 +31,25 @@ cargo +"$rust_stable" run --manifest-path=utils/test-client/Cargo.toml
 # client_ristretto disabled because it requires RpcBanksService, which is no longer supported.
 #cargo +"$rust_stable" test --manifest-path=themis/client_ristretto/Cargo.toml -- --nocapture
 
+# Check the generated token-swap C headers
+./cbindgen.sh --force
+
+git diff --exit-code token-swap/program/inc/spl-pubkey.h
+cc token-swap/program/inc/spl-pubkey.h -o target/spl-pubkey.gch
+git diff --exit-code token-swap/program/inc/token-swap.h
+cc token-swap/program/inc/token-swap.h -o target/token-swap.gch
+git diff --exit-code token-swap/program/inc/token-swap-layout.h
+cc token-swap/program/inc/token-swap-layout.h -o target/token-swap-layout.gch
+git diff --exit-code token-swap/program/inc/token-swap-manifest.json
+
 #  # Check generated C headers
-#  cargo run --manifest-path=utils/cgen/Cargo.toml
+#  cargo run --manifest-path=utils/cgen/Cargo.toml -- --force
 #
 #  git diff --exit-code token/program/inc/token.h
 #  cc token/program/inc/token.h -o target/token.gch
-#  git diff --exit-code token-swap/program/inc/token-swap.h
-#  cc token-swap/program/inc/token-swap.h -o target/token-swap.gch
+#  git diff --exit-code token/program/inc/token-layout.h
+#  cc token/program/inc/token-layout.h -o target/token-layout.gch
+#  git diff --exit-code token/program/inc/token-manifest.json
+#  git diff --exit-code token/program/inc/spl-pubkey.h
 
 exit 0
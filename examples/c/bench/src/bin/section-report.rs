@@ -0,0 +1,28 @@
+//! Reports the compute units per section found in program logs read from
+//! standard input, as a table or with `--folded` as folded stacks
+
+use {
+    spl_example_c_bench::sections::Sections,
+    std::io::{self, BufRead},
+    std::process::exit,
+};
+
+fn main() {
+    let folded = std::env::args().any(|arg| arg == "--folded");
+    let lines: Vec<String> = io::stdin()
+        .lock()
+        .lines()
+        .collect::<Result<_, _>>()
+        .unwrap_or_else(|err| {
+            eprintln!("error: {}", err);
+            exit(1);
+        });
+    match Sections::from_logs(lines.iter().map(String::as_str)) {
+        Ok(sections) if folded => print!("{}", sections.folded()),
+        Ok(sections) => print!("{}", sections),
+        Err(err) => {
+            eprintln!("error: {}", err);
+            exit(1);
+        }
+    }
+}
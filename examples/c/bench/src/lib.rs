@@ -0,0 +1,76 @@
+//! Compute unit benchmarks for the C example programs
+//!
+//! The programs are built by `make -C examples/c` into `target/deploy` and run
+//! under the BPF VM by `solana-program-test`.  A program's consumption is found
+//! by searching for the smallest compute budget its instruction succeeds with.
+//! `sections` breaks that consumption down by program section.
+
+pub mod sections;
+
+use {
+    solana_program::instruction::Instruction,
+    solana_program_test::ProgramTest,
+    solana_sdk::{signature::Signer, transaction::Transaction},
+};
+
+/// Budget generous enough for any of the examples to complete
+const AMPLE_COMPUTE_UNITS: u64 = 200_000;
+
+async fn succeeds(
+    program_test: &impl Fn() -> ProgramTest,
+    instruction: &Instruction,
+    compute_units: u64,
+) -> bool {
+    let mut program_test = program_test();
+    program_test.set_bpf_compute_max_units(compute_units);
+    let (mut banks_client, payer, recent_blockhash) = program_test.start().await;
+
+    let mut transaction =
+        Transaction::new_with_payer(&[instruction.clone()], Some(&payer.pubkey()));
+    transaction.sign(&[&payer], recent_blockhash);
+    banks_client.process_transaction(transaction).await.is_ok()
+}
+
+/// Returns the compute units `instruction` consumes, or `None` if it needs more
+/// than `max_units`
+///
+/// The budget can only be set before the bank starts, so `program_test` is
+/// called to build a fresh test environment for every attempt.
+pub async fn compute_units(
+    program_test: impl Fn() -> ProgramTest,
+    instruction: &Instruction,
+    max_units: u64,
+) -> Option<u64> {
+    if !succeeds(&program_test, instruction, max_units).await {
+        return None;
+    }
+    let (mut low, mut high) = (0, max_units);
+    while high - low > 1 {
+        let mid = low + (high - low) / 2;
+        if succeeds(&program_test, instruction, mid).await {
+            high = mid;
+        } else {
+            low = mid;
+        }
+    }
+    Some(high)
+}
+
+/// Reports the compute units `instruction` consumes, panicking if it fails
+/// outright or regresses past `max_units`
+pub async fn assert_compute_units(
+    name: &str,
+    max_units: u64,
+    program_test: impl Fn() -> ProgramTest,
+    instruction: &Instruction,
+) {
+    assert!(
+        succeeds(&program_test, instruction, AMPLE_COMPUTE_UNITS).await,
+        "{} failed",
+        name
+    );
+    match compute_units(program_test, instruction, max_units).await {
+        Some(units) => println!("{}: {} of {} compute units", name, units, max_units),
+        None => panic!("{} regressed past {} compute units", name, max_units),
+    }
+}
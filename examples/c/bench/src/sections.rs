@@ -0,0 +1,274 @@
+//! Compute units per program section, recovered from a program's logs
+//!
+//! Programs built with `section-log.h` at debug level log a marker on entering
+//! and leaving each section next to a reading of their remaining compute
+//! units.  Those pairs are folded here into per-section totals, keyed by the
+//! stack of sections each was entered from, which render as a table or as
+//! folded stacks for flame graph tools.
+
+use std::collections::BTreeMap;
+use std::fmt::{self, Write};
+
+/// "SECT" in the upper half of a marker's first logged value
+const SECTION_TAG: u64 = 0x5345_4354;
+const SECTION_BEGIN: u64 = 0;
+const SECTION_END: u64 = 1;
+
+/// Totals of one section entered from one stack of sections
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+pub struct SectionUnits {
+    /// Times the section was entered
+    pub calls: u64,
+    /// Units consumed in the section, nested sections included
+    pub inclusive: u64,
+    /// Units consumed in the section outside of its nested sections
+    pub exclusive: u64,
+}
+
+/// Logs that do not pair up into sections
+#[derive(Clone, Debug, PartialEq, Eq)]
+pub enum SectionError {
+    /// A section ended that is not the innermost one entered
+    UnmatchedEnd(u32),
+    /// A section entered was never ended
+    Unterminated(u32),
+    /// A marker lacks its compute unit reading
+    MissingReading(u32),
+}
+
+impl fmt::Display for SectionError {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        match self {
+            SectionError::UnmatchedEnd(id) => write!(f, "section {} ended unentered", id),
+            SectionError::Unterminated(id) => write!(f, "section {} never ended", id),
+            SectionError::MissingReading(id) => {
+                write!(f, "section {} marker without its reading", id)
+            }
+        }
+    }
+}
+
+/// Section totals keyed by the identifiers of the enclosing sections, the
+/// section's own identifier last
+#[derive(Clone, Debug, Default, PartialEq, Eq)]
+pub struct Sections(pub BTreeMap<Vec<u32>, SectionUnits>);
+
+struct Frame {
+    id: u32,
+    begin: Option<u64>,
+    nested: u64,
+}
+
+enum Line {
+    Marker(u32, u64),
+    Reading(u64),
+}
+
+fn parse_value(value: &str) -> Option<u64> {
+    let value = value.trim();
+    match value.strip_prefix("0x") {
+        Some(hex) => u64::from_str_radix(hex, 16).ok(),
+        None => value.parse().ok(),
+    }
+}
+
+fn parse_line(line: &str) -> Option<Line> {
+    if let Some((_, rest)) = line.split_once("Program consumption: ") {
+        let units = rest.strip_suffix(" units remaining")?;
+        return parse_value(units).map(Line::Reading);
+    }
+    let (_, rest) = line.split_once("Program log: ")?;
+    let mut values = rest.split(", ").map(parse_value);
+    let header = values.next()??;
+    let phase = values.next()??;
+    if header >> 32 != SECTION_TAG {
+        return None;
+    }
+    Some(Line::Marker(header as u32, phase))
+}
+
+impl Sections {
+    /// Folds the logs of one program invocation, ignoring unrelated lines
+    pub fn from_logs<'a>(logs: impl IntoIterator<Item = &'a str>) -> Result<Self, SectionError> {
+        let mut sections = Sections::default();
+        let mut stack: Vec<Frame> = Vec::new();
+        // The reading since the last marker, which an end marker follows
+        let mut reading = None;
+        for line in logs {
+            match parse_line(line) {
+                Some(Line::Reading(units)) => match stack.last_mut() {
+                    Some(frame) if frame.begin.is_none() => frame.begin = Some(units),
+                    _ => reading = Some(units),
+                },
+                Some(Line::Marker(id, SECTION_BEGIN)) => {
+                    if let Some(frame) = stack.last() {
+                        frame.begin.ok_or(SectionError::MissingReading(frame.id))?;
+                    }
+                    stack.push(Frame {
+                        id,
+                        begin: None,
+                        nested: 0,
+                    });
+                    reading = None;
+                }
+                Some(Line::Marker(id, SECTION_END)) => {
+                    let frame = match stack.pop() {
+                        Some(frame) if frame.id == id => frame,
+                        _ => return Err(SectionError::UnmatchedEnd(id)),
+                    };
+                    let begin = frame.begin.ok_or(SectionError::MissingReading(id))?;
+                    let end = reading.take().ok_or(SectionError::MissingReading(id))?;
+                    let inclusive = begin.saturating_sub(end);
+                    if let Some(parent) = stack.last_mut() {
+                        parent.nested += inclusive;
+                    }
+                    let mut path: Vec<u32> = stack.iter().map(|frame| frame.id).collect();
+                    path.push(id);
+                    let units = sections.0.entry(path).or_default();
+                    units.calls += 1;
+                    units.inclusive += inclusive;
+                    units.exclusive += inclusive.saturating_sub(frame.nested);
+                }
+                _ => {}
+            }
+        }
+        match stack.pop() {
+            Some(frame) => Err(SectionError::Unterminated(frame.id)),
+            None => Ok(sections),
+        }
+    }
+
+    /// Totals per section identifier, whatever stacks it was entered from
+    pub fn by_id(&self) -> BTreeMap<u32, SectionUnits> {
+        let mut by_id = BTreeMap::<u32, SectionUnits>::new();
+        for (path, units) in &self.0 {
+            let total = by_id.entry(*path.last().unwrap()).or_default();
+            total.calls += units.calls;
+            total.exclusive += units.exclusive;
+            // A section nested in itself is counted once, by its outermost call
+            if !path[..path.len() - 1].contains(path.last().unwrap()) {
+                total.inclusive += units.inclusive;
+            }
+        }
+        by_id
+    }
+
+    /// One "outer;inner units" line per stack of exclusive units, the input
+    /// format of flame graph tools
+    pub fn folded(&self) -> String {
+        let mut folded = String::new();
+        for (path, units) in &self.0 {
+            let path: Vec<String> = path.iter().map(u32::to_string).collect();
+            writeln!(folded, "{} {}", path.join(";"), units.exclusive).unwrap();
+        }
+        folded
+    }
+}
+
+impl fmt::Display for Sections {
+    fn fmt(&self, f: &mut fmt::Formatter) -> fmt::Result {
+        writeln!(
+            f,
+            "{:>10} {:>8} {:>10} {:>10}",
+            "section", "calls", "inclusive", "exclusive"
+        )?;
+        for (id, units) in self.by_id() {
+            writeln!(
+                f,
+                "{:>10} {:>8} {:>10} {:>10}",
+                id, units.calls, units.inclusive, units.exclusive
+            )?;
+        }
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn begin(id: u32, remaining: u64) -> [String; 2] {
+        [
+            format!(
+                "Program log: {:#x}, 0x0, 0x0, 0x0, 0x0",
+                SECTION_TAG << 32 | id as u64
+            ),
+            format!("Program consumption: {} units remaining", remaining),
+        ]
+    }
+
+    fn end(id: u32, remaining: u64) -> [String; 2] {
+        [
+            format!("Program consumption: {} units remaining", remaining),
+            format!(
+                "Program log: {:#x}, 0x1, 0x0, 0x0, 0x0",
+                SECTION_TAG << 32 | id as u64
+            ),
+        ]
+    }
+
+    fn sections(lines: &[[String; 2]]) -> Result<Sections, SectionError> {
+        Sections::from_logs(lines.iter().flatten().map(String::as_str))
+    }
+
+    #[test]
+    fn nested() {
+        let logs = [
+            begin(1, 1000),
+            begin(2, 900),
+            end(2, 800),
+            begin(2, 700),
+            end(2, 650),
+            end(1, 500),
+            begin(2, 400),
+            end(2, 390),
+        ];
+        let sections = sections(&logs).unwrap();
+        let units = |calls, inclusive, exclusive| SectionUnits {
+            calls,
+            inclusive,
+            exclusive,
+        };
+        assert_eq!(sections.0[&vec![1]], units(1, 500, 350));
+        assert_eq!(sections.0[&vec![1, 2]], units(2, 150, 150));
+        assert_eq!(sections.0[&vec![2]], units(1, 10, 10));
+        assert_eq!(sections.by_id()[&2], units(3, 160, 160));
+        assert_eq!(sections.folded(), "1 350\n1;2 150\n2 10\n");
+    }
+
+    #[test]
+    fn ignores_other_logs() {
+        let [marker, reading] = begin(1, 100);
+        let logs = [
+            "Program log: static string",
+            "Program log: 0x45564e5400000001, 0x0, 0x5, 0xa, 0xe",
+            &marker,
+            "Program log: 0x1, 0x2, 0x3, 0x4, 0x5",
+            &reading,
+        ];
+        let mut logs: Vec<&str> = logs.to_vec();
+        let end = end(1, 40);
+        logs.extend(end.iter().map(String::as_str));
+        let sections = Sections::from_logs(logs).unwrap();
+        assert_eq!(sections.0[&vec![1]].inclusive, 60);
+    }
+
+    #[test]
+    fn unpaired() {
+        assert_eq!(
+            sections(&[begin(1, 10)]),
+            Err(SectionError::Unterminated(1))
+        );
+        assert_eq!(sections(&[end(1, 10)]), Err(SectionError::UnmatchedEnd(1)));
+        assert_eq!(
+            sections(&[begin(1, 10), begin(2, 9), end(1, 8)]),
+            Err(SectionError::UnmatchedEnd(1))
+        );
+        let [_, marker] = end(1, 10);
+        let logs = [begin(1, 20)[0].clone(), begin(1, 20)[1].clone(), marker];
+        assert_eq!(
+            Sections::from_logs(logs.iter().map(String::as_str)),
+            Err(SectionError::MissingReading(1))
+        );
+    }
+}
@@ -0,0 +1,150 @@
+// The C programs must be built first, `make bench` from examples/c does both
+#![cfg(feature = "test-bpf")]
+
+use {
+    solana_program::{
+        instruction::{AccountMeta, Instruction},
+        pubkey::Pubkey,
+        rent::Rent,
+        system_program,
+    },
+    solana_program_test::*,
+    solana_sdk::account::Account,
+    spl_example_c_bench::assert_compute_units,
+};
+
+// Thresholds leave headroom over the measured consumption, raise them only
+// when a change is expected to make a program more expensive
+const TRANSFER_LAMPORTS_MAX_UNITS: u64 = 2_000;
+const LOGGING_MAX_UNITS: u64 = 10_000;
+const CUSTOM_HEAP_MAX_UNITS: u64 = 2_000;
+const CUSTOM_HEAP_FREE_LIST_MAX_UNITS: u64 = 2_000;
+const CROSS_PROGRAM_INVOCATION_MAX_UNITS: u64 = 10_000;
+const LAZY_DESERIALIZE_MAX_UNITS: u64 = 1_000;
+
+#[tokio::test]
+async fn transfer_lamports() {
+    let program_id = Pubkey::new_unique();
+    let source_pubkey = Pubkey::new_unique();
+    let destination_pubkey = Pubkey::new_unique();
+    let instruction = Instruction::new_with_bytes(
+        program_id,
+        &5u64.to_le_bytes(),
+        vec![
+            AccountMeta::new(source_pubkey, false),
+            AccountMeta::new(destination_pubkey, false),
+        ],
+    );
+    assert_compute_units(
+        "transfer-lamports",
+        TRANSFER_LAMPORTS_MAX_UNITS,
+        || {
+            let mut program_test = ProgramTest::new("transfer-lamports", program_id, None);
+            program_test.add_account(
+                source_pubkey,
+                Account {
+                    lamports: 5,
+                    owner: program_id,
+                    ..Account::default()
+                },
+            );
+            program_test.add_account(
+                destination_pubkey,
+                Account {
+                    lamports: 5,
+                    ..Account::default()
+                },
+            );
+            program_test
+        },
+        &instruction,
+    )
+    .await;
+}
+
+#[tokio::test]
+async fn logging() {
+    let program_id = Pubkey::new_unique();
+    let instruction = Instruction::new_with_bytes(program_id, &[10, 11, 12, 13, 14], vec![]);
+    assert_compute_units(
+        "logging",
+        LOGGING_MAX_UNITS,
+        || ProgramTest::new("logging", program_id, None),
+        &instruction,
+    )
+    .await;
+}
+
+#[tokio::test]
+async fn custom_heap() {
+    let program_id = Pubkey::new_unique();
+    let instruction = Instruction::new_with_bytes(program_id, &[], vec![]);
+    assert_compute_units(
+        "custom-heap",
+        CUSTOM_HEAP_MAX_UNITS,
+        || ProgramTest::new("custom-heap", program_id, None),
+        &instruction,
+    )
+    .await;
+}
+
+#[tokio::test]
+async fn custom_heap_free_list() {
+    let program_id = Pubkey::new_unique();
+    let instruction = Instruction::new_with_bytes(program_id, &[], vec![]);
+    assert_compute_units(
+        "custom-heap-free-list",
+        CUSTOM_HEAP_FREE_LIST_MAX_UNITS,
+        || ProgramTest::new("custom-heap-free-list", program_id, None),
+        &instruction,
+    )
+    .await;
+}
+
+#[tokio::test]
+async fn cross_program_invocation() {
+    let program_id = Pubkey::new_unique();
+    let (allocated_pubkey, bump_seed) =
+        Pubkey::find_program_address(&[b"You pass butter"], &program_id);
+    let instruction = Instruction::new_with_bytes(
+        program_id,
+        &[bump_seed],
+        vec![
+            AccountMeta::new_readonly(system_program::id(), false),
+            AccountMeta::new(allocated_pubkey, false),
+        ],
+    );
+    assert_compute_units(
+        "cross-program-invocation",
+        CROSS_PROGRAM_INVOCATION_MAX_UNITS,
+        || {
+            let mut program_test = ProgramTest::new("cross-program-invocation", program_id, None);
+            program_test.add_account(
+                allocated_pubkey,
+                Account {
+                    lamports: Rent::default().minimum_balance(42),
+                    ..Account::default()
+                },
+            );
+            program_test
+        },
+        &instruction,
+    )
+    .await;
+}
+
+#[tokio::test]
+async fn lazy_deserialize() {
+    // Trailing accounts the program never parses should not add to its cost
+    let program_id = Pubkey::new_unique();
+    let mut accounts = vec![AccountMeta::new(Pubkey::new_unique(), false)];
+    accounts.extend((0..11).map(|_| AccountMeta::new_readonly(Pubkey::new_unique(), false)));
+    let instruction = Instruction::new_with_bytes(program_id, &[], accounts);
+    assert_compute_units(
+        "lazy-deserialize",
+        LAZY_DESERIALIZE_MAX_UNITS,
+        || ProgramTest::new("lazy-deserialize", program_id, None),
+        &instruction,
+    )
+    .await;
+}
@@ -12,6 +12,10 @@ extern uint64_t do_invoke(SolParameters *params) {
   if (params->ka_num != 2) {
     return ERROR_NOT_ENOUGH_ACCOUNT_KEYS;
   }
+  // The instruction data is the bump seed of the allocated account's address
+  if (params->data_len != 1) {
+    return ERROR_INVALID_INSTRUCTION_DATA;
+  }
   SolAccountInfo *system_program_info = &params->ka[0];
   SolAccountInfo *allocated_info = &params->ka[1];
 
@@ -21,6 +25,8 @@ extern uint64_t do_invoke(SolParameters *params) {
                                  {&params->data[0], 1}};
   const SolSignerSeeds signers_seeds[] = {{seeds, SOL_ARRAY_SIZE(seeds)}};
 
+  // The client passes the bump seed along with the address it found, which
+  // the program verifies once instead of searching for a bump itself
   SolPubkey expected_allocated_key;
   if (SUCCESS != sol_create_program_address(seeds, SOL_ARRAY_SIZE(seeds),
                                             params->program_id,
@@ -0,0 +1,5 @@
+/**
+ * @brief The custom heap example built with its free list allocator
+ */
+#define HEAP_FREE_LIST_
+#include "../custom-heap/custom-heap.c"
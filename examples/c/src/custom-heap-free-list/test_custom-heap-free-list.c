@@ -0,0 +1,14 @@
+// goes away when the sdk incorporates it
+int printf(const char * restrictformat, ... );
+
+#include "custom-heap-free-list.c"
+#include <criterion/criterion.h>
+
+Test(custom_heap_free_list, allocator) {
+  static uint64_t heap[1024];
+  HeapAllocator allocator = {(uint64_t)heap, sizeof(heap)};
+  void *ptr = alloc(&allocator, 24, sizeof(uint64_t));
+  cr_assert(NULL != ptr);
+  dealloc(&allocator, ptr);
+  cr_assert(ptr == alloc(&allocator, 32, sizeof(uint64_t)));
+}
@@ -5,14 +5,32 @@
 
 /// Start address of the memory region used for program heap.
 #define HEAP_START_ADDRESS_ (uint64_t)0x300000000
-/// Length of the heap memory region used for program heap.
+/// Length of the heap memory region used for program heap.  Programs that
+/// request a larger heap frame from the runtime can override it, the length
+/// is validated by `heap_length_is_valid` before the heap is used.
+#ifndef HEAP_LENGTH_
 #define HEAP_LENGTH_ (uint64_t)(32 * 1024)
+#endif
+/// Smallest heap frame the runtime provides
+#define MIN_HEAP_LENGTH_ (uint64_t)(32 * 1024)
+/// Largest heap frame the runtime can provide
+#define MAX_HEAP_LENGTH_ (uint64_t)(256 * 1024)
 
-typedef struct BumpAllocator {
+/// Heap frames are sized in whole KiB between the minimum and maximum
+bool heap_length_is_valid(uint64_t length) {
+  return length >= MIN_HEAP_LENGTH_ && length <= MAX_HEAP_LENGTH_ &&
+         0 == length % 1024;
+}
+
+/// Heap region an allocator manages.  The bump allocator and the free list
+/// allocator both keep their bookkeeping at the start of the region, and
+/// `alloc` and `dealloc` use the one selected by `HEAP_FREE_LIST_`.
+typedef struct HeapAllocator {
   uint64_t start;
   uint64_t size;
-} BumpAllocator;
-void *alloc(BumpAllocator *self, uint64_t size, uint64_t align) {
+} HeapAllocator;
+
+void *bump_alloc(HeapAllocator *self, uint64_t size, uint64_t align) {
   uint64_t *pos_ptr = (uint64_t *)self->start;
 
   uint64_t pos = *pos_ptr;
@@ -26,16 +44,117 @@ void *alloc(BumpAllocator *self, uint64_t size, uint64_t align) {
     pos = pos - size;
   }
   pos &= ~(align - 1);
-  if (pos < self->start + sizeof(uint8_t)) {
+  // The first word of the region holds the position
+  if (pos < self->start + sizeof(uint64_t)) {
     return NULL;
   }
   *pos_ptr = pos;
   return (void *)pos;
 }
-void dealloc(BumpAllocator *self, void *ptr) {
+void bump_dealloc(HeapAllocator *self, void *ptr) {
   // I'm a bump allocator, I don't free
 }
 
+/// Saved bump position, see `mark` and `release` of the bump allocator
+typedef uint64_t HeapMark;
+HeapMark mark(HeapAllocator *self) {
+  uint64_t pos = *(uint64_t *)self->start;
+  if (pos == 0) {
+    pos = self->start + self->size;
+  }
+  return pos;
+}
+/// Frees everything allocated since `mark` was taken.  Marks taken after
+/// `mark` are invalidated.
+void release(HeapAllocator *self, HeapMark mark) {
+  *(uint64_t *)self->start = mark;
+}
+
+/// Smallest size class, large enough to hold a free list link
+#define HEAP_MIN_CLASS_ (uint64_t)16
+/// Number of power-of-two size classes, the largest being the largest heap
+#define HEAP_NUM_CLASSES_ 15
+/// Largest alignment the free list allocator supports
+#define HEAP_MAX_ALIGN_ (uint64_t)64
+
+/// Bookkeeping stored at the start of the free list allocator's region
+typedef struct FreeListState {
+  /// Next never-used address, zero until the first allocation
+  uint64_t pos;
+  /// Free list heads, one per size class
+  uint64_t free[HEAP_NUM_CLASSES_];
+} FreeListState;
+
+uint64_t align_up(uint64_t value, uint64_t align) {
+  return (value + align - 1) & ~(align - 1);
+}
+uint64_t size_class(uint64_t size) {
+  uint64_t class = 0;
+  while ((HEAP_MIN_CLASS_ << class) < size) {
+    class++;
+  }
+  return class;
+}
+/// Each block is preceded by a word holding its size class, and a free
+/// block's first word links to the next free block of the same class
+void *free_list_alloc(HeapAllocator *self, uint64_t size, uint64_t align) {
+  FreeListState *state = (FreeListState *)self->start;
+  if (state->pos == 0) {
+    // First time, start handing out memory after the bookkeeping
+    state->pos = self->start + sizeof(FreeListState);
+  }
+  if (align > HEAP_MAX_ALIGN_ || size > self->size) {
+    return NULL;
+  }
+  uint64_t class = size_class(size < align ? align : size);
+  if (class >= HEAP_NUM_CLASSES_) {
+    return NULL;
+  }
+
+  // Reuse the most recently freed block of the class if there is one
+  if (state->free[class] != 0) {
+    uint64_t *block = (uint64_t *)state->free[class];
+    state->free[class] = *block;
+    return block;
+  }
+
+  // Otherwise carve a new block out of the never-used part of the region
+  uint64_t block_size = HEAP_MIN_CLASS_ << class;
+  uint64_t block_align =
+      block_size < HEAP_MAX_ALIGN_ ? block_size : HEAP_MAX_ALIGN_;
+  uint64_t ptr = align_up(state->pos + sizeof(uint64_t), block_align);
+  if (ptr + block_size > self->start + self->size) {
+    return NULL;
+  }
+  ((uint64_t *)ptr)[-1] = class;
+  state->pos = ptr + block_size;
+  return (void *)ptr;
+}
+void free_list_dealloc(HeapAllocator *self, void *ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+  FreeListState *state = (FreeListState *)self->start;
+  uint64_t *block = (uint64_t *)ptr;
+  uint64_t class = block[-1];
+  *block = state->free[class];
+  state->free[class] = (uint64_t)block;
+}
+
+/// The heap's allocator, the free list allocator if `HEAP_FREE_LIST_` is
+/// defined and the bump allocator otherwise
+#ifdef HEAP_FREE_LIST_
+void *alloc(HeapAllocator *self, uint64_t size, uint64_t align) {
+  return free_list_alloc(self, size, align);
+}
+void dealloc(HeapAllocator *self, void *ptr) { free_list_dealloc(self, ptr); }
+#else
+void *alloc(HeapAllocator *self, uint64_t size, uint64_t align) {
+  return bump_alloc(self, size, align);
+}
+void dealloc(HeapAllocator *self, void *ptr) { bump_dealloc(self, ptr); }
+#endif
+
 extern uint64_t entrypoint(const uint8_t *input) {
   SolAccountInfo accounts[2];
   SolParameters params = (SolParameters){.ka = accounts};
@@ -43,9 +162,14 @@ extern uint64_t entrypoint(const uint8_t *input) {
   if (!sol_deserialize(input, &params, SOL_ARRAY_SIZE(accounts))) {
     return ERROR_INVALID_ARGUMENT;
   }
+  if (!heap_length_is_valid(HEAP_LENGTH_)) {
+    return ERROR_INVALID_ARGUMENT;
+  }
 
-  BumpAllocator heap = {HEAP_START_ADDRESS_, HEAP_LENGTH_};
-  sol_assert(0 != alloc(&heap, 1, sizeof(uint64_t)));
+  HeapAllocator heap = {HEAP_START_ADDRESS_, HEAP_LENGTH_};
+  void *ptr = alloc(&heap, 1, sizeof(uint64_t));
+  sol_assert(0 != ptr);
+  dealloc(&heap, ptr);
 
   return SUCCESS;
 }
@@ -15,35 +15,78 @@ uint64_t test_heap(uint64_t start, uint64_t size) {
 
   // alloc the entire
   {
-    BumpAllocator heap = {start, size};
-    for (int i = 0; i < size - sizeof(uint8_t); i++) {
-      void *ptr = alloc(&heap, 1, sizeof(uint8_t));
+    sol_memset((void *)start, 0, size);
+    HeapAllocator heap = {start, size};
+    for (int i = 0; i < size - sizeof(uint64_t); i++) {
+      void *ptr = bump_alloc(&heap, 1, sizeof(uint8_t));
       sol_assert(NULL != ptr);
       sol_assert(ptr == (void *)(start + size - 1 - i));
     }
-    sol_assert(NULL == alloc(&heap, 1, sizeof(uint8_t)));
+    sol_assert(NULL == bump_alloc(&heap, 1, sizeof(uint8_t)));
   }
   // check alignment
   {
     sol_memset((void *)start, 0, size);
-    BumpAllocator heap = {start, size};
+    HeapAllocator heap = {start, size};
     void *ptr = NULL;
-    ptr = alloc(&heap, 1, sizeof(uint16_t));
+    ptr = bump_alloc(&heap, 1, sizeof(uint16_t));
     sol_assert(is_aligned(ptr, sizeof(uint16_t)));
-    ptr = alloc(&heap, 1, sizeof(uint32_t));
+    ptr = bump_alloc(&heap, 1, sizeof(uint32_t));
     sol_assert(is_aligned(ptr, sizeof(uint32_t)));
-    ptr = alloc(&heap, 1, sizeof(uint64_t));
+    ptr = bump_alloc(&heap, 1, sizeof(uint64_t));
     sol_assert(is_aligned(ptr, sizeof(uint64_t)));
-    ptr = alloc(&heap, 1, 64);
+    ptr = bump_alloc(&heap, 1, 64);
     sol_assert(is_aligned(ptr, 64));
   }
   // alloc entire block (minus the pos ptr)
   {
     sol_memset((void *)start, 0, size);
-    BumpAllocator heap = {start, size};
-    void *ptr = alloc(&heap, size - 8, sizeof(uint8_t));
+    HeapAllocator heap = {start, size};
+    void *ptr = bump_alloc(&heap, size - 8, sizeof(uint8_t));
     sol_assert(ptr != NULL);
   }
+  // allocations beyond the capacity fail
+  {
+    sol_memset((void *)start, 0, size);
+    HeapAllocator heap = {start, size};
+    sol_assert(NULL == bump_alloc(&heap, size, sizeof(uint8_t)));
+    sol_assert(NULL == bump_alloc(&heap, UINT64_MAX, sizeof(uint8_t)));
+    // Nothing may overlap the position word `mark` and `release` rely on
+    sol_assert(NULL == bump_alloc(&heap, size - 1, sizeof(uint8_t)));
+    sol_assert(NULL == bump_alloc(&heap, size - 7, sizeof(uint8_t)));
+    sol_assert(NULL != bump_alloc(&heap, size - 8, sizeof(uint64_t)));
+    sol_assert(NULL == bump_alloc(&heap, 8, sizeof(uint64_t)));
+  }
+
+  // release frees everything allocated after the mark
+  {
+    sol_memset((void *)start, 0, size);
+    HeapAllocator heap = {start, size};
+    void *outer = bump_alloc(&heap, 8, sizeof(uint64_t));
+    sol_assert(NULL != outer);
+    HeapMark scope = mark(&heap);
+    for (int i = 0; i < 4; i++) {
+      HeapMark iteration = mark(&heap);
+      void *first = bump_alloc(&heap, size / 4, sizeof(uint8_t));
+      sol_assert(NULL != first);
+      sol_assert(NULL != bump_alloc(&heap, size / 4, sizeof(uint8_t)));
+      release(&heap, iteration);
+      sol_assert(first == bump_alloc(&heap, size / 4, sizeof(uint8_t)));
+      release(&heap, iteration);
+    }
+    release(&heap, scope);
+    sol_assert(scope == mark(&heap));
+    sol_assert((uint64_t)outer - 8 == (uint64_t)bump_alloc(&heap, 8, sizeof(uint64_t)));
+  }
+  // marking an unused heap
+  {
+    sol_memset((void *)start, 0, size);
+    HeapAllocator heap = {start, size};
+    HeapMark empty = mark(&heap);
+    sol_assert(NULL != bump_alloc(&heap, size - 8, sizeof(uint8_t)));
+    release(&heap, empty);
+    sol_assert(NULL != bump_alloc(&heap, size - 8, sizeof(uint8_t)));
+  }
 
   return SUCCESS;
 }
@@ -52,3 +95,114 @@ Test(custom_heap, sanity) {
   uint8_t heap[128] = {0};
   cr_assert(SUCCESS == test_heap((uint64_t)heap, 128));
 }
+
+uint64_t test_free_list_heap(uint64_t start, uint64_t size) {
+
+  // freed blocks are reused
+  {
+    sol_memset((void *)start, 0, size);
+    HeapAllocator heap = {start, size};
+    void *first = free_list_alloc(&heap, 24, sizeof(uint64_t));
+    sol_assert(NULL != first);
+    free_list_dealloc(&heap, first);
+    sol_assert(first == free_list_alloc(&heap, 32, sizeof(uint64_t)));
+    void *large = free_list_alloc(&heap, 5000, sizeof(uint64_t));
+    sol_assert(NULL != large);
+    free_list_dealloc(&heap, large);
+    sol_assert(large == free_list_alloc(&heap, 4500, sizeof(uint64_t)));
+  }
+  // check alignment
+  {
+    sol_memset((void *)start, 0, size);
+    HeapAllocator heap = {start, size};
+    void *ptr = NULL;
+    ptr = free_list_alloc(&heap, 1, sizeof(uint16_t));
+    sol_assert(is_aligned(ptr, sizeof(uint16_t)));
+    ptr = free_list_alloc(&heap, 1, sizeof(uint32_t));
+    sol_assert(is_aligned(ptr, sizeof(uint32_t)));
+    ptr = free_list_alloc(&heap, 1, sizeof(uint64_t));
+    sol_assert(is_aligned(ptr, sizeof(uint64_t)));
+    ptr = free_list_alloc(&heap, 1, 64);
+    sol_assert(is_aligned(ptr, 64));
+    ptr = free_list_alloc(&heap, 5000, 64);
+    sol_assert(is_aligned(ptr, 64));
+    sol_assert(NULL == free_list_alloc(&heap, 1, 128));
+  }
+  // filling the heap, freeing everything and filling it again fits the same
+  // number of blocks
+  {
+    sol_memset((void *)start, 0, size);
+    HeapAllocator heap = {start, size};
+    void *ptrs[1024];
+    int count = 0;
+    while (count < SOL_ARRAY_SIZE(ptrs)) {
+      void *ptr = free_list_alloc(&heap, 256, sizeof(uint64_t));
+      if (NULL == ptr) {
+        break;
+      }
+      ptrs[count++] = ptr;
+    }
+    sol_assert(count > 0 && count < SOL_ARRAY_SIZE(ptrs));
+    for (int i = 0; i < count; i++) {
+      free_list_dealloc(&heap, ptrs[i]);
+    }
+    for (int i = 0; i < count; i++) {
+      sol_assert(NULL != free_list_alloc(&heap, 256, sizeof(uint64_t)));
+    }
+    sol_assert(NULL == free_list_alloc(&heap, 256, sizeof(uint64_t)));
+  }
+  // temporary buffers built in a loop never exhaust the heap
+  {
+    sol_memset((void *)start, 0, size);
+    HeapAllocator heap = {start, size};
+    for (int i = 0; i < 10000; i++) {
+      uint64_t len = 1 + (i * 37) % (size / 4);
+      uint8_t *scratch = free_list_alloc(&heap, len, sizeof(uint64_t));
+      sol_assert(NULL != scratch);
+      sol_memset(scratch, 0xff, len);
+      uint8_t *other = free_list_alloc(&heap, 24, sizeof(uint64_t));
+      sol_assert(NULL != other);
+      free_list_dealloc(&heap, scratch);
+      free_list_dealloc(&heap, other);
+    }
+  }
+  // too large allocations fail
+  {
+    sol_memset((void *)start, 0, size);
+    HeapAllocator heap = {start, size};
+    sol_assert(NULL == free_list_alloc(&heap, size, sizeof(uint8_t)));
+    sol_assert(NULL == free_list_alloc(&heap, UINT64_MAX, sizeof(uint8_t)));
+  }
+
+  return SUCCESS;
+}
+
+Test(custom_heap, free_list) {
+  static uint64_t heap[16 * 1024 / sizeof(uint64_t)];
+  cr_assert(SUCCESS == test_free_list_heap((uint64_t)heap, sizeof(heap)));
+}
+
+Test(custom_heap, allocator) {
+  uint64_t heap[16] = {0};
+  HeapAllocator allocator = {(uint64_t)heap, sizeof(heap)};
+  void *ptr = alloc(&allocator, 8, sizeof(uint64_t));
+  sol_assert(ptr == (void *)&heap[15]);
+  dealloc(&allocator, ptr);
+  // The default bump allocator does not reuse freed memory
+  sol_assert(ptr != alloc(&allocator, 8, sizeof(uint64_t)));
+}
+
+Test(custom_heap, sizes) {
+  static uint64_t heap[MAX_HEAP_LENGTH_ / sizeof(uint64_t)];
+  uint64_t sizes[] = {MIN_HEAP_LENGTH_, 64 * 1024, 100 * 1024,
+                      MAX_HEAP_LENGTH_};
+  for (int i = 0; i < SOL_ARRAY_SIZE(sizes); i++) {
+    cr_assert(heap_length_is_valid(sizes[i]));
+    cr_assert(SUCCESS == test_heap((uint64_t)heap, sizes[i]));
+    cr_assert(SUCCESS == test_free_list_heap((uint64_t)heap, sizes[i]));
+  }
+  cr_assert(heap_length_is_valid(HEAP_LENGTH_));
+  cr_assert(!heap_length_is_valid(16 * 1024));
+  cr_assert(!heap_length_is_valid(MAX_HEAP_LENGTH_ + 1024));
+  cr_assert(!heap_length_is_valid(MIN_HEAP_LENGTH_ + 1));
+}
@@ -0,0 +1,134 @@
+/**
+ * @brief A program demonstrating deserializing only the accounts it uses
+ *
+ * `sol_deserialize` parses every account in the input up front.  The lazy
+ * deserializer below walks the serialized input only as far as the account
+ * being asked for, so trailing accounts the instruction never touches cost
+ * nothing.
+ */
+#include <solana_sdk.h>
+
+/// Serialized size of an account that duplicates an earlier one
+#define DUPLICATE_ACCOUNT_SIZE 8
+/// Offset of the data length in a serialized, non-duplicate account
+#define ACCOUNT_DATA_LEN_OFFSET (8 + sizeof(SolPubkey) * 2 + sizeof(uint64_t))
+
+typedef struct LazyInput {
+  /// Start of the serialized accounts
+  const uint8_t *accounts;
+  /// Number of serialized accounts
+  uint64_t ka_num;
+  /// Index of the account `next` points at
+  uint64_t next_index;
+  /// Position of the next account to walk over
+  const uint8_t *next;
+} LazyInput;
+
+bool lazy_input_init(LazyInput *lazy, const uint8_t *input) {
+  if (NULL == input) {
+    return false;
+  }
+  lazy->ka_num = *(uint64_t *)input;
+  lazy->accounts = input + sizeof(uint64_t);
+  lazy->next_index = 0;
+  lazy->next = lazy->accounts;
+  return true;
+}
+
+/// Returns the position just past the serialized account at `input`
+const uint8_t *lazy_skip_account(const uint8_t *input) {
+  if (input[0] != UINT8_MAX) {
+    return input + DUPLICATE_ACCOUNT_SIZE;
+  }
+  uint64_t data_len = *(uint64_t *)(input + ACCOUNT_DATA_LEN_OFFSET);
+  input += ACCOUNT_DATA_LEN_OFFSET + sizeof(uint64_t) + data_len +
+           MAX_PERMITTED_DATA_INCREASE;
+  input = (uint8_t *)(((uint64_t)input + 8 - 1) & ~(8 - 1));
+  return input + sizeof(uint64_t);
+}
+
+/// Walks to the serialized account at `index`
+const uint8_t *lazy_seek(LazyInput *lazy, uint64_t index) {
+  if (index < lazy->next_index) {
+    lazy->next_index = 0;
+    lazy->next = lazy->accounts;
+  }
+  while (lazy->next_index < index) {
+    lazy->next = lazy_skip_account(lazy->next);
+    lazy->next_index++;
+  }
+  return lazy->next;
+}
+
+/**
+ * Fills in `account` with a view of the account at `index`, parsing only the
+ * serialized accounts up to it
+ */
+bool lazy_input_account(LazyInput *lazy, uint64_t index,
+                        SolAccountInfo *account) {
+  if (index >= lazy->ka_num) {
+    return false;
+  }
+  const uint8_t *input = lazy_seek(lazy, index);
+  uint8_t dup_info = input[0];
+  if (dup_info != UINT8_MAX) {
+    // Duplicates always refer to the first occurrence, which is not itself a
+    // duplicate.  Walk to it without losing the current position.
+    LazyInput first = {lazy->accounts, lazy->ka_num, 0, lazy->accounts};
+    input = lazy_seek(&first, dup_info);
+  }
+  input += sizeof(uint8_t);
+  account->is_signer = *(uint8_t *)input != 0;
+  input += sizeof(uint8_t);
+  account->is_writable = *(uint8_t *)input != 0;
+  input += sizeof(uint8_t);
+  account->executable = *(uint8_t *)input;
+  input += sizeof(uint8_t);
+  input += 4; // padding
+  account->key = (SolPubkey *)input;
+  input += sizeof(SolPubkey);
+  account->owner = (SolPubkey *)input;
+  input += sizeof(SolPubkey);
+  account->lamports = (uint64_t *)input;
+  input += sizeof(uint64_t);
+  account->data_len = *(uint64_t *)input;
+  input += sizeof(uint64_t);
+  account->data = (uint8_t *)input;
+  input += account->data_len + MAX_PERMITTED_DATA_INCREASE;
+  input = (uint8_t *)(((uint64_t)input + 8 - 1) & ~(8 - 1));
+  account->rent_epoch = *(uint64_t *)input;
+  return true;
+}
+
+/**
+ * Fills in the instruction data and program id of `params`, which are
+ * serialized after all the accounts
+ */
+void lazy_input_instruction(LazyInput *lazy, SolParameters *params) {
+  const uint8_t *input = lazy_seek(lazy, lazy->ka_num);
+  params->ka_num = lazy->ka_num;
+  params->data_len = *(uint64_t *)input;
+  input += sizeof(uint64_t);
+  params->data = input;
+  input += params->data_len;
+  params->program_id = (SolPubkey *)input;
+}
+
+extern uint64_t entrypoint(const uint8_t *input) {
+  LazyInput lazy;
+  if (!lazy_input_init(&lazy, input)) {
+    return ERROR_INVALID_ARGUMENT;
+  }
+
+  // As part of the program specification the first account must be
+  // writable, any accounts after it are never parsed
+  SolAccountInfo writable_info;
+  if (!lazy_input_account(&lazy, 0, &writable_info)) {
+    return ERROR_NOT_ENOUGH_ACCOUNT_KEYS;
+  }
+  if (!writable_info.is_writable) {
+    return ERROR_INVALID_ARGUMENT;
+  }
+
+  return SUCCESS;
+}
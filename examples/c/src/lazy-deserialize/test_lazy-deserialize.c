@@ -0,0 +1,152 @@
+#include "lazy-deserialize.c"
+#include <criterion/criterion.h>
+#include "../../test/fixtures.h"
+
+static uint64_t input[4 * (MAX_PERMITTED_DATA_INCREASE + 256) / 8];
+
+Test(lazy_deserialize, matches_sol_deserialize) {
+  SolPubkey program_id = {.x = {1}};
+  SolPubkey keys[] = {{.x = {2}}, {.x = {3}}, {.x = {4}}};
+  uint64_t lamports[] = {10, 20, 30};
+  uint8_t data[] = {5, 6, 7};
+  SolAccountInfo accounts[] = {
+      {&keys[0], &lamports[0], 1, data, &program_id, 1, true, false, false},
+      {&keys[1], &lamports[1], 3, data, &program_id, 2, false, true, false},
+      {0},
+      {&keys[2], &lamports[2], 0, data, &keys[0], 3, false, false, true},
+  };
+  uint8_t dup_info[] = {UINT8_MAX, UINT8_MAX, 0, UINT8_MAX};
+  uint8_t instruction_data[] = {8, 9};
+  fixture_serialize((uint8_t *)input, accounts, dup_info,
+                    SOL_ARRAY_SIZE(accounts), instruction_data,
+                    sizeof(instruction_data), &program_id);
+
+  SolAccountInfo expected[4];
+  SolParameters params = {.ka = expected};
+  cr_assert(sol_deserialize((uint8_t *)input, &params, SOL_ARRAY_SIZE(expected)));
+
+  LazyInput lazy;
+  cr_assert(lazy_input_init(&lazy, (uint8_t *)input));
+  // Walk out of order to exercise rewinding and duplicates
+  uint64_t order[] = {3, 1, 2, 0, 2};
+  for (int i = 0; i < SOL_ARRAY_SIZE(order); i++) {
+    SolAccountInfo account;
+    cr_assert(lazy_input_account(&lazy, order[i], &account));
+    SolAccountInfo *want = &expected[order[i]];
+    cr_assert(account.key == want->key);
+    cr_assert(account.lamports == want->lamports);
+    cr_assert(account.data_len == want->data_len);
+    cr_assert(account.data == want->data);
+    cr_assert(account.owner == want->owner);
+    cr_assert(account.rent_epoch == want->rent_epoch);
+    cr_assert(account.is_signer == want->is_signer);
+    cr_assert(account.is_writable == want->is_writable);
+    cr_assert(account.executable == want->executable);
+  }
+  SolAccountInfo account;
+  cr_assert(!lazy_input_account(&lazy, 4, &account));
+
+  SolParameters lazy_params;
+  lazy_input_instruction(&lazy, &lazy_params);
+  cr_assert(lazy_params.ka_num == params.ka_num);
+  cr_assert(lazy_params.data == params.data);
+  cr_assert(lazy_params.data_len == params.data_len);
+  cr_assert(lazy_params.program_id == params.program_id);
+}
+
+Test(lazy_deserialize, entrypoint) {
+  SolPubkey program_id = {.x = {1}};
+  SolPubkey key = {.x = {2}};
+  uint64_t lamports = 1;
+  SolAccountInfo accounts[] = {
+      {&key, &lamports, 0, NULL, &program_id, 0, false, true, false},
+      {0},
+  };
+  uint8_t dup_info[] = {UINT8_MAX, 0};
+  fixture_serialize((uint8_t *)input, accounts, dup_info,
+                    SOL_ARRAY_SIZE(accounts), NULL, 0, &program_id);
+  cr_assert(SUCCESS == entrypoint((uint8_t *)input));
+
+  accounts[0].is_writable = false;
+  fixture_serialize((uint8_t *)input, accounts, dup_info,
+                    SOL_ARRAY_SIZE(accounts), NULL, 0, &program_id);
+  cr_assert(ERROR_INVALID_ARGUMENT == entrypoint((uint8_t *)input));
+
+  fixture_serialize((uint8_t *)input, accounts, dup_info, 0, NULL, 0,
+                    &program_id);
+  cr_assert(ERROR_NOT_ENOUGH_ACCOUNT_KEYS == entrypoint((uint8_t *)input));
+}
+
+Test(lazy_deserialize, fuzz) {
+  // Every account walked to lazily matches the account `sol_deserialize`
+  // parses, for any mix of sizes and duplicates
+  FixtureRng rng = {1};
+  uint64_t iterations = fixture_iterations(200);
+  for (uint64_t i = 0; i < iterations; i++) {
+    Fixture fixture;
+    cr_assert(fixture_random(&fixture, &rng, 16, 64));
+    SolAccountInfo expected[16];
+    SolParameters params = {.ka = expected};
+    cr_assert(sol_deserialize(fixture.input, &params, SOL_ARRAY_SIZE(expected)));
+    LazyInput lazy;
+    cr_assert(lazy_input_init(&lazy, fixture.input));
+    for (uint64_t j = 0; j < params.ka_num; j++) {
+      uint64_t index = fixture_below(&rng, params.ka_num);
+      SolAccountInfo account;
+      cr_assert(lazy_input_account(&lazy, index, &account));
+      cr_assert(account.key == expected[index].key);
+      cr_assert(account.lamports == expected[index].lamports);
+      cr_assert(account.data == expected[index].data);
+      cr_assert(account.data_len == expected[index].data_len);
+    }
+    SolParameters lazy_params;
+    lazy_input_instruction(&lazy, &lazy_params);
+    cr_assert(lazy_params.data == params.data);
+    cr_assert(lazy_params.program_id == params.program_id);
+
+    uint64_t result = entrypoint(fixture.input);
+    cr_assert(result == (params.ka_num == 0    ? ERROR_NOT_ENOUGH_ACCOUNT_KEYS
+                         : expected[0].is_writable ? SUCCESS
+                                                   : ERROR_INVALID_ARGUMENT));
+    fixture_free(&fixture);
+  }
+}
+
+/// Parses every account of `input` like a program built on `sol_deserialize`
+static uint64_t eager_entrypoint(const uint8_t *input) {
+  SolAccountInfo accounts[64];
+  SolParameters params = (SolParameters){.ka = accounts};
+  if (!sol_deserialize(input, &params, SOL_ARRAY_SIZE(accounts))) {
+    return ERROR_INVALID_ARGUMENT;
+  }
+  return params.ka_num == 0 || accounts[0].is_writable ? SUCCESS
+                                                       : ERROR_INVALID_ARGUMENT;
+}
+
+Test(lazy_deserialize, throughput) {
+  // Deserialization cost grows with the accounts parsed, not their data
+  const uint64_t ka_nums[] = {1, 8, 64};
+  const uint64_t data_lens[] = {0, 1024, 10 * 1024};
+  uint64_t iterations = fixture_iterations(1000);
+  for (int a = 0; a < SOL_ARRAY_SIZE(ka_nums); a++) {
+    for (int d = 0; d < SOL_ARRAY_SIZE(data_lens); d++) {
+      uint64_t lens[64];
+      for (int i = 0; i < ka_nums[a]; i++) {
+        lens[i] = data_lens[d];
+      }
+      Fixture fixture;
+      cr_assert(fixture_init(&fixture, ka_nums[a], lens, 0));
+      cr_assert(fixture_serialize_input(&fixture));
+      cr_assert(SUCCESS == entrypoint(fixture.input));
+      cr_assert(SUCCESS == eager_entrypoint(fixture.input));
+      cr_log_info("%3llu accounts of %5llu bytes: sol_deserialize %.0f/s, "
+                  "lazy %.0f/s",
+                  (unsigned long long)ka_nums[a],
+                  (unsigned long long)data_lens[d],
+                  fixture_throughput(eager_entrypoint, fixture.input,
+                                     iterations),
+                  fixture_throughput(entrypoint, fixture.input, iterations));
+      fixture_free(&fixture);
+    }
+  }
+}
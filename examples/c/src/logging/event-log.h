@@ -0,0 +1,81 @@
+/**
+ * @brief Compact event logging with a compile-time log level
+ *
+ * An event is a fixed-schema record of an identifier plus four values, encoded
+ * once and emitted with a single `sol_log_64` syscall.  Off-chain tooling finds
+ * events by the `LOG_EVENT_TAG_` in the upper half of the first logged value.
+ *
+ * Logging below `LOG_LEVEL` compiles to nothing, arguments included, so debug
+ * logging costs no compute units unless the program is built with
+ * `-DLOG_LEVEL=LOG_LEVEL_DEBUG`.
+ */
+#pragma once
+
+#include <solana_sdk.h>
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+/// Marks a logged value as the header of an event ("EVNT")
+#define LOG_EVENT_TAG_ (uint64_t)0x45564e54
+
+/// A fixed-schema event record
+typedef struct {
+  /// Program-defined event identifier
+  uint32_t id;
+  /// Event values, their meaning is defined by `id`
+  uint64_t values[4];
+} LogEvent;
+
+/// Encodes the first logged value of an event
+static uint64_t log_event_header(uint32_t id) {
+  return (LOG_EVENT_TAG_ << 32) | id;
+}
+
+/// Emits `event` with a single syscall
+static void log_event(const LogEvent *event) {
+  sol_log_64(log_event_header(event->id), event->values[0], event->values[1],
+             event->values[2], event->values[3]);
+}
+
+#define LOG_NOTHING_ \
+  do {               \
+  } while (0)
+
+#define LOG_EVENT_(id, a, b, c, d)                        \
+  do {                                                    \
+    const LogEvent event_ = {(id), {(a), (b), (c), (d)}}; \
+    log_event(&event_);                                   \
+  } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(message) sol_log(message)
+#define LOG_ERROR_EVENT(id, a, b, c, d) LOG_EVENT_(id, a, b, c, d)
+#else
+#define LOG_ERROR(message) LOG_NOTHING_
+#define LOG_ERROR_EVENT(id, a, b, c, d) LOG_NOTHING_
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(message) sol_log(message)
+#define LOG_INFO_EVENT(id, a, b, c, d) LOG_EVENT_(id, a, b, c, d)
+#else
+#define LOG_INFO(message) LOG_NOTHING_
+#define LOG_INFO_EVENT(id, a, b, c, d) LOG_NOTHING_
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(message) sol_log(message)
+#define LOG_DEBUG_EVENT(id, a, b, c, d) LOG_EVENT_(id, a, b, c, d)
+#define LOG_DEBUG_PARAMS(params) sol_log_params(params)
+#else
+#define LOG_DEBUG(message) LOG_NOTHING_
+#define LOG_DEBUG_EVENT(id, a, b, c, d) LOG_NOTHING_
+#define LOG_DEBUG_PARAMS(params) LOG_NOTHING_
+#endif
@@ -2,8 +2,22 @@
  * @brief A program demonstrating logging
  */
 #include <solana_sdk.h>
+#include "event-log.h"
+#include "section-log.h"
+
+/// Identifier of the event logged by this program
+#define EVENT_INSTRUCTION 1
+
+/// Identifiers of the sections profiled in debug builds
+#define SECTION_LOG_ARRAY 1
+#define SECTION_LOG_PARAMS 2
 
 extern uint64_t logging(SolParameters *params) {
+  // The instruction data holds at least the 5 numbers logged below
+  if (params->data_len < 5) {
+    return ERROR_INVALID_INSTRUCTION_DATA;
+  }
+
   // Log a string
   sol_log("static string");
 
@@ -11,14 +25,27 @@ extern uint64_t logging(SolParameters *params) {
   sol_log_64(params->data[0], params->data[1], params->data[2], params->data[3],
              params->data[4]);
 
-  // Log a slice
+  // Log a slice, profiling its cost in debug builds
+  SECTION_BEGIN(SECTION_LOG_ARRAY);
   sol_log_array(params->data, params->data_len);
+  SECTION_END(SECTION_LOG_ARRAY);
 
   // Log a public key
   sol_log_pubkey(params->program_id);
 
-  // Log all the program's input parameters
-  sol_log_params(params);
+  // Log all the program's input parameters.  This is one of the most expensive
+  // things a program can log, so it is only compiled into debug builds.
+  // `sol_deserialize` counts every account passed but parses none for this
+  // program, so none are logged
+  SECTION_BEGIN(SECTION_LOG_PARAMS);
+  LOG_DEBUG_PARAMS((&(SolParameters){.data = params->data,
+                                     .data_len = params->data_len,
+                                     .program_id = params->program_id}));
+  SECTION_END(SECTION_LOG_PARAMS);
+
+  // Log a compact event with a single syscall
+  LOG_INFO_EVENT(EVENT_INSTRUCTION, params->ka_num, params->data_len,
+                 params->data[0], params->data[params->data_len - 1]);
 
   // Log the number of compute units remaining that the program can consume.
   sol_log_compute_units();
@@ -0,0 +1,48 @@
+/**
+ * @brief Compute unit profiling of program sections
+ *
+ * `SECTION_BEGIN` and `SECTION_END` bracket a section of a program with a
+ * marker naming the section and a `sol_log_compute_units` reading of the
+ * remaining budget.  The runtime gives programs no way to read their budget
+ * as a value, so the deltas are taken off-chain: `sections` in the benchmark
+ * crate pairs each marker with its reading and folds a program's logs into a
+ * table of calls and inclusive and self compute units per section.
+ *
+ * Sections nest, a section's self units being what it consumed outside the
+ * sections nested in it, markers of those sections included.  Each section
+ * costs two logs and two readings, so like debug logging they compile to
+ * nothing unless the program is built with `-DLOG_LEVEL=LOG_LEVEL_DEBUG`.
+ */
+#pragma once
+
+#include <solana_sdk.h>
+#include "event-log.h"
+
+/// Marks a logged value as a section marker ("SECT")
+#define LOG_SECTION_TAG_ (uint64_t)0x53454354
+
+#define SECTION_BEGIN_ 0
+#define SECTION_END_ 1
+
+/// Encodes the first logged value of a section marker
+static uint64_t log_section_header(uint32_t id) {
+  return (LOG_SECTION_TAG_ << 32) | id;
+}
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+/// Starts the section identified by the program-defined `id`
+#define SECTION_BEGIN(id)                                        \
+  do {                                                           \
+    sol_log_64(log_section_header(id), SECTION_BEGIN_, 0, 0, 0); \
+    sol_log_compute_units();                                     \
+  } while (0)
+/// Ends the section identified by `id`, which must be the innermost one
+#define SECTION_END(id)                                        \
+  do {                                                         \
+    sol_log_compute_units();                                   \
+    sol_log_64(log_section_header(id), SECTION_END_, 0, 0, 0); \
+  } while (0)
+#else
+#define SECTION_BEGIN(id) LOG_NOTHING_
+#define SECTION_END(id) LOG_NOTHING_
+#endif
@@ -1,20 +1,59 @@
-// #include "logging.c"
-// #include <criterion/criterion.h>
+#include "logging.c"
+#include <criterion/criterion.h>
+#include "../../test/fixtures.h"
 
-// Test(logging, sanity) {
-//   uint8_t instruction_data[] = {10, 11, 12, 13, 14};
-//   SolPubkey program_id = {.x = {
-//                               1,
-//                           }};
-//   SolPubkey key = {.x = {
-//                        2,
-//                    }};
-//   uint64_t lamports = 1;
-//   uint8_t data[] = {0, 0, 0, 0};
-//   SolAccountInfo accounts[] = {};
-//   SolParameters params = {accounts, sizeof(accounts) /
-//   sizeof(SolAccountInfo), instruction_data,
-//                           sizeof(instruction_data), &program_id};
+Test(logging, event_header) {
+  cr_assert(0x45564e5400000001 == log_event_header(EVENT_INSTRUCTION));
+}
 
-//   cr_assert(SUCCESS == logging(&params));
-// }
+Test(logging, log_level) {
+  // Logging below the log level must not even evaluate its arguments
+  uint64_t evaluated = 0;
+  LOG_DEBUG_EVENT(EVENT_INSTRUCTION, evaluated++, 0, 0, 0);
+  cr_assert((LOG_LEVEL >= LOG_LEVEL_DEBUG ? 1 : 0) == evaluated);
+  LOG_INFO_EVENT(EVENT_INSTRUCTION, evaluated++, 0, 0, 0);
+  cr_assert((LOG_LEVEL >= LOG_LEVEL_DEBUG ? 2 : 1) == evaluated);
+}
+
+Test(logging, section_header) {
+  cr_assert(0x5345435400000002 == log_section_header(SECTION_LOG_PARAMS));
+}
+
+Test(logging, sections) {
+  // Sections below the debug level must not even evaluate their identifiers
+  uint64_t evaluated = 0;
+  SECTION_BEGIN(evaluated++);
+  SECTION_END(evaluated++);
+  cr_assert((LOG_LEVEL >= LOG_LEVEL_DEBUG ? 2 : 0) == evaluated);
+}
+
+Test(logging, sanity) {
+  uint64_t no_accounts[] = {0};
+  Fixture fixture;
+  cr_assert(fixture_init(&fixture, 0, no_accounts, 5));
+  uint8_t instruction_data[] = {10, 11, 12, 13, 14};
+  sol_memcpy(fixture.data, instruction_data, sizeof(instruction_data));
+  cr_assert(fixture_serialize_input(&fixture));
+  cr_assert(SUCCESS == entrypoint(fixture.input));
+
+  // Fewer than the 5 numbers logged
+  fixture.data_len = 4;
+  cr_assert(fixture_serialize_input(&fixture));
+  cr_assert(ERROR_INVALID_INSTRUCTION_DATA == entrypoint(fixture.input));
+  fixture_free(&fixture);
+}
+
+Test(logging, fuzz) {
+  // Every call logs its whole input, so few iterations by default
+  FixtureRng rng = {3};
+  uint64_t iterations = fixture_iterations(10);
+  for (uint64_t i = 0; i < iterations; i++) {
+    Fixture fixture;
+    cr_assert(fixture_random(&fixture, &rng, 2, 8));
+    uint64_t result = entrypoint(fixture.input);
+    // Accounts beyond those the program asks for are skipped
+    cr_assert(result == (fixture.data_len < 5 ? ERROR_INVALID_INSTRUCTION_DATA
+                                              : SUCCESS));
+    fixture_free(&fixture);
+  }
+}
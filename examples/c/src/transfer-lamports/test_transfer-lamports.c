@@ -1,8 +1,9 @@
 #include "transfer-lamports.c"
 #include <criterion/criterion.h>
+#include "../../test/fixtures.h"
 
 Test(transfer, sanity) {
-  uint8_t instruction_data[] = {};
+  uint8_t instruction_data[] = {5, 0, 0, 0, 0, 0, 0, 0};
   SolPubkey program_id = {.x = {
                               1,
                           }};
@@ -49,3 +50,161 @@ Test(transfer, sanity) {
   cr_assert(0 == *accounts[0].lamports);
   cr_assert(5 == *accounts[1].lamports);
 }
+
+typedef struct {
+  SolPubkey program_id;
+  SolPubkey keys[2];
+  uint64_t lamports[2];
+  uint64_t amount;
+  SolAccountInfo accounts[2];
+  SolParameters params;
+} Transfer;
+
+void transfer_init(Transfer *t, uint64_t source_lamports,
+                   uint64_t destination_lamports, uint64_t amount) {
+  *t = (Transfer){.program_id = {.x = {1}},
+                  .keys = {{.x = {2}}, {.x = {4}}},
+                  .lamports = {source_lamports, destination_lamports},
+                  .amount = amount};
+  for (int i = 0; i < 2; i++) {
+    t->accounts[i] = (SolAccountInfo){
+        &t->keys[i], &t->lamports[i], 0, NULL, &t->program_id, 0, false, true,
+        false};
+  }
+  t->params = (SolParameters){t->accounts, SOL_ARRAY_SIZE(t->accounts),
+                              (uint8_t *)&t->amount, sizeof(t->amount),
+                              &t->program_id};
+}
+
+Test(transfer, amounts) {
+  Transfer t;
+  transfer_init(&t, 100, 7, 42);
+  cr_assert(SUCCESS == transfer(&t.params));
+  cr_assert(58 == t.lamports[0]);
+  cr_assert(49 == t.lamports[1]);
+
+  transfer_init(&t, 100, 0, 0);
+  cr_assert(SUCCESS == transfer(&t.params));
+  cr_assert(100 == t.lamports[0]);
+
+  transfer_init(&t, UINT64_MAX, 0, UINT64_MAX);
+  cr_assert(SUCCESS == transfer(&t.params));
+  cr_assert(0 == t.lamports[0]);
+  cr_assert(UINT64_MAX == t.lamports[1]);
+}
+
+Test(transfer, insufficient_funds) {
+  Transfer t;
+  transfer_init(&t, 5, 0, 6);
+  cr_assert(ERROR_INSUFFICIENT_FUNDS == transfer(&t.params));
+  cr_assert(5 == t.lamports[0]);
+  cr_assert(0 == t.lamports[1]);
+}
+
+Test(transfer, destination_overflow) {
+  Transfer t;
+  transfer_init(&t, 5, UINT64_MAX - 4, 5);
+  cr_assert(ERROR_INVALID_ARGUMENT == transfer(&t.params));
+  cr_assert(5 == t.lamports[0]);
+  cr_assert(UINT64_MAX - 4 == t.lamports[1]);
+}
+
+Test(transfer, duplicate_accounts) {
+  Transfer t;
+  transfer_init(&t, 5, 0, 5);
+  t.accounts[1] = t.accounts[0];
+  cr_assert(SUCCESS == transfer(&t.params));
+  cr_assert(5 == t.lamports[0]);
+
+  transfer_init(&t, 5, 0, 6);
+  t.accounts[1] = t.accounts[0];
+  cr_assert(ERROR_INSUFFICIENT_FUNDS == transfer(&t.params));
+  cr_assert(5 == t.lamports[0]);
+}
+
+Test(transfer, not_writable) {
+  for (int i = 0; i < 2; i++) {
+    Transfer t;
+    transfer_init(&t, 5, 0, 5);
+    t.accounts[i].is_writable = false;
+    cr_assert(ERROR_INVALID_ARGUMENT == transfer(&t.params));
+    cr_assert(5 == t.lamports[0]);
+    cr_assert(0 == t.lamports[1]);
+  }
+}
+
+Test(transfer, source_not_owned_by_program) {
+  Transfer t;
+  transfer_init(&t, 5, 0, 5);
+  SolPubkey other_program_id = {.x = {1, [31] = 1}};
+  t.accounts[0].owner = &other_program_id;
+  cr_assert(ERROR_INCORRECT_PROGRAM_ID == transfer(&t.params));
+  cr_assert(5 == t.lamports[0]);
+}
+
+Test(transfer, invalid_input) {
+  Transfer t;
+  transfer_init(&t, 5, 0, 5);
+  t.params.data_len = 0;
+  cr_assert(ERROR_INVALID_INSTRUCTION_DATA == transfer(&t.params));
+  t.params.data_len = sizeof(uint64_t) + 1;
+  cr_assert(ERROR_INVALID_INSTRUCTION_DATA == transfer(&t.params));
+
+  transfer_init(&t, 5, 0, 5);
+  t.params.ka_num = 1;
+  cr_assert(ERROR_NOT_ENOUGH_ACCOUNT_KEYS == transfer(&t.params));
+  cr_assert(5 == t.lamports[0]);
+}
+
+Test(transfer, fuzz) {
+  // Whatever the input, lamports only move between the two accounts and
+  // their total is unchanged
+  FixtureRng rng = {2};
+  uint64_t iterations = fixture_iterations(1000);
+  for (uint64_t i = 0; i < iterations; i++) {
+    Fixture fixture;
+    cr_assert(fixture_random(&fixture, &rng, 3, 16));
+    if (fixture.data_len >= sizeof(uint64_t) && fixture_below(&rng, 2) == 0) {
+      // Mostly well-formed transfers, so that they also succeed
+      fixture.data_len = sizeof(uint64_t);
+      *(uint64_t *)fixture.data %= 2000;
+      cr_assert(fixture_serialize_input(&fixture));
+    }
+    SolAccountInfo accounts[3];
+    SolParameters params = {.ka = accounts};
+    cr_assert(sol_deserialize(fixture.input, &params, SOL_ARRAY_SIZE(accounts)));
+    __uint128_t before = 0;
+    uint64_t lamports[3];
+    for (int j = 0; j < params.ka_num; j++) {
+      lamports[j] = *accounts[j].lamports;
+      before += fixture.dup_info[j] == FIXTURE_NOT_DUPLICATE ? lamports[j] : 0;
+    }
+
+    uint64_t result = entrypoint(fixture.input);
+    __uint128_t after = 0;
+    for (int j = 0; j < params.ka_num; j++) {
+      after += fixture.dup_info[j] == FIXTURE_NOT_DUPLICATE
+                   ? *accounts[j].lamports
+                   : 0;
+      if (result != SUCCESS) {
+        cr_assert(lamports[j] == *accounts[j].lamports);
+      }
+    }
+    cr_assert(before == after);
+    fixture_free(&fixture);
+  }
+}
+
+Test(transfer, throughput) {
+  const uint64_t lens[] = {0, 0};
+  Fixture fixture;
+  cr_assert(fixture_init(&fixture, 2, lens, sizeof(uint64_t)));
+  fixture.lamports[0] = UINT64_MAX / 2;
+  *(uint64_t *)fixture.data = 1;
+  cr_assert(fixture_serialize_input(&fixture));
+  cr_assert(SUCCESS == entrypoint(fixture.input));
+  cr_log_info("transfer: %.0f/s",
+              fixture_throughput(entrypoint, fixture.input,
+                                 fixture_iterations(100000)));
+  fixture_free(&fixture);
+}
@@ -3,19 +3,55 @@
  */
 #include <solana_sdk.h>
 
+/// Compares keys a word at a time instead of byte by byte like `SolPubkey_same`
+static bool pubkey_same(const SolPubkey *one, const SolPubkey *two) {
+  const uint64_t *a = (const uint64_t *)one->x;
+  const uint64_t *b = (const uint64_t *)two->x;
+  return 0 == ((a[0] ^ b[0]) | (a[1] ^ b[1]) | (a[2] ^ b[2]) | (a[3] ^ b[3]));
+}
+
 extern uint64_t transfer(SolParameters *params) {
   // As part of the program specification the first account is the source
   // account and the second is the destination account
   if (params->ka_num != 2) {
     return ERROR_NOT_ENOUGH_ACCOUNT_KEYS;
   }
+  // The instruction data is the number of lamports to transfer
+  if (params->data_len != sizeof(uint64_t)) {
+    return ERROR_INVALID_INSTRUCTION_DATA;
+  }
   SolAccountInfo *source_info = &params->ka[0];
   SolAccountInfo *destination_info = &params->ka[1];
+  uint64_t lamports = *(uint64_t *)params->data;
 
-  // Withdraw five lamports from the source
-  *source_info->lamports -= 5;
-  // Deposit five lamports into the destination
-  *destination_info->lamports += 5;
+  if (!source_info->is_writable || !destination_info->is_writable) {
+    return ERROR_INVALID_ARGUMENT;
+  }
+  // Only accounts owned by the program can be debited
+  if (!pubkey_same(source_info->owner, params->program_id)) {
+    return ERROR_INCORRECT_PROGRAM_ID;
+  }
+  // The runtime passes a duplicated account as the same memory, a transfer to
+  // itself must not touch the balance twice
+  if (source_info->lamports == destination_info->lamports) {
+    return *source_info->lamports < lamports ? ERROR_INSUFFICIENT_FUNDS
+                                             : SUCCESS;
+  }
+
+  uint64_t source_lamports;
+  uint64_t destination_lamports;
+  if (__builtin_sub_overflow(*source_info->lamports, lamports,
+                             &source_lamports)) {
+    return ERROR_INSUFFICIENT_FUNDS;
+  }
+  if (__builtin_add_overflow(*destination_info->lamports, lamports,
+                             &destination_lamports)) {
+    return ERROR_INVALID_ARGUMENT;
+  }
+  // Withdraw the lamports from the source
+  *source_info->lamports = source_lamports;
+  // Deposit the lamports into the destination
+  *destination_info->lamports = destination_lamports;
 
   return SUCCESS;
 }
@@ -0,0 +1,277 @@
+/**
+ * @brief Serialized program inputs for the example tests
+ *
+ * Builds entrypoint input buffers laid out the way the runtime serializes
+ * them, either from hand-built accounts, from a count of accounts and their
+ * data sizes, or at random, together with helpers for fuzzing an entrypoint
+ * and measuring its throughput.
+ *
+ * Tests include the program's source first and this file after
+ * `criterion/criterion.h`.  Fuzz and benchmark iterations are taken from the
+ * `FIXTURE_ITERATIONS` environment variable so that a plain `make` stays
+ * quick.
+ */
+#pragma once
+
+#include <stdlib.h>
+#include <time.h>
+
+/// Serialized size of an account that duplicates an earlier one
+#define FIXTURE_DUPLICATE_ACCOUNT_SIZE 8
+/// Marks an account that is not a duplicate in `Fixture.dup_info`
+#define FIXTURE_NOT_DUPLICATE UINT8_MAX
+
+/**
+ * Serializes `accounts` the way the runtime does, with `dup_info[i]` naming
+ * the earlier account `i` duplicates or `FIXTURE_NOT_DUPLICATE`, returning
+ * the length written
+ *
+ * A `NULL` `buffer` only measures the length.
+ */
+static inline uint64_t fixture_serialize(uint8_t *buffer,
+                                         const SolAccountInfo *accounts,
+                                         const uint8_t *dup_info,
+                                         uint64_t ka_num, const uint8_t *data,
+                                         uint64_t data_len,
+                                         const SolPubkey *program_id) {
+  uint64_t len = sizeof(uint64_t);
+  if (buffer != NULL) {
+    *(uint64_t *)buffer = ka_num;
+  }
+  for (uint64_t i = 0; i < ka_num; i++) {
+    if (dup_info[i] != FIXTURE_NOT_DUPLICATE) {
+      if (buffer != NULL) {
+        sol_memset(buffer + len, 0, FIXTURE_DUPLICATE_ACCOUNT_SIZE);
+        buffer[len] = dup_info[i];
+      }
+      len += FIXTURE_DUPLICATE_ACCOUNT_SIZE;
+      continue;
+    }
+    if (buffer != NULL) {
+      uint8_t *input = buffer + len;
+      sol_memset(input, 0, 8);
+      input[0] = dup_info[i];
+      input[1] = accounts[i].is_signer;
+      input[2] = accounts[i].is_writable;
+      input[3] = accounts[i].executable;
+      input += 8;
+      sol_memcpy(input, accounts[i].key, sizeof(SolPubkey));
+      input += sizeof(SolPubkey);
+      sol_memcpy(input, accounts[i].owner, sizeof(SolPubkey));
+      input += sizeof(SolPubkey);
+      *(uint64_t *)input = *accounts[i].lamports;
+      input += sizeof(uint64_t);
+      *(uint64_t *)input = accounts[i].data_len;
+      input += sizeof(uint64_t);
+      sol_memcpy(input, accounts[i].data, accounts[i].data_len);
+      sol_memset(input + accounts[i].data_len, 0,
+                 MAX_PERMITTED_DATA_INCREASE);
+    }
+    len += 8 + 2 * sizeof(SolPubkey) + 2 * sizeof(uint64_t) +
+           accounts[i].data_len + MAX_PERMITTED_DATA_INCREASE;
+    len = (len + 8 - 1) & ~(uint64_t)(8 - 1);
+    if (buffer != NULL) {
+      *(uint64_t *)(buffer + len) = accounts[i].rent_epoch;
+    }
+    len += sizeof(uint64_t);
+  }
+  if (buffer != NULL) {
+    *(uint64_t *)(buffer + len) = data_len;
+    sol_memcpy(buffer + len + sizeof(uint64_t), data, data_len);
+    sol_memcpy(buffer + len + sizeof(uint64_t) + data_len, program_id,
+               sizeof(SolPubkey));
+  }
+  return len + sizeof(uint64_t) + data_len + sizeof(SolPubkey);
+}
+
+/// xorshift64* generator, deterministic for a given seed
+typedef struct FixtureRng {
+  uint64_t state;
+} FixtureRng;
+
+static inline uint64_t fixture_rand(FixtureRng *rng) {
+  rng->state ^= rng->state >> 12;
+  rng->state ^= rng->state << 25;
+  rng->state ^= rng->state >> 27;
+  return rng->state * 0x2545f4914f6cdd1d;
+}
+
+/// Returns a number below `bound`, which must not be zero
+static inline uint64_t fixture_below(FixtureRng *rng, uint64_t bound) {
+  return fixture_rand(rng) % bound;
+}
+
+/// Accounts, instruction data and their serialized input, all owned
+typedef struct Fixture {
+  SolPubkey program_id;
+  SolAccountInfo *accounts;
+  uint8_t *dup_info;
+  uint64_t ka_num;
+  /// Storage the accounts point into
+  SolPubkey *keys;
+  SolPubkey *owners;
+  uint64_t *lamports;
+  uint8_t *account_data;
+  uint8_t *data;
+  uint64_t data_len;
+  /// Serialized input, aligned as the runtime aligns it
+  uint8_t *input;
+  uint64_t input_len;
+} Fixture;
+
+static inline void fixture_free(Fixture *fixture) {
+  free(fixture->accounts);
+  free(fixture->dup_info);
+  free(fixture->keys);
+  free(fixture->owners);
+  free(fixture->lamports);
+  free(fixture->account_data);
+  free(fixture->data);
+  free(fixture->input);
+  sol_memset(fixture, 0, sizeof(*fixture));
+}
+
+/**
+ * Allocates `ka_num` distinct accounts with the data lengths in `data_lens`
+ * and `data_len` bytes of instruction data, all zeroed
+ *
+ * Every account is writable and owned by the program, and holds one lamport.
+ * Call `fixture_serialize_input` once the accounts are filled in.
+ */
+static inline bool fixture_init(Fixture *fixture, uint64_t ka_num,
+                                const uint64_t *data_lens, uint64_t data_len) {
+  sol_memset(fixture, 0, sizeof(*fixture));
+  fixture->program_id.x[0] = 1;
+  fixture->ka_num = ka_num;
+  uint64_t total = 0;
+  for (uint64_t i = 0; i < ka_num; i++) {
+    total += data_lens[i];
+  }
+  // One byte more so that empty allocations are never `NULL`
+  fixture->accounts = calloc(ka_num + 1, sizeof(*fixture->accounts));
+  fixture->dup_info = calloc(ka_num + 1, sizeof(*fixture->dup_info));
+  fixture->keys = calloc(ka_num + 1, sizeof(*fixture->keys));
+  fixture->owners = calloc(ka_num + 1, sizeof(*fixture->owners));
+  fixture->lamports = calloc(ka_num + 1, sizeof(*fixture->lamports));
+  fixture->account_data = calloc(total + 1, 1);
+  fixture->data = calloc(data_len + 1, 1);
+  fixture->data_len = data_len;
+  if (fixture->accounts == NULL || fixture->dup_info == NULL ||
+      fixture->keys == NULL || fixture->owners == NULL ||
+      fixture->lamports == NULL || fixture->account_data == NULL ||
+      fixture->data == NULL) {
+    fixture_free(fixture);
+    return false;
+  }
+  uint8_t *account_data = fixture->account_data;
+  for (uint64_t i = 0; i < ka_num; i++) {
+    *(uint64_t *)fixture->keys[i].x = i + 2;
+    fixture->owners[i] = fixture->program_id;
+    fixture->lamports[i] = 1;
+    fixture->dup_info[i] = FIXTURE_NOT_DUPLICATE;
+    fixture->accounts[i] = (SolAccountInfo){
+        &fixture->keys[i], &fixture->lamports[i], data_lens[i], account_data,
+        &fixture->owners[i], 0, false, true, false};
+    account_data += data_lens[i];
+  }
+  return true;
+}
+
+/// Serializes the fixture's accounts and instruction data into its input
+static inline bool fixture_serialize_input(Fixture *fixture) {
+  uint64_t len =
+      fixture_serialize(NULL, fixture->accounts, fixture->dup_info,
+                        fixture->ka_num, fixture->data, fixture->data_len,
+                        &fixture->program_id);
+  free(fixture->input);
+  fixture->input = aligned_alloc(16, (len + 15) & ~(uint64_t)15);
+  if (fixture->input == NULL) {
+    return false;
+  }
+  sol_memset(fixture->input, 0, len);
+  fixture->input_len =
+      fixture_serialize(fixture->input, fixture->accounts, fixture->dup_info,
+                        fixture->ka_num, fixture->data, fixture->data_len,
+                        &fixture->program_id);
+  return true;
+}
+
+/**
+ * Builds a random but well-formed input of at most `max_accounts` accounts
+ * of at most `max_data_len` bytes each and at most `max_data_len` bytes of
+ * instruction data
+ *
+ * Any account may duplicate an earlier one, be a signer, not be writable or
+ * be owned by another program, and lamports and data are random.
+ */
+static inline bool fixture_random(Fixture *fixture, FixtureRng *rng,
+                                  uint64_t max_accounts,
+                                  uint64_t max_data_len) {
+  uint64_t ka_num = fixture_below(rng, max_accounts + 1);
+  uint64_t data_lens[UINT8_MAX];
+  ka_num = ka_num < UINT8_MAX ? ka_num : UINT8_MAX - 1;
+  for (uint64_t i = 0; i < ka_num; i++) {
+    data_lens[i] = fixture_below(rng, max_data_len + 1);
+  }
+  if (!fixture_init(fixture, ka_num, data_lens,
+                    fixture_below(rng, max_data_len + 1))) {
+    return false;
+  }
+  for (uint64_t i = 0; i < ka_num; i++) {
+    SolAccountInfo *account = &fixture->accounts[i];
+    if (i > 0 && fixture_below(rng, 4) == 0) {
+      // The runtime names the first occurrence of a duplicated account
+      uint8_t original = (uint8_t)fixture_below(rng, i);
+      while (fixture->dup_info[original] != FIXTURE_NOT_DUPLICATE) {
+        original = fixture->dup_info[original];
+      }
+      fixture->dup_info[i] = original;
+      *account = fixture->accounts[original];
+      continue;
+    }
+    *(uint64_t *)fixture->keys[i].x = fixture_rand(rng);
+    if (fixture_below(rng, 4) == 0) {
+      *(uint64_t *)fixture->owners[i].x = fixture_rand(rng);
+    }
+    fixture->lamports[i] = fixture_below(rng, 2) == 0
+                               ? fixture_below(rng, 1000)
+                               : fixture_rand(rng);
+    account->is_signer = fixture_below(rng, 2);
+    account->is_writable = fixture_below(rng, 4) != 0;
+    account->executable = fixture_below(rng, 8) == 0;
+    account->rent_epoch = fixture_rand(rng);
+    for (uint64_t j = 0; j < account->data_len; j++) {
+      account->data[j] = (uint8_t)fixture_rand(rng);
+    }
+  }
+  for (uint64_t j = 0; j < fixture->data_len; j++) {
+    fixture->data[j] = (uint8_t)fixture_rand(rng);
+  }
+  return fixture_serialize_input(fixture);
+}
+
+/// Iterations of fuzz and throughput tests, `FIXTURE_ITERATIONS` if set
+static inline uint64_t fixture_iterations(uint64_t default_iterations) {
+  const char *iterations = getenv("FIXTURE_ITERATIONS");
+  return iterations == NULL ? default_iterations
+                            : strtoull(iterations, NULL, 10);
+}
+
+/// Calls `entrypoint` on `input` `iterations` times, returning the calls
+/// per second
+static inline double fixture_throughput(uint64_t (*entrypoint)(const uint8_t *),
+                                        const uint8_t *input,
+                                        uint64_t iterations) {
+  struct timespec start;
+  struct timespec end;
+  timespec_get(&start, TIME_UTC);
+  for (uint64_t i = 0; i < iterations; i++) {
+    entrypoint(input);
+    // Keep the compiler from hoisting the call out of the loop
+    __asm__ volatile("" ::: "memory");
+  }
+  timespec_get(&end, TIME_UTC);
+  double seconds =
+      (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+  return seconds > 0 ? iterations / seconds : 0;
+}
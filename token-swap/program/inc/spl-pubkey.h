@@ -0,0 +1,79 @@
+/* SPL C Bindings pubkey helpers, copied into each program's inc/ by cgen */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Length of a pubkey, `Token_Pubkey` is `uint8_t[SPL_PUBKEY_LEN]` and
+ * `SolPubkey` has the same layout
+ */
+#define SPL_PUBKEY_LEN 32
+
+/**
+ * A pubkey as four native-endian words
+ */
+typedef struct SplPubkey_Words {
+    uint64_t x[4];
+} SplPubkey_Words;
+
+/**
+ * Loads `key` a word at a time, `key` need not be aligned
+ */
+static inline SplPubkey_Words SplPubkey_load(const uint8_t *key) {
+    SplPubkey_Words words;
+    __builtin_memcpy(&words, key, sizeof(words));
+    return words;
+}
+
+/**
+ * Returns whether the pubkeys are the same, comparing four words instead of
+ * 32 bytes
+ */
+static inline bool SplPubkey_eq(const uint8_t *one, const uint8_t *two) {
+    SplPubkey_Words a = SplPubkey_load(one);
+    SplPubkey_Words b = SplPubkey_load(two);
+    return ((a.x[0] ^ b.x[0]) | (a.x[1] ^ b.x[1]) | (a.x[2] ^ b.x[2]) |
+            (a.x[3] ^ b.x[3])) == 0;
+}
+
+/**
+ * Returns whether every byte of `key` is zero, e.g. an unset authority
+ */
+static inline bool SplPubkey_is_zero(const uint8_t *key) {
+    SplPubkey_Words a = SplPubkey_load(key);
+    return (a.x[0] | a.x[1] | a.x[2] | a.x[3]) == 0;
+}
+
+/**
+ * Hashes `key` to 64 bits for use in hash tables.  Pubkeys are already
+ * uniformly distributed, so folding the words and mixing once is enough.  Not
+ * suitable where keys are chosen by an adversary to collide.
+ */
+static inline uint64_t SplPubkey_hash(const uint8_t *key) {
+    SplPubkey_Words a = SplPubkey_load(key);
+    uint64_t h = (a.x[0] ^ a.x[1] ^ a.x[2] ^ a.x[3]) * 0x9e3779b97f4a7c15;
+    return h ^ (h >> 32);
+}
+
+/**
+ * Returns the index of the first of `keys_len` contiguous pubkeys equal to
+ * `key`, or `keys_len` if there is none
+ */
+static inline size_t SplPubkey_find(
+    const uint8_t *key,
+    const uint8_t *keys,
+    size_t keys_len
+) {
+    SplPubkey_Words a = SplPubkey_load(key);
+    for (size_t i = 0; i < keys_len; i++) {
+        SplPubkey_Words b = SplPubkey_load(keys + i * SPL_PUBKEY_LEN);
+        if (((a.x[0] ^ b.x[0]) | (a.x[1] ^ b.x[1]) | (a.x[2] ^ b.x[2]) |
+             (a.x[3] ^ b.x[3])) == 0) {
+            return i;
+        }
+    }
+    return keys_len;
+}
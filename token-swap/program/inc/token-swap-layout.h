@@ -0,0 +1,716 @@
+/* Autogenerated SPL Token-Swap program packed account layout */
+
+#pragma once
+
+#include "token-swap.h"
+#include "spl-pubkey.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "packed account data is little-endian"
+#endif
+
+static inline uint32_t TokenSwap_read_u32(const uint8_t *src) {
+    uint32_t value;
+    __builtin_memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+static inline uint64_t TokenSwap_read_u64(const uint8_t *src) {
+    uint64_t value;
+    __builtin_memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+static inline void TokenSwap_write_u32(uint8_t *dst, uint32_t value) {
+    __builtin_memcpy(dst, &value, sizeof(value));
+}
+
+static inline void TokenSwap_write_u64(uint8_t *dst, uint64_t value) {
+    __builtin_memcpy(dst, &value, sizeof(value));
+}
+
+
+#ifdef __cplusplus
+#define TokenSwap_STATIC_ASSERT static_assert
+#else
+#define TokenSwap_STATIC_ASSERT _Static_assert
+#endif
+
+/**
+ * Packed length of `TokenSwap_SwapInfo` account data
+ */
+#define TokenSwap_SwapInfo_LEN 324
+
+/**
+ * Swap state version, only version 1 is supported
+ */
+#define TokenSwap_SwapInfo_version_OFFSET 0
+
+static inline uint8_t TokenSwap_SwapInfo_get_version(const uint8_t *data) {
+    return data[TokenSwap_SwapInfo_version_OFFSET];
+}
+
+static inline void TokenSwap_SwapInfo_set_version(uint8_t *data, uint8_t value) {
+    data[TokenSwap_SwapInfo_version_OFFSET] = value;
+}
+
+/**
+ * Initialized state.
+ */
+#define TokenSwap_SwapInfo_is_initialized_OFFSET 1
+
+static inline bool TokenSwap_SwapInfo_get_is_initialized(const uint8_t *data) {
+    return data[TokenSwap_SwapInfo_is_initialized_OFFSET] == 1;
+}
+
+static inline void TokenSwap_SwapInfo_set_is_initialized(uint8_t *data, bool value) {
+    data[TokenSwap_SwapInfo_is_initialized_OFFSET] = value ? 1 : 0;
+}
+
+/**
+ * Nonce used in program address.
+ */
+#define TokenSwap_SwapInfo_nonce_OFFSET 2
+
+static inline uint8_t TokenSwap_SwapInfo_get_nonce(const uint8_t *data) {
+    return data[TokenSwap_SwapInfo_nonce_OFFSET];
+}
+
+static inline void TokenSwap_SwapInfo_set_nonce(uint8_t *data, uint8_t value) {
+    data[TokenSwap_SwapInfo_nonce_OFFSET] = value;
+}
+
+/**
+ * Program ID of the tokens being exchanged.
+ */
+#define TokenSwap_SwapInfo_token_program_id_OFFSET 3
+
+static inline const uint8_t *TokenSwap_SwapInfo_get_token_program_id(const uint8_t *data) {
+    return data + TokenSwap_SwapInfo_token_program_id_OFFSET;
+}
+
+static inline void TokenSwap_SwapInfo_set_token_program_id(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + TokenSwap_SwapInfo_token_program_id_OFFSET, value, 32);
+}
+
+static inline bool TokenSwap_SwapInfo_token_program_id_is(const uint8_t *data, const uint8_t *key) {
+    return SplPubkey_eq(data + TokenSwap_SwapInfo_token_program_id_OFFSET, key);
+}
+
+/**
+ * Token A liquidity account
+ */
+#define TokenSwap_SwapInfo_token_a_OFFSET 35
+
+static inline const uint8_t *TokenSwap_SwapInfo_get_token_a(const uint8_t *data) {
+    return data + TokenSwap_SwapInfo_token_a_OFFSET;
+}
+
+static inline void TokenSwap_SwapInfo_set_token_a(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + TokenSwap_SwapInfo_token_a_OFFSET, value, 32);
+}
+
+static inline bool TokenSwap_SwapInfo_token_a_is(const uint8_t *data, const uint8_t *key) {
+    return SplPubkey_eq(data + TokenSwap_SwapInfo_token_a_OFFSET, key);
+}
+
+/**
+ * Token B liquidity account
+ */
+#define TokenSwap_SwapInfo_token_b_OFFSET 67
+
+static inline const uint8_t *TokenSwap_SwapInfo_get_token_b(const uint8_t *data) {
+    return data + TokenSwap_SwapInfo_token_b_OFFSET;
+}
+
+static inline void TokenSwap_SwapInfo_set_token_b(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + TokenSwap_SwapInfo_token_b_OFFSET, value, 32);
+}
+
+static inline bool TokenSwap_SwapInfo_token_b_is(const uint8_t *data, const uint8_t *key) {
+    return SplPubkey_eq(data + TokenSwap_SwapInfo_token_b_OFFSET, key);
+}
+
+/**
+ * Pool tokens are issued when A or B tokens are deposited.
+ */
+#define TokenSwap_SwapInfo_pool_mint_OFFSET 99
+
+static inline const uint8_t *TokenSwap_SwapInfo_get_pool_mint(const uint8_t *data) {
+    return data + TokenSwap_SwapInfo_pool_mint_OFFSET;
+}
+
+static inline void TokenSwap_SwapInfo_set_pool_mint(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + TokenSwap_SwapInfo_pool_mint_OFFSET, value, 32);
+}
+
+static inline bool TokenSwap_SwapInfo_pool_mint_is(const uint8_t *data, const uint8_t *key) {
+    return SplPubkey_eq(data + TokenSwap_SwapInfo_pool_mint_OFFSET, key);
+}
+
+/**
+ * Mint information for token A
+ */
+#define TokenSwap_SwapInfo_token_a_mint_OFFSET 131
+
+static inline const uint8_t *TokenSwap_SwapInfo_get_token_a_mint(const uint8_t *data) {
+    return data + TokenSwap_SwapInfo_token_a_mint_OFFSET;
+}
+
+static inline void TokenSwap_SwapInfo_set_token_a_mint(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + TokenSwap_SwapInfo_token_a_mint_OFFSET, value, 32);
+}
+
+static inline bool TokenSwap_SwapInfo_token_a_mint_is(const uint8_t *data, const uint8_t *key) {
+    return SplPubkey_eq(data + TokenSwap_SwapInfo_token_a_mint_OFFSET, key);
+}
+
+/**
+ * Mint information for token B
+ */
+#define TokenSwap_SwapInfo_token_b_mint_OFFSET 163
+
+static inline const uint8_t *TokenSwap_SwapInfo_get_token_b_mint(const uint8_t *data) {
+    return data + TokenSwap_SwapInfo_token_b_mint_OFFSET;
+}
+
+static inline void TokenSwap_SwapInfo_set_token_b_mint(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + TokenSwap_SwapInfo_token_b_mint_OFFSET, value, 32);
+}
+
+static inline bool TokenSwap_SwapInfo_token_b_mint_is(const uint8_t *data, const uint8_t *key) {
+    return SplPubkey_eq(data + TokenSwap_SwapInfo_token_b_mint_OFFSET, key);
+}
+
+/**
+ * Pool token account to receive trading and / or withdrawal fees
+ */
+#define TokenSwap_SwapInfo_pool_fee_account_OFFSET 195
+
+static inline const uint8_t *TokenSwap_SwapInfo_get_pool_fee_account(const uint8_t *data) {
+    return data + TokenSwap_SwapInfo_pool_fee_account_OFFSET;
+}
+
+static inline void TokenSwap_SwapInfo_set_pool_fee_account(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + TokenSwap_SwapInfo_pool_fee_account_OFFSET, value, 32);
+}
+
+static inline bool TokenSwap_SwapInfo_pool_fee_account_is(const uint8_t *data, const uint8_t *key) {
+    return SplPubkey_eq(data + TokenSwap_SwapInfo_pool_fee_account_OFFSET, key);
+}
+
+/**
+ * Trade fee numerator
+ */
+#define TokenSwap_SwapInfo_trade_fee_numerator_OFFSET 227
+
+static inline uint64_t TokenSwap_SwapInfo_get_trade_fee_numerator(const uint8_t *data) {
+    return TokenSwap_read_u64(data + TokenSwap_SwapInfo_trade_fee_numerator_OFFSET);
+}
+
+static inline void TokenSwap_SwapInfo_set_trade_fee_numerator(uint8_t *data, uint64_t value) {
+    TokenSwap_write_u64(data + TokenSwap_SwapInfo_trade_fee_numerator_OFFSET, value);
+}
+
+/**
+ * Trade fee denominator
+ */
+#define TokenSwap_SwapInfo_trade_fee_denominator_OFFSET 235
+
+static inline uint64_t TokenSwap_SwapInfo_get_trade_fee_denominator(const uint8_t *data) {
+    return TokenSwap_read_u64(data + TokenSwap_SwapInfo_trade_fee_denominator_OFFSET);
+}
+
+static inline void TokenSwap_SwapInfo_set_trade_fee_denominator(uint8_t *data, uint64_t value) {
+    TokenSwap_write_u64(data + TokenSwap_SwapInfo_trade_fee_denominator_OFFSET, value);
+}
+
+/**
+ * Owner trade fee numerator
+ */
+#define TokenSwap_SwapInfo_owner_trade_fee_numerator_OFFSET 243
+
+static inline uint64_t TokenSwap_SwapInfo_get_owner_trade_fee_numerator(const uint8_t *data) {
+    return TokenSwap_read_u64(data + TokenSwap_SwapInfo_owner_trade_fee_numerator_OFFSET);
+}
+
+static inline void TokenSwap_SwapInfo_set_owner_trade_fee_numerator(uint8_t *data, uint64_t value) {
+    TokenSwap_write_u64(data + TokenSwap_SwapInfo_owner_trade_fee_numerator_OFFSET, value);
+}
+
+/**
+ * Owner trade fee denominator
+ */
+#define TokenSwap_SwapInfo_owner_trade_fee_denominator_OFFSET 251
+
+static inline uint64_t TokenSwap_SwapInfo_get_owner_trade_fee_denominator(const uint8_t *data) {
+    return TokenSwap_read_u64(data + TokenSwap_SwapInfo_owner_trade_fee_denominator_OFFSET);
+}
+
+static inline void TokenSwap_SwapInfo_set_owner_trade_fee_denominator(uint8_t *data, uint64_t value) {
+    TokenSwap_write_u64(data + TokenSwap_SwapInfo_owner_trade_fee_denominator_OFFSET, value);
+}
+
+/**
+ * Owner withdraw fee numerator
+ */
+#define TokenSwap_SwapInfo_owner_withdraw_fee_numerator_OFFSET 259
+
+static inline uint64_t TokenSwap_SwapInfo_get_owner_withdraw_fee_numerator(const uint8_t *data) {
+    return TokenSwap_read_u64(data + TokenSwap_SwapInfo_owner_withdraw_fee_numerator_OFFSET);
+}
+
+static inline void TokenSwap_SwapInfo_set_owner_withdraw_fee_numerator(uint8_t *data, uint64_t value) {
+    TokenSwap_write_u64(data + TokenSwap_SwapInfo_owner_withdraw_fee_numerator_OFFSET, value);
+}
+
+/**
+ * Owner withdraw fee denominator
+ */
+#define TokenSwap_SwapInfo_owner_withdraw_fee_denominator_OFFSET 267
+
+static inline uint64_t TokenSwap_SwapInfo_get_owner_withdraw_fee_denominator(const uint8_t *data) {
+    return TokenSwap_read_u64(data + TokenSwap_SwapInfo_owner_withdraw_fee_denominator_OFFSET);
+}
+
+static inline void TokenSwap_SwapInfo_set_owner_withdraw_fee_denominator(uint8_t *data, uint64_t value) {
+    TokenSwap_write_u64(data + TokenSwap_SwapInfo_owner_withdraw_fee_denominator_OFFSET, value);
+}
+
+/**
+ * Host trading fee numerator
+ */
+#define TokenSwap_SwapInfo_host_fee_numerator_OFFSET 275
+
+static inline uint64_t TokenSwap_SwapInfo_get_host_fee_numerator(const uint8_t *data) {
+    return TokenSwap_read_u64(data + TokenSwap_SwapInfo_host_fee_numerator_OFFSET);
+}
+
+static inline void TokenSwap_SwapInfo_set_host_fee_numerator(uint8_t *data, uint64_t value) {
+    TokenSwap_write_u64(data + TokenSwap_SwapInfo_host_fee_numerator_OFFSET, value);
+}
+
+/**
+ * Host trading fee denominator
+ */
+#define TokenSwap_SwapInfo_host_fee_denominator_OFFSET 283
+
+static inline uint64_t TokenSwap_SwapInfo_get_host_fee_denominator(const uint8_t *data) {
+    return TokenSwap_read_u64(data + TokenSwap_SwapInfo_host_fee_denominator_OFFSET);
+}
+
+static inline void TokenSwap_SwapInfo_set_host_fee_denominator(uint8_t *data, uint64_t value) {
+    TokenSwap_write_u64(data + TokenSwap_SwapInfo_host_fee_denominator_OFFSET, value);
+}
+
+/**
+ * The type of curve contained in the calculator
+ */
+#define TokenSwap_SwapInfo_curve_type_OFFSET 291
+
+static inline TokenSwap_CurveType TokenSwap_SwapInfo_get_curve_type(const uint8_t *data) {
+    return (TokenSwap_CurveType)data[TokenSwap_SwapInfo_curve_type_OFFSET];
+}
+
+static inline void TokenSwap_SwapInfo_set_curve_type(uint8_t *data, TokenSwap_CurveType value) {
+    data[TokenSwap_SwapInfo_curve_type_OFFSET] = (uint8_t)value;
+}
+
+/**
+ * `token_b_price` of a constant price curve, `amp` of a stable curve, `token_b_offset` of an offset curve, unused by a constant product curve
+ */
+#define TokenSwap_SwapInfo_curve_parameter_OFFSET 292
+
+static inline uint64_t TokenSwap_SwapInfo_get_curve_parameter(const uint8_t *data) {
+    return TokenSwap_read_u64(data + TokenSwap_SwapInfo_curve_parameter_OFFSET);
+}
+
+static inline void TokenSwap_SwapInfo_set_curve_parameter(uint8_t *data, uint64_t value) {
+    TokenSwap_write_u64(data + TokenSwap_SwapInfo_curve_parameter_OFFSET, value);
+}
+
+/**
+ * Calculator bytes no curve uses yet
+ */
+#define TokenSwap_SwapInfo_curve_padding_OFFSET 300
+
+static inline const uint8_t *TokenSwap_SwapInfo_get_curve_padding(const uint8_t *data) {
+    return data + TokenSwap_SwapInfo_curve_padding_OFFSET;
+}
+
+static inline void TokenSwap_SwapInfo_set_curve_padding(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + TokenSwap_SwapInfo_curve_padding_OFFSET, value, 24);
+}
+
+/**
+ * Checks the length and every tag of packed `TokenSwap_SwapInfo` data, accepting exactly
+ * what the program's `unpack_unchecked` accepts
+ */
+static inline bool TokenSwap_SwapInfo_is_valid(const uint8_t *data, uint64_t data_len) {
+    return data_len == TokenSwap_SwapInfo_LEN &&
+           (data[TokenSwap_SwapInfo_version_OFFSET] == 1) &&
+           (data[TokenSwap_SwapInfo_is_initialized_OFFSET] <= 1) &&
+           (data[TokenSwap_SwapInfo_curve_type_OFFSET] <= TokenSwap_CurveType_Offset);
+}
+
+/**
+ * Checks packed `TokenSwap_SwapInfo` data like `TokenSwap_SwapInfo_is_valid` and that it is initialized,
+ * accepting exactly what the program's `unpack` accepts
+ */
+static inline bool TokenSwap_SwapInfo_is_initialized(const uint8_t *data, uint64_t data_len) {
+    return TokenSwap_SwapInfo_is_valid(data, data_len) && data[TokenSwap_SwapInfo_is_initialized_OFFSET] != 0;
+}
+
+/*
+ * `TokenSwap_SwapInfo` fields must be contiguous, and sized like the cbindgen struct members
+ * they are read into
+ */
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_version_OFFSET == 0, "TokenSwap_SwapInfo.version is not the first packed field");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_version_OFFSET + 1 == TokenSwap_SwapInfo_is_initialized_OFFSET, "TokenSwap_SwapInfo.version does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_is_initialized_OFFSET + 1 == TokenSwap_SwapInfo_nonce_OFFSET, "TokenSwap_SwapInfo.is_initialized does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_nonce_OFFSET + 1 == TokenSwap_SwapInfo_token_program_id_OFFSET, "TokenSwap_SwapInfo.nonce does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_token_program_id_OFFSET + 32 == TokenSwap_SwapInfo_token_a_OFFSET, "TokenSwap_SwapInfo.token_program_id does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_token_a_OFFSET + 32 == TokenSwap_SwapInfo_token_b_OFFSET, "TokenSwap_SwapInfo.token_a does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_token_b_OFFSET + 32 == TokenSwap_SwapInfo_pool_mint_OFFSET, "TokenSwap_SwapInfo.token_b does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_pool_mint_OFFSET + 32 == TokenSwap_SwapInfo_token_a_mint_OFFSET, "TokenSwap_SwapInfo.pool_mint does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_token_a_mint_OFFSET + 32 == TokenSwap_SwapInfo_token_b_mint_OFFSET, "TokenSwap_SwapInfo.token_a_mint does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_token_b_mint_OFFSET + 32 == TokenSwap_SwapInfo_pool_fee_account_OFFSET, "TokenSwap_SwapInfo.token_b_mint does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_pool_fee_account_OFFSET + 32 == TokenSwap_SwapInfo_trade_fee_numerator_OFFSET, "TokenSwap_SwapInfo.pool_fee_account does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_trade_fee_numerator_OFFSET + 8 == TokenSwap_SwapInfo_trade_fee_denominator_OFFSET, "TokenSwap_SwapInfo.trade_fee_numerator does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_trade_fee_denominator_OFFSET + 8 == TokenSwap_SwapInfo_owner_trade_fee_numerator_OFFSET, "TokenSwap_SwapInfo.trade_fee_denominator does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_owner_trade_fee_numerator_OFFSET + 8 == TokenSwap_SwapInfo_owner_trade_fee_denominator_OFFSET, "TokenSwap_SwapInfo.owner_trade_fee_numerator does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_owner_trade_fee_denominator_OFFSET + 8 == TokenSwap_SwapInfo_owner_withdraw_fee_numerator_OFFSET, "TokenSwap_SwapInfo.owner_trade_fee_denominator does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_owner_withdraw_fee_numerator_OFFSET + 8 == TokenSwap_SwapInfo_owner_withdraw_fee_denominator_OFFSET, "TokenSwap_SwapInfo.owner_withdraw_fee_numerator does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_owner_withdraw_fee_denominator_OFFSET + 8 == TokenSwap_SwapInfo_host_fee_numerator_OFFSET, "TokenSwap_SwapInfo.owner_withdraw_fee_denominator does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_host_fee_numerator_OFFSET + 8 == TokenSwap_SwapInfo_host_fee_denominator_OFFSET, "TokenSwap_SwapInfo.host_fee_numerator does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_host_fee_denominator_OFFSET + 8 == TokenSwap_SwapInfo_curve_type_OFFSET, "TokenSwap_SwapInfo.host_fee_denominator does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_curve_type_OFFSET + 1 == TokenSwap_SwapInfo_curve_parameter_OFFSET, "TokenSwap_SwapInfo.curve_type does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_curve_parameter_OFFSET + 8 == TokenSwap_SwapInfo_curve_padding_OFFSET, "TokenSwap_SwapInfo.curve_parameter does not end where the next packed field starts");
+TokenSwap_STATIC_ASSERT(TokenSwap_SwapInfo_curve_padding_OFFSET + 24 == TokenSwap_SwapInfo_LEN, "TokenSwap_SwapInfo.curve_padding does not end where the next packed field starts");
+
+/**
+ * Packed length of `Token_Mint` account data
+ */
+#define TokenSwap_Token_Mint_LEN 82
+
+/**
+ * Optional authority used to mint new tokens.
+ */
+#define TokenSwap_Token_Mint_mint_authority_OFFSET 0
+
+/**
+ * Total supply of tokens.
+ */
+#define TokenSwap_Token_Mint_supply_OFFSET 36
+
+/**
+ * Number of base 10 digits to the right of the decimal place.
+ */
+#define TokenSwap_Token_Mint_decimals_OFFSET 44
+
+/**
+ * Is `true` if this structure has been initialized
+ */
+#define TokenSwap_Token_Mint_is_initialized_OFFSET 45
+
+/**
+ * Optional authority to freeze token accounts.
+ */
+#define TokenSwap_Token_Mint_freeze_authority_OFFSET 46
+
+/**
+ * Packed length of `Token_Account` account data
+ */
+#define TokenSwap_Token_Account_LEN 165
+
+/**
+ * The mint associated with this account
+ */
+#define TokenSwap_Token_Account_mint_OFFSET 0
+
+/**
+ * The owner of this account.
+ */
+#define TokenSwap_Token_Account_owner_OFFSET 32
+
+/**
+ * The amount of tokens this account holds.
+ */
+#define TokenSwap_Token_Account_amount_OFFSET 64
+
+/**
+ * If `delegate` is `Some` then `delegated_amount` is the amount authorized
+ */
+#define TokenSwap_Token_Account_delegate_OFFSET 72
+
+/**
+ * The account's state
+ */
+#define TokenSwap_Token_Account_state_OFFSET 108
+
+/**
+ * If is_some, this is a native token, and the value logs the rent-exempt reserve.
+ */
+#define TokenSwap_Token_Account_is_native_OFFSET 109
+
+/**
+ * The amount delegated
+ */
+#define TokenSwap_Token_Account_delegated_amount_OFFSET 121
+
+/**
+ * Optional authority to close the account.
+ */
+#define TokenSwap_Token_Account_close_authority_OFFSET 129
+
+#ifdef __cplusplus
+namespace TokenSwap {
+
+/**
+ * Reads a field through its C accessor, e.g.
+ * `TokenSwap::get<TokenSwap::SwapInfo::is_initialized>(data)`, which the compiler inlines to the load itself
+ */
+template <typename Field, typename... Args>
+inline auto get(const uint8_t *data, Args... args) -> decltype(Field::get(data, args...)) {
+    return Field::get(data, args...);
+}
+
+template <typename Field, typename... Args>
+inline void set(uint8_t *data, Args... args) {
+    Field::set(data, args...);
+}
+
+/**
+ * Compares a public key field, `false` if an optional one is `None`
+ */
+template <typename Field>
+inline bool is(const uint8_t *data, const uint8_t *key) {
+    return Field::is(data, key);
+}
+
+/**
+ * Packed `TokenSwap_SwapInfo` fields
+ */
+struct SwapInfo {
+    static constexpr size_t LEN = TokenSwap_SwapInfo_LEN;
+
+    /**
+     * Swap state version, only version 1 is supported
+     */
+    struct version {
+        static constexpr size_t offset = TokenSwap_SwapInfo_version_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = TokenSwap_SwapInfo_get_version;
+        static constexpr auto set = TokenSwap_SwapInfo_set_version;
+    };
+
+    /**
+     * Initialized state.
+     */
+    struct is_initialized {
+        static constexpr size_t offset = TokenSwap_SwapInfo_is_initialized_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = TokenSwap_SwapInfo_get_is_initialized;
+        static constexpr auto set = TokenSwap_SwapInfo_set_is_initialized;
+    };
+
+    /**
+     * Nonce used in program address.
+     */
+    struct nonce {
+        static constexpr size_t offset = TokenSwap_SwapInfo_nonce_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = TokenSwap_SwapInfo_get_nonce;
+        static constexpr auto set = TokenSwap_SwapInfo_set_nonce;
+    };
+
+    /**
+     * Program ID of the tokens being exchanged.
+     */
+    struct token_program_id {
+        static constexpr size_t offset = TokenSwap_SwapInfo_token_program_id_OFFSET;
+        static constexpr size_t size = 32;
+        static constexpr auto get = TokenSwap_SwapInfo_get_token_program_id;
+        static constexpr auto set = TokenSwap_SwapInfo_set_token_program_id;
+        static constexpr auto is = TokenSwap_SwapInfo_token_program_id_is;
+    };
+
+    /**
+     * Token A liquidity account
+     */
+    struct token_a {
+        static constexpr size_t offset = TokenSwap_SwapInfo_token_a_OFFSET;
+        static constexpr size_t size = 32;
+        static constexpr auto get = TokenSwap_SwapInfo_get_token_a;
+        static constexpr auto set = TokenSwap_SwapInfo_set_token_a;
+        static constexpr auto is = TokenSwap_SwapInfo_token_a_is;
+    };
+
+    /**
+     * Token B liquidity account
+     */
+    struct token_b {
+        static constexpr size_t offset = TokenSwap_SwapInfo_token_b_OFFSET;
+        static constexpr size_t size = 32;
+        static constexpr auto get = TokenSwap_SwapInfo_get_token_b;
+        static constexpr auto set = TokenSwap_SwapInfo_set_token_b;
+        static constexpr auto is = TokenSwap_SwapInfo_token_b_is;
+    };
+
+    /**
+     * Pool tokens are issued when A or B tokens are deposited.
+     */
+    struct pool_mint {
+        static constexpr size_t offset = TokenSwap_SwapInfo_pool_mint_OFFSET;
+        static constexpr size_t size = 32;
+        static constexpr auto get = TokenSwap_SwapInfo_get_pool_mint;
+        static constexpr auto set = TokenSwap_SwapInfo_set_pool_mint;
+        static constexpr auto is = TokenSwap_SwapInfo_pool_mint_is;
+    };
+
+    /**
+     * Mint information for token A
+     */
+    struct token_a_mint {
+        static constexpr size_t offset = TokenSwap_SwapInfo_token_a_mint_OFFSET;
+        static constexpr size_t size = 32;
+        static constexpr auto get = TokenSwap_SwapInfo_get_token_a_mint;
+        static constexpr auto set = TokenSwap_SwapInfo_set_token_a_mint;
+        static constexpr auto is = TokenSwap_SwapInfo_token_a_mint_is;
+    };
+
+    /**
+     * Mint information for token B
+     */
+    struct token_b_mint {
+        static constexpr size_t offset = TokenSwap_SwapInfo_token_b_mint_OFFSET;
+        static constexpr size_t size = 32;
+        static constexpr auto get = TokenSwap_SwapInfo_get_token_b_mint;
+        static constexpr auto set = TokenSwap_SwapInfo_set_token_b_mint;
+        static constexpr auto is = TokenSwap_SwapInfo_token_b_mint_is;
+    };
+
+    /**
+     * Pool token account to receive trading and / or withdrawal fees
+     */
+    struct pool_fee_account {
+        static constexpr size_t offset = TokenSwap_SwapInfo_pool_fee_account_OFFSET;
+        static constexpr size_t size = 32;
+        static constexpr auto get = TokenSwap_SwapInfo_get_pool_fee_account;
+        static constexpr auto set = TokenSwap_SwapInfo_set_pool_fee_account;
+        static constexpr auto is = TokenSwap_SwapInfo_pool_fee_account_is;
+    };
+
+    /**
+     * Trade fee numerator
+     */
+    struct trade_fee_numerator {
+        static constexpr size_t offset = TokenSwap_SwapInfo_trade_fee_numerator_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = TokenSwap_SwapInfo_get_trade_fee_numerator;
+        static constexpr auto set = TokenSwap_SwapInfo_set_trade_fee_numerator;
+    };
+
+    /**
+     * Trade fee denominator
+     */
+    struct trade_fee_denominator {
+        static constexpr size_t offset = TokenSwap_SwapInfo_trade_fee_denominator_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = TokenSwap_SwapInfo_get_trade_fee_denominator;
+        static constexpr auto set = TokenSwap_SwapInfo_set_trade_fee_denominator;
+    };
+
+    /**
+     * Owner trade fee numerator
+     */
+    struct owner_trade_fee_numerator {
+        static constexpr size_t offset = TokenSwap_SwapInfo_owner_trade_fee_numerator_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = TokenSwap_SwapInfo_get_owner_trade_fee_numerator;
+        static constexpr auto set = TokenSwap_SwapInfo_set_owner_trade_fee_numerator;
+    };
+
+    /**
+     * Owner trade fee denominator
+     */
+    struct owner_trade_fee_denominator {
+        static constexpr size_t offset = TokenSwap_SwapInfo_owner_trade_fee_denominator_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = TokenSwap_SwapInfo_get_owner_trade_fee_denominator;
+        static constexpr auto set = TokenSwap_SwapInfo_set_owner_trade_fee_denominator;
+    };
+
+    /**
+     * Owner withdraw fee numerator
+     */
+    struct owner_withdraw_fee_numerator {
+        static constexpr size_t offset = TokenSwap_SwapInfo_owner_withdraw_fee_numerator_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = TokenSwap_SwapInfo_get_owner_withdraw_fee_numerator;
+        static constexpr auto set = TokenSwap_SwapInfo_set_owner_withdraw_fee_numerator;
+    };
+
+    /**
+     * Owner withdraw fee denominator
+     */
+    struct owner_withdraw_fee_denominator {
+        static constexpr size_t offset = TokenSwap_SwapInfo_owner_withdraw_fee_denominator_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = TokenSwap_SwapInfo_get_owner_withdraw_fee_denominator;
+        static constexpr auto set = TokenSwap_SwapInfo_set_owner_withdraw_fee_denominator;
+    };
+
+    /**
+     * Host trading fee numerator
+     */
+    struct host_fee_numerator {
+        static constexpr size_t offset = TokenSwap_SwapInfo_host_fee_numerator_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = TokenSwap_SwapInfo_get_host_fee_numerator;
+        static constexpr auto set = TokenSwap_SwapInfo_set_host_fee_numerator;
+    };
+
+    /**
+     * Host trading fee denominator
+     */
+    struct host_fee_denominator {
+        static constexpr size_t offset = TokenSwap_SwapInfo_host_fee_denominator_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = TokenSwap_SwapInfo_get_host_fee_denominator;
+        static constexpr auto set = TokenSwap_SwapInfo_set_host_fee_denominator;
+    };
+
+    /**
+     * The type of curve contained in the calculator
+     */
+    struct curve_type {
+        static constexpr size_t offset = TokenSwap_SwapInfo_curve_type_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = TokenSwap_SwapInfo_get_curve_type;
+        static constexpr auto set = TokenSwap_SwapInfo_set_curve_type;
+    };
+
+    /**
+     * `token_b_price` of a constant price curve, `amp` of a stable curve, `token_b_offset` of an offset curve, unused by a constant product curve
+     */
+    struct curve_parameter {
+        static constexpr size_t offset = TokenSwap_SwapInfo_curve_parameter_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = TokenSwap_SwapInfo_get_curve_parameter;
+        static constexpr auto set = TokenSwap_SwapInfo_set_curve_parameter;
+    };
+
+    /**
+     * Calculator bytes no curve uses yet
+     */
+    struct curve_padding {
+        static constexpr size_t offset = TokenSwap_SwapInfo_curve_padding_OFFSET;
+        static constexpr size_t size = 24;
+        static constexpr auto get = TokenSwap_SwapInfo_get_curve_padding;
+        static constexpr auto set = TokenSwap_SwapInfo_set_curve_padding;
+    };
+};
+
+} // namespace TokenSwap
+#endif
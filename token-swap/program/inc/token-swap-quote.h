@@ -0,0 +1,401 @@
+/**
+ * @brief SPL Token-Swap quotes for C routers
+ *
+ * Computes the result of a `Swap` instruction exactly as
+ * `SwapCurve::swap` does for constant product and offset curves, including
+ * the trading fee rounding, the ceiling division of the invariant and every
+ * failure the program would report.  All intermediate arithmetic is 128-bit.
+ *
+ * A quote that the program would reject is returned as all zeros; a
+ * successful quote always has a non-zero `destination_amount_swapped`.
+ * Minting the owner fee as pool tokens depends on the pool mint supply and is
+ * not covered.
+ */
+#pragma once
+
+#include "token-swap-layout.h"
+
+typedef unsigned __int128 TokenSwap_u128;
+
+/// Direction of a trade, token A in and token B out or the reverse
+typedef enum TokenSwap_TradeDirection {
+  TokenSwap_TradeDirection_AtoB,
+  TokenSwap_TradeDirection_BtoA,
+} TokenSwap_TradeDirection;
+
+/// The fees charged on the source amount of a trade
+typedef struct TokenSwap_TradeFees {
+  uint64_t trade_fee_numerator;
+  uint64_t trade_fee_denominator;
+  uint64_t owner_trade_fee_numerator;
+  uint64_t owner_trade_fee_denominator;
+} TokenSwap_TradeFees;
+
+/// Everything a quote depends on
+typedef struct TokenSwap_Pool {
+  /// Balance of the swap's token A account
+  uint64_t token_a_amount;
+  /// Balance of the swap's token B account
+  uint64_t token_b_amount;
+  /// `TokenSwap_CurveType_ConstantProduct` or `TokenSwap_CurveType_Offset`
+  TokenSwap_CurveType curve_type;
+  /// Offset added to the token B side by an offset curve
+  uint64_t token_b_offset;
+  TokenSwap_TradeFees fees;
+} TokenSwap_Pool;
+
+/// Result of a swap, all zero if the program would reject it
+typedef struct TokenSwap_Quote {
+  /// Amount of source token taken from the user, fees included
+  uint64_t source_amount_swapped;
+  /// Amount of destination token given to the user
+  uint64_t destination_amount_swapped;
+  /// Amount of source tokens going to pool holders
+  uint64_t trade_fee;
+  /// Amount of source tokens going to the owner
+  uint64_t owner_fee;
+} TokenSwap_Quote;
+
+/// A single quote of a batch
+typedef struct TokenSwap_QuoteRequest {
+  const TokenSwap_Pool *pool;
+  TokenSwap_TradeDirection direction;
+  uint64_t amount_in;
+} TokenSwap_QuoteRequest;
+
+/// `calculate_fee`, a non-zero fee is at least one token
+static inline bool TokenSwap_calculate_fee(TokenSwap_u128 token_amount,
+                                           TokenSwap_u128 fee_numerator,
+                                           TokenSwap_u128 fee_denominator,
+                                           TokenSwap_u128 *fee) {
+  if (fee_numerator == 0 || token_amount == 0) {
+    *fee = 0;
+    return true;
+  }
+  if (fee_denominator == 0 ||
+      token_amount > ~(TokenSwap_u128)0 / fee_numerator) {
+    return false;
+  }
+  *fee = token_amount * fee_numerator / fee_denominator;
+  if (*fee == 0) {
+    *fee = 1;
+  }
+  return true;
+}
+
+/// `CheckedCeilDiv::checked_ceil_div` for `u128`, fails if the quotient is
+/// zero and otherwise also returns the smallest divisor giving that quotient
+static inline bool TokenSwap_ceil_div(TokenSwap_u128 dividend,
+                                      TokenSwap_u128 divisor,
+                                      TokenSwap_u128 *quotient,
+                                      TokenSwap_u128 *new_divisor) {
+  if (divisor == 0) {
+    return false;
+  }
+  *quotient = dividend / divisor;
+  if (*quotient == 0) {
+    return false;
+  }
+  *new_divisor = divisor;
+  if (dividend % divisor > 0) {
+    *quotient += 1;
+    *new_divisor = dividend / *quotient;
+    if (dividend % *quotient > 0) {
+      *new_divisor += 1;
+    }
+  }
+  return true;
+}
+
+/// `constant_product::swap`, fails if nothing would be received
+static inline bool TokenSwap_constant_product_swap(
+    TokenSwap_u128 source_amount, TokenSwap_u128 swap_source_amount,
+    TokenSwap_u128 swap_destination_amount,
+    TokenSwap_u128 *source_amount_swapped,
+    TokenSwap_u128 *destination_amount_swapped) {
+  if (swap_source_amount != 0 &&
+      swap_destination_amount > ~(TokenSwap_u128)0 / swap_source_amount) {
+    return false;
+  }
+  TokenSwap_u128 invariant = swap_source_amount * swap_destination_amount;
+  TokenSwap_u128 new_swap_source_amount = swap_source_amount + source_amount;
+  if (new_swap_source_amount < swap_source_amount) {
+    return false;
+  }
+  TokenSwap_u128 new_swap_destination_amount;
+  if (!TokenSwap_ceil_div(invariant, new_swap_source_amount,
+                          &new_swap_destination_amount,
+                          &new_swap_source_amount)) {
+    return false;
+  }
+  if (new_swap_source_amount < swap_source_amount ||
+      swap_destination_amount < new_swap_destination_amount) {
+    return false;
+  }
+  *source_amount_swapped = new_swap_source_amount - swap_source_amount;
+  *destination_amount_swapped =
+      swap_destination_amount - new_swap_destination_amount;
+  return *destination_amount_swapped != 0;
+}
+
+/// Quotes swapping `amount_in` through `pool`, returns `false` and a zeroed
+/// `quote` if the program would reject the swap
+static inline bool TokenSwap_quote(const TokenSwap_Pool *pool,
+                                   TokenSwap_TradeDirection direction,
+                                   uint64_t amount_in,
+                                   TokenSwap_Quote *quote) {
+  *quote = (TokenSwap_Quote){0, 0, 0, 0};
+
+  TokenSwap_u128 swap_source_amount, swap_destination_amount;
+  if (direction == TokenSwap_TradeDirection_AtoB) {
+    swap_source_amount = pool->token_a_amount;
+    swap_destination_amount = pool->token_b_amount;
+  } else {
+    swap_source_amount = pool->token_b_amount;
+    swap_destination_amount = pool->token_a_amount;
+  }
+
+  TokenSwap_u128 trade_fee, owner_fee;
+  if (!TokenSwap_calculate_fee(amount_in, pool->fees.trade_fee_numerator,
+                               pool->fees.trade_fee_denominator, &trade_fee) ||
+      !TokenSwap_calculate_fee(amount_in, pool->fees.owner_trade_fee_numerator,
+                               pool->fees.owner_trade_fee_denominator,
+                               &owner_fee)) {
+    return false;
+  }
+  TokenSwap_u128 total_fees = trade_fee + owner_fee;
+  if (total_fees > amount_in) {
+    return false;
+  }
+
+  // The offset curve trades against a token B balance raised by the offset,
+  // but the real balances must still cover the result
+  TokenSwap_u128 curve_source_amount = swap_source_amount;
+  TokenSwap_u128 curve_destination_amount = swap_destination_amount;
+  if (pool->curve_type == TokenSwap_CurveType_Offset) {
+    if (direction == TokenSwap_TradeDirection_AtoB) {
+      curve_destination_amount += pool->token_b_offset;
+    } else {
+      curve_source_amount += pool->token_b_offset;
+    }
+  } else if (pool->curve_type != TokenSwap_CurveType_ConstantProduct) {
+    return false;
+  }
+
+  TokenSwap_u128 source_amount_swapped, destination_amount_swapped;
+  if (!TokenSwap_constant_product_swap(
+          amount_in - total_fees, curve_source_amount,
+          curve_destination_amount, &source_amount_swapped,
+          &destination_amount_swapped)) {
+    return false;
+  }
+  source_amount_swapped += total_fees;
+  if (destination_amount_swapped > swap_destination_amount ||
+      source_amount_swapped > UINT64_MAX) {
+    return false;
+  }
+
+  quote->source_amount_swapped = (uint64_t)source_amount_swapped;
+  quote->destination_amount_swapped = (uint64_t)destination_amount_swapped;
+  quote->trade_fee = (uint64_t)trade_fee;
+  quote->owner_fee = (uint64_t)owner_fee;
+  return true;
+}
+
+/// Quotes every request into the matching entry of `quotes`, returning how
+/// many would succeed
+static inline size_t TokenSwap_quote_batch(
+    const TokenSwap_QuoteRequest *requests, size_t requests_len,
+    TokenSwap_Quote *quotes) {
+  size_t succeeded = 0;
+  for (size_t i = 0; i < requests_len; i++) {
+    succeeded += TokenSwap_quote(requests[i].pool, requests[i].direction,
+                                 requests[i].amount_in, &quotes[i]);
+  }
+  return succeeded;
+}
+
+/// Quotes several input amounts against the same pool, returning how many
+/// would succeed
+static inline size_t TokenSwap_quote_amounts(
+    const TokenSwap_Pool *pool, TokenSwap_TradeDirection direction,
+    const uint64_t *amounts_in, size_t amounts_len, TokenSwap_Quote *quotes) {
+  size_t succeeded = 0;
+  for (size_t i = 0; i < amounts_len; i++) {
+    succeeded += TokenSwap_quote(pool, direction, amounts_in[i], &quotes[i]);
+  }
+  return succeeded;
+}
+
+/// Loads the curve and fees of packed swap account `data` together with the
+/// balances of its token accounts.  Fails if the data is invalid, the swap is
+/// not initialized or its curve is neither constant product nor offset.
+static inline bool TokenSwap_Pool_load(TokenSwap_Pool *pool,
+                                       const uint8_t *data, uint64_t data_len,
+                                       uint64_t token_a_amount,
+                                       uint64_t token_b_amount) {
+  if (!TokenSwap_SwapInfo_is_initialized(data, data_len)) {
+    return false;
+  }
+  TokenSwap_CurveType curve_type = TokenSwap_SwapInfo_get_curve_type(data);
+  if (curve_type != TokenSwap_CurveType_ConstantProduct &&
+      curve_type != TokenSwap_CurveType_Offset) {
+    return false;
+  }
+  pool->token_a_amount = token_a_amount;
+  pool->token_b_amount = token_b_amount;
+  pool->curve_type = curve_type;
+  pool->token_b_offset = curve_type == TokenSwap_CurveType_Offset
+                             ? TokenSwap_SwapInfo_get_curve_parameter(data)
+                             : 0;
+  pool->fees = (TokenSwap_TradeFees){
+      TokenSwap_SwapInfo_get_trade_fee_numerator(data),
+      TokenSwap_SwapInfo_get_trade_fee_denominator(data),
+      TokenSwap_SwapInfo_get_owner_trade_fee_numerator(data),
+      TokenSwap_SwapInfo_get_owner_trade_fee_denominator(data),
+  };
+  return true;
+}
+
+/**
+ * Pools stored column by column, for quoting one amount against many pools
+ *
+ * Constant product pools are stored with a `token_b_offset` of zero, which
+ * the offset curve treats identically.  Every column holds `len` entries.
+ */
+typedef struct TokenSwap_PoolColumns {
+  uint64_t *token_a_amount;
+  uint64_t *token_b_amount;
+  uint64_t *token_b_offset;
+  uint64_t *trade_fee_numerator;
+  uint64_t *trade_fee_denominator;
+  uint64_t *owner_trade_fee_numerator;
+  uint64_t *owner_trade_fee_denominator;
+  size_t len;
+} TokenSwap_PoolColumns;
+
+/// Stores `pool` at `index`, fails if its curve cannot be quoted
+static inline bool TokenSwap_PoolColumns_set(TokenSwap_PoolColumns *columns,
+                                             size_t index,
+                                             const TokenSwap_Pool *pool) {
+  if (pool->curve_type != TokenSwap_CurveType_ConstantProduct &&
+      pool->curve_type != TokenSwap_CurveType_Offset) {
+    return false;
+  }
+  columns->token_a_amount[index] = pool->token_a_amount;
+  columns->token_b_amount[index] = pool->token_b_amount;
+  columns->token_b_offset[index] =
+      pool->curve_type == TokenSwap_CurveType_Offset ? pool->token_b_offset : 0;
+  columns->trade_fee_numerator[index] = pool->fees.trade_fee_numerator;
+  columns->trade_fee_denominator[index] = pool->fees.trade_fee_denominator;
+  columns->owner_trade_fee_numerator[index] =
+      pool->fees.owner_trade_fee_numerator;
+  columns->owner_trade_fee_denominator[index] =
+      pool->fees.owner_trade_fee_denominator;
+  return true;
+}
+
+/// `calculate_fee` for 64-bit inputs, dividing in 64 bits when the product
+/// fits.  Returns `UINT64_MAX`, larger than any valid fee, on failure.
+static inline uint64_t TokenSwap_fee_u64(uint64_t token_amount,
+                                         uint64_t fee_numerator,
+                                         uint64_t fee_denominator) {
+  if (fee_numerator == 0 || token_amount == 0) {
+    return 0;
+  }
+  if (fee_denominator == 0) {
+    return UINT64_MAX;
+  }
+  uint64_t product;
+  uint64_t fee;
+  if (!__builtin_mul_overflow(token_amount, fee_numerator, &product)) {
+    fee = product / fee_denominator;
+  } else {
+    TokenSwap_u128 wide =
+        (TokenSwap_u128)token_amount * fee_numerator / fee_denominator;
+    fee = wide > UINT64_MAX ? UINT64_MAX : (uint64_t)wide;
+  }
+  return fee == 0 ? 1 : fee;
+}
+
+/**
+ * Quotes swapping `amount_in` through every pool of `columns`, storing the
+ * destination amount of each, or zero if the program would reject the swap,
+ * and returning how many would succeed
+ *
+ * Each entry equals `destination_amount_swapped` of `TokenSwap_quote`.  Only
+ * the destination amount is computed, which saves the second division of the
+ * ceiling division, and the invariant is divided in 64 bits whenever it fits.
+ */
+static inline size_t TokenSwap_quote_columns(
+    const TokenSwap_PoolColumns *columns, TokenSwap_TradeDirection direction,
+    uint64_t amount_in, uint64_t *destination_amounts) {
+  const uint64_t *source_column = direction == TokenSwap_TradeDirection_AtoB
+                                      ? columns->token_a_amount
+                                      : columns->token_b_amount;
+  const uint64_t *destination_column =
+      direction == TokenSwap_TradeDirection_AtoB ? columns->token_b_amount
+                                                 : columns->token_a_amount;
+  size_t succeeded = 0;
+  for (size_t i = 0; i < columns->len; i++) {
+    destination_amounts[i] = 0;
+
+    uint64_t trade_fee =
+        TokenSwap_fee_u64(amount_in, columns->trade_fee_numerator[i],
+                          columns->trade_fee_denominator[i]);
+    uint64_t owner_fee =
+        TokenSwap_fee_u64(amount_in, columns->owner_trade_fee_numerator[i],
+                          columns->owner_trade_fee_denominator[i]);
+    uint64_t total_fees;
+    if (__builtin_add_overflow(trade_fee, owner_fee, &total_fees) ||
+        total_fees > amount_in) {
+      continue;
+    }
+
+    TokenSwap_u128 swap_source_amount = source_column[i];
+    TokenSwap_u128 swap_destination_amount = destination_column[i];
+    if (direction == TokenSwap_TradeDirection_AtoB) {
+      swap_destination_amount += columns->token_b_offset[i];
+    } else {
+      swap_source_amount += columns->token_b_offset[i];
+    }
+
+    if (swap_source_amount != 0 &&
+        swap_destination_amount > ~(TokenSwap_u128)0 / swap_source_amount) {
+      continue;
+    }
+    TokenSwap_u128 invariant = swap_source_amount * swap_destination_amount;
+    TokenSwap_u128 new_swap_source_amount =
+        swap_source_amount + (amount_in - total_fees);
+    TokenSwap_u128 quotient;
+    bool remainder;
+    if ((invariant >> 64) == 0 && (new_swap_source_amount >> 64) == 0) {
+      uint64_t dividend = (uint64_t)invariant;
+      uint64_t divisor = (uint64_t)new_swap_source_amount;
+      if (divisor == 0) {
+        continue;
+      }
+      quotient = dividend / divisor;
+      remainder = dividend % divisor != 0;
+    } else {
+      quotient = invariant / new_swap_source_amount;
+      remainder = invariant % new_swap_source_amount != 0;
+    }
+    if (quotient == 0) {
+      continue;
+    }
+    TokenSwap_u128 new_swap_destination_amount = quotient + remainder;
+    if (swap_destination_amount < new_swap_destination_amount) {
+      continue;
+    }
+    TokenSwap_u128 destination_amount_swapped =
+        swap_destination_amount - new_swap_destination_amount;
+    if (destination_amount_swapped == 0 ||
+        destination_amount_swapped > destination_column[i]) {
+      continue;
+    }
+    destination_amounts[i] = (uint64_t)destination_amount_swapped;
+    succeeded++;
+  }
+  return succeeded;
+}
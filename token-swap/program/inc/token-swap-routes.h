@@ -0,0 +1,477 @@
+/**
+ * @brief Route quotes kept current from pool account updates
+ *
+ * A router registers swap pools and the routes it quotes through them, then
+ * feeds every write of the watched accounts, each pool's swap account, its
+ * token A and token B accounts and its pool mint, to `TokenSwap_Routes_update`.
+ * Each pool lists the routes through it, so an update marks only those routes
+ * dirty, and a route is requoted only when it is next read or refreshed.  The
+ * work of an update is proportional to the routes touching the pool, however
+ * many pools are registered, and an update that leaves the reserves, curve
+ * and fees unchanged marks nothing.
+ *
+ * The pool mint supply is tracked for callers valuing pool tokens; as in
+ * `token-swap-quote.h`, quotes do not depend on it.
+ */
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "token-swap-quote.h"
+
+/// Most pools a route passes through
+#define TokenSwap_ROUTE_MAX_HOPS 4
+
+/// Which account of a pool an address is
+typedef enum TokenSwap_Watch {
+  TokenSwap_Watch_Swap,
+  TokenSwap_Watch_TokenA,
+  TokenSwap_Watch_TokenB,
+  TokenSwap_Watch_PoolMint,
+} TokenSwap_Watch;
+
+/// Bits of `TokenSwap_RoutePool::loaded`, one per watched account
+#define TokenSwap_LOADED(watch) (1u << (watch))
+#define TokenSwap_LOADED_QUOTABLE                                              \
+  (TokenSwap_LOADED(TokenSwap_Watch_Swap) |                                    \
+   TokenSwap_LOADED(TokenSwap_Watch_TokenA) |                                  \
+   TokenSwap_LOADED(TokenSwap_Watch_TokenB))
+
+typedef struct TokenSwap_RoutePool {
+  /// Watched accounts, indexed by `TokenSwap_Watch`
+  uint8_t accounts[4][32];
+  uint8_t token_a_mint[32];
+  uint8_t token_b_mint[32];
+  TokenSwap_Pool pool;
+  uint64_t pool_mint_supply;
+  /// Accounts whose current state is known and valid
+  uint32_t loaded;
+  /// Indexes of the routes through this pool, each listed once
+  uint32_t *routes;
+  uint32_t routes_len;
+  uint32_t routes_capacity;
+} TokenSwap_RoutePool;
+
+/// One pool of a route and the direction it is traded in
+typedef struct TokenSwap_Hop {
+  uint32_t pool;
+  TokenSwap_TradeDirection direction;
+} TokenSwap_Hop;
+
+typedef struct TokenSwap_Route {
+  TokenSwap_Hop hops[TokenSwap_ROUTE_MAX_HOPS];
+  uint32_t hops_len;
+  uint64_t amount_in;
+  /// Output of the last hop as of the last requote, zero if any hop fails
+  uint64_t amount_out;
+  /// Set when a pool of the route changes, cleared by requoting
+  bool dirty;
+  /// Whether the route is in the dirty queue
+  bool queued;
+} TokenSwap_Route;
+
+/// A watched address, an unused slot has a `pool` of `UINT32_MAX`
+typedef struct TokenSwap_WatchSlot {
+  uint8_t address[32];
+  uint32_t pool;
+  TokenSwap_Watch watch;
+} TokenSwap_WatchSlot;
+
+typedef struct TokenSwap_Routes {
+  TokenSwap_RoutePool *pools;
+  size_t pools_len;
+  size_t pools_capacity;
+  TokenSwap_Route *routes;
+  size_t routes_len;
+  size_t routes_capacity;
+  /// Open-addressing table of watched addresses, at most half full
+  TokenSwap_WatchSlot *watches;
+  size_t watches_len;
+  size_t watches_capacity;
+  /// Routes marked dirty since the last refresh, each queued once
+  uint32_t *queue;
+  size_t queue_len;
+} TokenSwap_Routes;
+
+/// Allocates `count` unused watch slots
+static inline TokenSwap_WatchSlot *TokenSwap_WatchSlot_alloc(size_t count) {
+  TokenSwap_WatchSlot *slots =
+      (TokenSwap_WatchSlot *)malloc(count * sizeof(*slots));
+  for (size_t i = 0; slots != NULL && i < count; i++) {
+    slots[i].pool = UINT32_MAX;
+  }
+  return slots;
+}
+
+static inline bool TokenSwap_Routes_init(TokenSwap_Routes *routes) {
+  memset(routes, 0, sizeof(*routes));
+  routes->watches_capacity = 64;
+  routes->watches = TokenSwap_WatchSlot_alloc(routes->watches_capacity);
+  return routes->watches != NULL;
+}
+
+static inline void TokenSwap_Routes_free(TokenSwap_Routes *routes) {
+  for (size_t i = 0; i < routes->pools_len; i++) {
+    free(routes->pools[i].routes);
+  }
+  free(routes->pools);
+  free(routes->routes);
+  free(routes->watches);
+  free(routes->queue);
+  memset(routes, 0, sizeof(*routes));
+}
+
+/// Returns the slot watching `address` or the unused slot where it belongs
+static inline TokenSwap_WatchSlot *
+TokenSwap_Routes_slot(const TokenSwap_Routes *routes, const uint8_t *address) {
+  size_t mask = routes->watches_capacity - 1;
+  size_t slot = SplPubkey_hash(address) & mask;
+  while (routes->watches[slot].pool != UINT32_MAX &&
+         !SplPubkey_eq(routes->watches[slot].address, address)) {
+    slot = (slot + 1) & mask;
+  }
+  return &routes->watches[slot];
+}
+
+/// Grows the watch table to take `added` more addresses
+static inline bool TokenSwap_Routes_reserve_watches(TokenSwap_Routes *routes,
+                                                    size_t added) {
+  size_t capacity = routes->watches_capacity;
+  while (2 * (routes->watches_len + added) > capacity) {
+    capacity *= 2;
+  }
+  if (capacity == routes->watches_capacity) {
+    return true;
+  }
+  TokenSwap_WatchSlot *old = routes->watches;
+  size_t old_capacity = routes->watches_capacity;
+  routes->watches = TokenSwap_WatchSlot_alloc(capacity);
+  if (routes->watches == NULL) {
+    routes->watches = old;
+    return false;
+  }
+  routes->watches_capacity = capacity;
+  for (size_t i = 0; i < old_capacity; i++) {
+    if (old[i].pool != UINT32_MAX) {
+      *TokenSwap_Routes_slot(routes, old[i].address) = old[i];
+    }
+  }
+  free(old);
+  return true;
+}
+
+/// Doubles `*capacity` until it holds `len` items of `size` bytes
+static inline bool TokenSwap_Routes_grow(void **items, size_t *capacity,
+                                         size_t len, size_t size) {
+  if (len <= *capacity) {
+    return true;
+  }
+  size_t grown = *capacity == 0 ? 8 : *capacity;
+  while (grown < len) {
+    grown *= 2;
+  }
+  void *reallocated = realloc(*items, grown * size);
+  if (reallocated == NULL) {
+    return false;
+  }
+  *items = reallocated;
+  *capacity = grown;
+  return true;
+}
+
+/**
+ * Registers the pool of packed swap account `data` at `swap_address`,
+ * storing its index to `pool`
+ *
+ * The pool is quoted once both of its token accounts have been updated.
+ * Fails if the data cannot be quoted, see `TokenSwap_Pool_load`, or if one
+ * of its accounts is already watched.
+ */
+static inline bool TokenSwap_Routes_add_pool(TokenSwap_Routes *routes,
+                                             const uint8_t *swap_address,
+                                             const uint8_t *data,
+                                             uint64_t data_len,
+                                             uint32_t *pool) {
+  TokenSwap_RoutePool added;
+  memset(&added, 0, sizeof(added));
+  if (routes->pools_len >= UINT32_MAX ||
+      !TokenSwap_Pool_load(&added.pool, data, data_len, 0, 0)) {
+    return false;
+  }
+  memcpy(added.accounts[TokenSwap_Watch_Swap], swap_address, 32);
+  memcpy(added.accounts[TokenSwap_Watch_TokenA],
+         TokenSwap_SwapInfo_get_token_a(data), 32);
+  memcpy(added.accounts[TokenSwap_Watch_TokenB],
+         TokenSwap_SwapInfo_get_token_b(data), 32);
+  memcpy(added.accounts[TokenSwap_Watch_PoolMint],
+         TokenSwap_SwapInfo_get_pool_mint(data), 32);
+  memcpy(added.token_a_mint, TokenSwap_SwapInfo_get_token_a_mint(data), 32);
+  memcpy(added.token_b_mint, TokenSwap_SwapInfo_get_token_b_mint(data), 32);
+  added.loaded = TokenSwap_LOADED(TokenSwap_Watch_Swap);
+
+  for (int watch = 0; watch < 4; watch++) {
+    for (int other = 0; other < watch; other++) {
+      if (SplPubkey_eq(added.accounts[watch], added.accounts[other])) {
+        return false;
+      }
+    }
+    if (TokenSwap_Routes_slot(routes, added.accounts[watch])->pool !=
+        UINT32_MAX) {
+      return false;
+    }
+  }
+  if (!TokenSwap_Routes_reserve_watches(routes, 4) ||
+      !TokenSwap_Routes_grow((void **)&routes->pools, &routes->pools_capacity,
+                             routes->pools_len + 1, sizeof(*routes->pools))) {
+    return false;
+  }
+  *pool = (uint32_t)routes->pools_len;
+  for (int watch = 0; watch < 4; watch++) {
+    TokenSwap_WatchSlot *slot =
+        TokenSwap_Routes_slot(routes, added.accounts[watch]);
+    memcpy(slot->address, added.accounts[watch], 32);
+    slot->pool = *pool;
+    slot->watch = (TokenSwap_Watch)watch;
+  }
+  routes->watches_len += 4;
+  routes->pools[routes->pools_len++] = added;
+  return true;
+}
+
+/// Mint traded into or out of `hop`
+static inline const uint8_t *
+TokenSwap_Routes_hop_mint(const TokenSwap_Routes *routes,
+                          const TokenSwap_Hop *hop, bool destination) {
+  const TokenSwap_RoutePool *pool = &routes->pools[hop->pool];
+  bool a = (hop->direction == TokenSwap_TradeDirection_AtoB) != destination;
+  return a ? pool->token_a_mint : pool->token_b_mint;
+}
+
+/**
+ * Registers a route swapping `amount_in` through `hops_len` hops in order,
+ * storing its index to `route`
+ *
+ * Fails unless every hop trades the mint the previous one produced.  The
+ * route is dirty until first quoted.
+ */
+static inline bool TokenSwap_Routes_add_route(TokenSwap_Routes *routes,
+                                              const TokenSwap_Hop *hops,
+                                              uint32_t hops_len,
+                                              uint64_t amount_in,
+                                              uint32_t *route) {
+  if (hops_len == 0 || hops_len > TokenSwap_ROUTE_MAX_HOPS ||
+      routes->routes_len >= UINT32_MAX) {
+    return false;
+  }
+  for (uint32_t i = 0; i < hops_len; i++) {
+    if (hops[i].pool >= routes->pools_len ||
+        (hops[i].direction != TokenSwap_TradeDirection_AtoB &&
+         hops[i].direction != TokenSwap_TradeDirection_BtoA)) {
+      return false;
+    }
+    if (i > 0 &&
+        !SplPubkey_eq(TokenSwap_Routes_hop_mint(routes, &hops[i - 1], true),
+                      TokenSwap_Routes_hop_mint(routes, &hops[i], false))) {
+      return false;
+    }
+  }
+  size_t len = routes->routes_len + 1;
+  if (!TokenSwap_Routes_grow((void **)&routes->routes,
+                             &routes->routes_capacity, len,
+                             sizeof(*routes->routes))) {
+    return false;
+  }
+  // The queue holds each route at most once, so it never outgrows them
+  size_t queue_capacity = routes->routes_capacity;
+  uint32_t *queue = (uint32_t *)realloc(routes->queue,
+                                        queue_capacity * sizeof(*queue));
+  if (queue == NULL) {
+    return false;
+  }
+  routes->queue = queue;
+
+  *route = (uint32_t)routes->routes_len;
+  for (uint32_t i = 0; i < hops_len; i++) {
+    TokenSwap_RoutePool *pool = &routes->pools[hops[i].pool];
+    // A route through a pool twice is listed once
+    if (pool->routes_len > 0 && pool->routes[pool->routes_len - 1] == *route) {
+      continue;
+    }
+    size_t capacity = pool->routes_capacity;
+    if (!TokenSwap_Routes_grow((void **)&pool->routes, &capacity,
+                               pool->routes_len + 1, sizeof(*pool->routes))) {
+      // Unlist the route from the pools it was already added to
+      for (uint32_t j = 0; j < i; j++) {
+        TokenSwap_RoutePool *listed = &routes->pools[hops[j].pool];
+        if (listed->routes_len > 0 &&
+            listed->routes[listed->routes_len - 1] == *route) {
+          listed->routes_len--;
+        }
+      }
+      return false;
+    }
+    pool->routes_capacity = (uint32_t)capacity;
+    pool->routes[pool->routes_len++] = *route;
+  }
+
+  TokenSwap_Route *added = &routes->routes[routes->routes_len++];
+  memset(added, 0, sizeof(*added));
+  memcpy(added->hops, hops, hops_len * sizeof(*hops));
+  added->hops_len = hops_len;
+  added->amount_in = amount_in;
+  added->dirty = true;
+  added->queued = true;
+  routes->queue[routes->queue_len++] = *route;
+  return true;
+}
+
+/// Marks every route through `pool` dirty, returning how many were clean
+static inline size_t TokenSwap_Routes_touch(TokenSwap_Routes *routes,
+                                            uint32_t pool) {
+  const TokenSwap_RoutePool *touched = &routes->pools[pool];
+  size_t marked = 0;
+  for (uint32_t i = 0; i < touched->routes_len; i++) {
+    TokenSwap_Route *route = &routes->routes[touched->routes[i]];
+    marked += !route->dirty;
+    route->dirty = true;
+    if (!route->queued) {
+      route->queued = true;
+      routes->queue[routes->queue_len++] = touched->routes[i];
+    }
+  }
+  return marked;
+}
+
+/// Balance of packed token account `data`, `false` if it is not an
+/// initialized account
+static inline bool TokenSwap_token_account_amount(const uint8_t *data,
+                                                  uint64_t data_len,
+                                                  uint64_t *amount) {
+  if (data_len != TokenSwap_Token_Account_LEN ||
+      data[TokenSwap_Token_Account_state_OFFSET] == 0) {
+    return false;
+  }
+  *amount = TokenSwap_read_u64(data + TokenSwap_Token_Account_amount_OFFSET);
+  return true;
+}
+
+/**
+ * Applies a write of account `address`, `data_len` bytes of `data` being its
+ * new packed state and zero bytes a closed account
+ *
+ * Unwatched addresses are ignored.  Returns how many routes became dirty,
+ * which is zero unless the write changed what the pool quotes.
+ */
+static inline size_t TokenSwap_Routes_update(TokenSwap_Routes *routes,
+                                             const uint8_t *address,
+                                             const uint8_t *data,
+                                             uint64_t data_len) {
+  const TokenSwap_WatchSlot *slot = TokenSwap_Routes_slot(routes, address);
+  if (slot->pool == UINT32_MAX) {
+    return 0;
+  }
+  TokenSwap_RoutePool *pool = &routes->pools[slot->pool];
+  uint32_t bit = TokenSwap_LOADED(slot->watch);
+  uint32_t loaded = pool->loaded;
+  TokenSwap_Pool before = pool->pool;
+  bool valid;
+  switch (slot->watch) {
+  case TokenSwap_Watch_Swap:
+    valid = TokenSwap_Pool_load(&pool->pool, data, data_len,
+                                before.token_a_amount, before.token_b_amount);
+    if (!valid) {
+      pool->pool = before;
+    }
+    break;
+  case TokenSwap_Watch_TokenA:
+    valid = TokenSwap_token_account_amount(data, data_len,
+                                           &pool->pool.token_a_amount);
+    break;
+  case TokenSwap_Watch_TokenB:
+    valid = TokenSwap_token_account_amount(data, data_len,
+                                           &pool->pool.token_b_amount);
+    break;
+  case TokenSwap_Watch_PoolMint:
+    valid = data_len == TokenSwap_Token_Mint_LEN &&
+            data[TokenSwap_Token_Mint_is_initialized_OFFSET] == 1;
+    if (valid) {
+      pool->pool_mint_supply =
+          TokenSwap_read_u64(data + TokenSwap_Token_Mint_supply_OFFSET);
+    }
+    break;
+  default:
+    return 0;
+  }
+  pool->loaded = valid ? loaded | bit : loaded & ~bit;
+
+  bool was_quotable =
+      (loaded & TokenSwap_LOADED_QUOTABLE) == TokenSwap_LOADED_QUOTABLE;
+  bool is_quotable =
+      (pool->loaded & TokenSwap_LOADED_QUOTABLE) == TokenSwap_LOADED_QUOTABLE;
+  bool changed = before.token_a_amount != pool->pool.token_a_amount ||
+                 before.token_b_amount != pool->pool.token_b_amount ||
+                 before.curve_type != pool->pool.curve_type ||
+                 before.token_b_offset != pool->pool.token_b_offset ||
+                 memcmp(&before.fees, &pool->pool.fees, sizeof(before.fees));
+  if (was_quotable == is_quotable && (!is_quotable || !changed)) {
+    return 0;
+  }
+  return TokenSwap_Routes_touch(routes, slot->pool);
+}
+
+/// Quotes `route` through its pools as they are now
+static inline uint64_t
+TokenSwap_Routes_requote(const TokenSwap_Routes *routes,
+                         const TokenSwap_Route *route) {
+  uint64_t amount = route->amount_in;
+  for (uint32_t i = 0; i < route->hops_len; i++) {
+    const TokenSwap_RoutePool *pool = &routes->pools[route->hops[i].pool];
+    TokenSwap_Quote quote;
+    if ((pool->loaded & TokenSwap_LOADED_QUOTABLE) !=
+            TokenSwap_LOADED_QUOTABLE ||
+        !TokenSwap_quote(&pool->pool, route->hops[i].direction, amount,
+                         &quote)) {
+      return 0;
+    }
+    amount = quote.destination_amount_swapped;
+  }
+  return amount;
+}
+
+/// Output amount of `route`, requoted first if it is dirty, zero if the
+/// program would reject any of its swaps
+static inline uint64_t TokenSwap_Routes_quote(TokenSwap_Routes *routes,
+                                              uint32_t route) {
+  TokenSwap_Route *quoted = &routes->routes[route];
+  if (quoted->dirty) {
+    quoted->amount_out = TokenSwap_Routes_requote(routes, quoted);
+    quoted->dirty = false;
+  }
+  return quoted->amount_out;
+}
+
+/**
+ * Requotes every route marked dirty since the last refresh and empties the
+ * queue, storing the index of each route requoted to `refreshed` unless it
+ * is `NULL`, and returning how many there were
+ *
+ * Routes already requoted by `TokenSwap_Routes_quote` are skipped.
+ */
+static inline size_t TokenSwap_Routes_refresh(TokenSwap_Routes *routes,
+                                              uint32_t *refreshed) {
+  size_t count = 0;
+  for (size_t i = 0; i < routes->queue_len; i++) {
+    TokenSwap_Route *route = &routes->routes[routes->queue[i]];
+    route->queued = false;
+    if (route->dirty) {
+      TokenSwap_Routes_quote(routes, routes->queue[i]);
+      if (refreshed != NULL) {
+        refreshed[count] = routes->queue[i];
+      }
+      count++;
+    }
+  }
+  routes->queue_len = 0;
+  return count;
+}
@@ -8,155 +8,105 @@
 #include <stdlib.h>
 
 /**
- * fee rate as a ratio
+ * Curve types supported by the token-swap program.
  */
-typedef struct TokenSwap_Fee {
+typedef enum TokenSwap_CurveType {
     /**
-     * denominator of the fee ratio
+     * Uniswap-style constant product curve, invariant = token_a_amount * token_b_amount
      */
-    uint64_t denominator;
+    TokenSwap_CurveType_ConstantProduct,
     /**
-     * numerator of the fee ratio
+     * Flat line, always providing 1:1 from one token to another
      */
-    uint64_t numerator;
-} TokenSwap_Fee;
+    TokenSwap_CurveType_ConstantPrice,
+    /**
+     * Stable, like uniswap, but with wide zone of 1:1 instead of one point
+     */
+    TokenSwap_CurveType_Stable,
+    /**
+     * Offset curve, like Uniswap, but the token B side has a faked offset
+     */
+    TokenSwap_CurveType_Offset,
+} TokenSwap_CurveType;
 
 /**
- * Instructions supported by the SwapInfo program.
+ * Swap instruction data
  */
-typedef enum TokenSwap_SwapInstruction_Tag {
-    /**
-     *   Initializes a new SwapInfo.
-     *
-     *   0. `[writable, signer]` New Token-swap to create.
-     *   1. `[]` $authority derived from `create_program_address(&[Token-swap account])`
-     *   2. `[]` token_a Account. Must be non zero, owned by $authority.
-     *   3. `[]` token_b Account. Must be non zero, owned by $authority.
-     *   4. `[writable]` pool Token. Must be empty, owned by $authority.
-     *   5. `[writable]` Pool Account to deposit the generated tokens, user is the owner.
-     *   6. '[]` Token program id
-     *   userdata: fee rate as a ratio
-     */
-    Initialize,
-    /**
-     *   Swap the tokens in the pool.
-     *
-     *   0. `[]` Token-swap
-     *   1. `[]` $authority
-     *   2. `[writable]` token_(A|B) SOURCE Account, amount is transferable by $authority,
-     *   4. `[writable]` token_(A|B) Base Account to swap INTO.  Must be the SOURCE token.
-     *   5. `[writable]` token_(A|B) Base Account to swap FROM.  Must be the DEST token.
-     *   6. `[writable]` token_(A|B) DEST Account assigned to USER as the owner.
-     *   7. '[]` Token program id
-     *   userdata: SOURCE amount to transfer, output to DEST is based on the exchange rate
-     */
-    Swap,
-    /**
-     *   Deposit some tokens into the pool.  The output is a "pool" token representing ownership
-     *   into the pool. Inputs are converted to the current ratio.
-     *
-     *   0. `[]` Token-swap
-     *   1. `[]` $authority
-     *   2. `[writable]` token_a $authority can transfer amount,
-     *   4. `[writable]` token_b $authority can transfer amount,
-     *   6. `[writable]` token_a Base Account to deposit into.
-     *   7. `[writable]` token_b Base Account to deposit into.
-     *   8. `[writable]` Pool MINT account, $authority is the owner.
-     *   9. `[writable]` Pool Account to deposit the generated tokens, user is the owner.
-     *   10. '[]` Token program id
-     *   userdata: token_a amount to transfer.  token_b amount is set by the current exchange rate.
-     */
-    Deposit,
-    /**
-     *   Withdraw the token from the pool at the current ratio.
-     *
-     *   0. `[]` Token-swap
-     *   1. `[]` $authority
-     *   2. `[writable]` SOURCE Pool account, amount is transferable by $authority.
-     *   5. `[writable]` token_a Account to withdraw FROM.
-     *   6. `[writable]` token_b Account to withdraw FROM.
-     *   7. `[writable]` token_a user Account.
-     *   8. `[writable]` token_b user Account.
-     *   9. '[]` Token program id
-     *   userdata: SOURCE amount of pool tokens to transfer. User receives an output based on the
-     *   percentage of the pool tokens that are returned.
-     */
-    Withdraw,
-} TokenSwap_SwapInstruction_Tag;
-
-typedef struct TokenSwap_Initialize_Body {
-    TokenSwap_Fee _0;
-} TokenSwap_Initialize_Body;
-
-typedef struct TokenSwap_Swap_Body {
-    uint64_t _0;
-} TokenSwap_Swap_Body;
-
-typedef struct TokenSwap_Deposit_Body {
-    uint64_t _0;
-} TokenSwap_Deposit_Body;
-
-typedef struct TokenSwap_Withdraw_Body {
-    uint64_t _0;
-} TokenSwap_Withdraw_Body;
-
-typedef struct TokenSwap_SwapInstruction {
-    TokenSwap_SwapInstruction_Tag tag;
-    union {
-        TokenSwap_Initialize_Body initialize;
-        TokenSwap_Swap_Body swap;
-        TokenSwap_Deposit_Body deposit;
-        TokenSwap_Withdraw_Body withdraw;
-    };
-} TokenSwap_SwapInstruction;
-
-typedef uint8_t TokenSwap_Pubkey[32];
+typedef struct TokenSwap_Swap {
+    /**
+     * SOURCE amount to transfer, output to DESTINATION is based on the exchange rate
+     */
+    uint64_t amount_in;
+    /**
+     * Minimum amount of DESTINATION token to output, prevents excessive slippage
+     */
+    uint64_t minimum_amount_out;
+} TokenSwap_Swap;
 
 /**
- * Initialized program details.
+ * DepositAllTokenTypes instruction data
  */
-typedef struct TokenSwap_SwapInfo {
+typedef struct TokenSwap_DepositAllTokenTypes {
     /**
-     * Token A
-     * The Liquidity token is issued against this value.
+     * Pool token amount to transfer. token_a and token_b amount are set by
+     * the current exchange rate and size of the pool
      */
-    TokenSwap_Pubkey token_a;
+    uint64_t pool_token_amount;
     /**
-     * Token B
+     * Maximum token A amount to deposit, prevents excessive slippage
      */
-    TokenSwap_Pubkey token_b;
+    uint64_t maximum_token_a_amount;
     /**
-     * Pool tokens are issued when A or B tokens are deposited.
-     * Pool tokens can be withdrawn back to the original A or B token.
+     * Maximum token B amount to deposit, prevents excessive slippage
      */
-    TokenSwap_Pubkey pool_mint;
+    uint64_t maximum_token_b_amount;
+} TokenSwap_DepositAllTokenTypes;
+
+/**
+ * WithdrawAllTokenTypes instruction data
+ */
+typedef struct TokenSwap_WithdrawAllTokenTypes {
+    /**
+     * Amount of pool tokens to burn. User receives an output of token a
+     * and b based on the percentage of the pool tokens that are returned.
+     */
+    uint64_t pool_token_amount;
+    /**
+     * Minimum amount of token A to receive, prevents excessive slippage
+     */
+    uint64_t minimum_token_a_amount;
     /**
-     * Fee applied to the input token amount prior to output calculation.
+     * Minimum amount of token B to receive, prevents excessive slippage
      */
-    TokenSwap_Fee fee;
-} TokenSwap_SwapInfo;
+    uint64_t minimum_token_b_amount;
+} TokenSwap_WithdrawAllTokenTypes;
 
 /**
- * Program states.
+ * Deposit one token type, exact amount in instruction data
  */
-typedef enum TokenSwap_State_Tag {
+typedef struct TokenSwap_DepositSingleTokenTypeExactAmountIn {
     /**
-     * Unallocated state, may be initialized into another state.
+     * Token amount to deposit
      */
-    Unallocated,
+    uint64_t source_token_amount;
     /**
-     * Initialized state.
+     * Pool token amount to receive in exchange. The amount is set by
+     * the current exchange rate and size of the pool
      */
-    Init,
-} TokenSwap_State_Tag;
+    uint64_t minimum_pool_token_amount;
+} TokenSwap_DepositSingleTokenTypeExactAmountIn;
 
-typedef struct TokenSwap_Init_Body {
-    TokenSwap_SwapInfo _0;
-} TokenSwap_Init_Body;
-
-typedef struct TokenSwap_State {
-    TokenSwap_State_Tag tag;
-    union {
-        TokenSwap_Init_Body init;
-    };
-} TokenSwap_State;
+/**
+ * WithdrawAllTokenTypes instruction data
+ */
+typedef struct TokenSwap_WithdrawSingleTokenTypeExactAmountOut {
+    /**
+     * Amount of token A or B to receive
+     */
+    uint64_t destination_token_amount;
+    /**
+     * Maximum amount of pool tokens to burn. User receives an output of token A
+     * or B based on the percentage of the pool tokens that are returned.
+     */
+    uint64_t maximum_pool_token_amount;
+} TokenSwap_WithdrawSingleTokenTypeExactAmountOut;
@@ -0,0 +1,228 @@
+#include "token-swap-quote.h"
+#include <criterion/criterion.h>
+#include <string.h>
+
+/// Constant product pool without fees
+static TokenSwap_Pool pool(uint64_t token_a_amount, uint64_t token_b_amount) {
+  TokenSwap_Pool pool = {token_a_amount, token_b_amount,
+                         TokenSwap_CurveType_ConstantProduct, 0,
+                         {0, 1, 0, 1}};
+  return pool;
+}
+
+/// Random value of up to `bits` bits, at least one
+static uint64_t random_u64(int bits) {
+  uint64_t value = (uint64_t)rand() << 62 ^ (uint64_t)rand() << 31 ^ rand();
+  value >>= 64 - bits;
+  return value == 0 ? 1 : value;
+}
+
+Test(token_swap_quote, minimum_fee) {
+  TokenSwap_u128 fee;
+  cr_assert(TokenSwap_calculate_fee(100, 1, 10000, &fee) && fee == 1);
+  cr_assert(TokenSwap_calculate_fee(100000, 25, 10000, &fee) && fee == 250);
+  cr_assert(TokenSwap_calculate_fee(0, 25, 10000, &fee) && fee == 0);
+  cr_assert(TokenSwap_calculate_fee(100, 0, 0, &fee) && fee == 0);
+  cr_assert(!TokenSwap_calculate_fee(100, 1, 0, &fee));
+
+  TokenSwap_Pool fees = pool(1000000, 1000000);
+  fees.fees = (TokenSwap_TradeFees){25, 10000, 5, 10000};
+  TokenSwap_Quote quote;
+  cr_assert(TokenSwap_quote(&fees, TokenSwap_TradeDirection_AtoB, 100, &quote));
+  cr_assert(quote.trade_fee == 1);
+  cr_assert(quote.owner_fee == 1);
+  // 98 traded: ceil(10^12 / 1000098) = 999903, which needs all of 1000098
+  cr_assert(quote.destination_amount_swapped == 97);
+  cr_assert(quote.source_amount_swapped == 100);
+  TokenSwap_TradeFees fees_too_high = {1, 1, 1, 1};
+  fees.fees = fees_too_high;
+  cr_assert(
+      !TokenSwap_quote(&fees, TokenSwap_TradeDirection_AtoB, 100, &quote));
+}
+
+/// `constant_product_swap_rounding` of the program's curve tests, each source
+/// amount, pool balances and expected source and destination swapped
+Test(token_swap_quote, ceiling_division) {
+  const uint64_t tests[][5] = {
+      {10, 4000000, 70000000000, 10, 174999},
+      {20, 30000 - 20, 10000, 18, 6},
+      {19, 30000 - 20, 10000, 18, 6},
+      {18, 30000 - 20, 10000, 18, 6},
+      {10, 20000, 30000, 10, 14},
+      {10, 20000 - 9, 30000, 10, 14},
+      {10, 20000 - 10, 30000, 10, 15},
+      {100, 60000, 30000, 99, 49},
+      {99, 60000, 30000, 99, 49},
+      {98, 60000, 30000, 97, 48},
+  };
+  for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+    TokenSwap_Pool a_to_b = pool(tests[i][1], tests[i][2]);
+    TokenSwap_Pool b_to_a = pool(tests[i][2], tests[i][1]);
+    TokenSwap_Quote quote;
+    cr_assert(TokenSwap_quote(&a_to_b, TokenSwap_TradeDirection_AtoB,
+                              tests[i][0], &quote));
+    cr_assert(quote.source_amount_swapped == tests[i][3]);
+    cr_assert(quote.destination_amount_swapped == tests[i][4]);
+    cr_assert(TokenSwap_quote(&b_to_a, TokenSwap_TradeDirection_BtoA,
+                              tests[i][0], &quote));
+    cr_assert(quote.source_amount_swapped == tests[i][3]);
+    cr_assert(quote.destination_amount_swapped == tests[i][4]);
+  }
+}
+
+Test(token_swap_quote, offset) {
+  TokenSwap_Pool offset = pool(1000, 0);
+  offset.curve_type = TokenSwap_CurveType_Offset;
+  offset.token_b_offset = 1000;
+  TokenSwap_Quote quote;
+  // Trades against 1000 B, but none of it is held
+  cr_assert(
+      !TokenSwap_quote(&offset, TokenSwap_TradeDirection_AtoB, 100, &quote));
+  // ceil(10^6 / 1100) = 910, then 910 needs 1099
+  cr_assert(
+      TokenSwap_quote(&offset, TokenSwap_TradeDirection_BtoA, 100, &quote));
+  cr_assert(quote.source_amount_swapped == 99);
+  cr_assert(quote.destination_amount_swapped == 90);
+
+  offset.token_b_amount = 500;
+  cr_assert(
+      TokenSwap_quote(&offset, TokenSwap_TradeDirection_AtoB, 100, &quote));
+  // ceil(1.5 * 10^6 / 1100) = 1364, then 1364 needs 1100
+  cr_assert(quote.source_amount_swapped == 100);
+  cr_assert(quote.destination_amount_swapped == 136);
+
+  offset.curve_type = TokenSwap_CurveType_Stable;
+  cr_assert(
+      !TokenSwap_quote(&offset, TokenSwap_TradeDirection_AtoB, 100, &quote));
+}
+
+Test(token_swap_quote, failures) {
+  TokenSwap_Quote quote;
+  TokenSwap_Quote zero = {0, 0, 0, 0};
+
+  // spot: 10 * 4m / 70b = 0
+  TokenSwap_Pool too_small = pool(70000000000, 4000000);
+  cr_assert(
+      !TokenSwap_quote(&too_small, TokenSwap_TradeDirection_AtoB, 10, &quote));
+  cr_assert(0 == memcmp(&quote, &zero, sizeof(quote)));
+  TokenSwap_Pool empty = pool(0, 1000);
+  cr_assert(
+      !TokenSwap_quote(&empty, TokenSwap_TradeDirection_AtoB, 10, &quote));
+
+  // The invariant (2^64 - 1) * (2^65 - 2) overflows 128 bits
+  TokenSwap_Pool overflow = pool(UINT64_MAX, UINT64_MAX);
+  overflow.curve_type = TokenSwap_CurveType_Offset;
+  overflow.token_b_offset = UINT64_MAX;
+  cr_assert(!TokenSwap_quote(&overflow, TokenSwap_TradeDirection_AtoB, 1000,
+                             &quote));
+  cr_assert(0 == memcmp(&quote, &zero, sizeof(quote)));
+  overflow.token_b_offset = 0;
+  cr_assert(TokenSwap_quote(&overflow, TokenSwap_TradeDirection_AtoB, 1000,
+                            &quote));
+  cr_assert(quote.destination_amount_swapped == 999);
+}
+
+/// Checks a quote against the constant product definition of the result:
+/// the largest destination amount, and the smallest source amount for it, that
+/// keep the invariant from decreasing
+static void check_constant_product(const TokenSwap_Pool *pool,
+                                   uint64_t amount_in) {
+  TokenSwap_u128 source = pool->token_a_amount;
+  TokenSwap_u128 destination = pool->token_b_amount;
+  TokenSwap_u128 invariant = source * destination;
+  TokenSwap_u128 fee, owner_fee;
+  cr_assert(TokenSwap_calculate_fee(amount_in, pool->fees.trade_fee_numerator,
+                                    pool->fees.trade_fee_denominator, &fee));
+  cr_assert(
+      TokenSwap_calculate_fee(amount_in, pool->fees.owner_trade_fee_numerator,
+                              pool->fees.owner_trade_fee_denominator,
+                              &owner_fee));
+
+  TokenSwap_Quote quote;
+  bool quoted =
+      TokenSwap_quote(pool, TokenSwap_TradeDirection_AtoB, amount_in, &quote);
+  if (fee + owner_fee > amount_in) {
+    cr_assert(!quoted);
+    return;
+  }
+  TokenSwap_u128 traded = source + amount_in - fee - owner_fee;
+  if (!quoted) {
+    // Only rejected if not even one token can be given out, or if the
+    // invariant divided by the new source amount truncates to zero
+    cr_assert((destination - 1) * traded < invariant || traded > invariant);
+    return;
+  }
+  cr_assert(quote.trade_fee == fee && quote.owner_fee == owner_fee);
+  cr_assert(traded <= invariant);
+  TokenSwap_u128 new_destination =
+      destination - quote.destination_amount_swapped;
+  TokenSwap_u128 new_source =
+      source + quote.source_amount_swapped - fee - owner_fee;
+  cr_assert(quote.destination_amount_swapped > 0);
+  cr_assert(new_source <= traded);
+  cr_assert(new_destination * new_source >= invariant);
+  cr_assert((new_destination - 1) * traded < invariant);
+  cr_assert(new_destination * (new_source - 1) < invariant);
+}
+
+Test(token_swap_quote, random_constant_product) {
+  for (int i = 0; i < 100000; i++) {
+    TokenSwap_Pool random = pool(random_u64(1 + rand() % 48),
+                                 random_u64(1 + rand() % 48));
+    random.fees = (TokenSwap_TradeFees){rand() % 50, 10000, rand() % 10, 1000};
+    check_constant_product(&random, random_u64(1 + rand() % 48));
+  }
+}
+
+/// Checks that quoting `amount_in` through `pools` column by column gives the
+/// destination amounts of quoting them one by one
+static void check_columns(const TokenSwap_Pool *pools, size_t len,
+                          TokenSwap_TradeDirection direction,
+                          uint64_t amount_in) {
+  uint64_t values[7][64];
+  TokenSwap_PoolColumns columns = {values[0], values[1], values[2], values[3],
+                                   values[4], values[5], values[6], len};
+  uint64_t destination_amounts[64];
+  size_t expected = 0;
+  for (size_t i = 0; i < len; i++) {
+    cr_assert(TokenSwap_PoolColumns_set(&columns, i, &pools[i]));
+  }
+  size_t succeeded = TokenSwap_quote_columns(&columns, direction, amount_in,
+                                             destination_amounts);
+  for (size_t i = 0; i < len; i++) {
+    TokenSwap_Quote quote;
+    expected += TokenSwap_quote(&pools[i], direction, amount_in, &quote);
+    cr_assert(destination_amounts[i] == quote.destination_amount_swapped);
+  }
+  cr_assert(succeeded == expected);
+}
+
+Test(token_swap_quote, columns_overflow) {
+  TokenSwap_Pool offset = pool(18407541808262783847u, 18432301747728000675u);
+  offset.curve_type = TokenSwap_CurveType_Offset;
+  offset.token_b_offset = 18381280872236233184u;
+  TokenSwap_Quote quote;
+  cr_assert(!TokenSwap_quote(&offset, TokenSwap_TradeDirection_BtoA,
+                             1971941038872412658, &quote));
+  check_columns(&offset, 1, TokenSwap_TradeDirection_BtoA,
+                1971941038872412658);
+}
+
+Test(token_swap_quote, random_columns) {
+  for (int i = 0; i < 20000; i++) {
+    TokenSwap_Pool pools[64];
+    size_t len = 1 + rand() % 64;
+    for (size_t j = 0; j < len; j++) {
+      pools[j] = pool(random_u64(1 + rand() % 64), random_u64(1 + rand() % 64));
+      if (rand() % 2) {
+        pools[j].curve_type = TokenSwap_CurveType_Offset;
+        pools[j].token_b_offset = rand() % 4 ? random_u64(1 + rand() % 64) : 0;
+      }
+      if (rand() % 4) {
+        pools[j].fees = (TokenSwap_TradeFees){rand() % 100, 1 + rand() % 10000,
+                                              rand() % 100, rand() % 10000};
+      }
+    }
+    check_columns(pools, len, rand() % 2, random_u64(1 + rand() % 64));
+  }
+}
@@ -0,0 +1,170 @@
+#include <stdlib.h>
+
+/// Fails every `realloc` once `reallocs_left` reaches zero, a negative count
+/// never failing
+static int reallocs_left = -1;
+
+static void *failing_realloc(void *items, size_t size) {
+  if (reallocs_left == 0) {
+    return NULL;
+  }
+  if (reallocs_left > 0) {
+    reallocs_left--;
+  }
+  return realloc(items, size);
+}
+
+#define realloc failing_realloc
+#include "token-swap-routes.h"
+#undef realloc
+
+#include <criterion/criterion.h>
+
+/// Address of account `kind` numbered `n`
+static void key(uint8_t *address, uint8_t kind, uint32_t n) {
+  memset(address, 0, 32);
+  address[0] = kind;
+  memcpy(address + 1, &n, sizeof(n));
+}
+
+/// Registers a constant product pool between mints `mint_a` and `mint_b`
+/// whose accounts are keyed by `n`
+static uint32_t add_pool(TokenSwap_Routes *routes, uint32_t n, uint32_t mint_a,
+                         uint32_t mint_b) {
+  uint8_t data[TokenSwap_SwapInfo_LEN];
+  uint8_t k[32];
+  memset(data, 0, sizeof(data));
+  TokenSwap_SwapInfo_set_version(data, 1);
+  TokenSwap_SwapInfo_set_is_initialized(data, true);
+  key(k, 'a', n);
+  TokenSwap_SwapInfo_set_token_a(data, k);
+  key(k, 'b', n);
+  TokenSwap_SwapInfo_set_token_b(data, k);
+  key(k, 'p', n);
+  TokenSwap_SwapInfo_set_pool_mint(data, k);
+  key(k, 'm', mint_a);
+  TokenSwap_SwapInfo_set_token_a_mint(data, k);
+  key(k, 'm', mint_b);
+  TokenSwap_SwapInfo_set_token_b_mint(data, k);
+  TokenSwap_SwapInfo_set_trade_fee_denominator(data, 1);
+  TokenSwap_SwapInfo_set_owner_trade_fee_denominator(data, 1);
+  TokenSwap_SwapInfo_set_curve_type(data, TokenSwap_CurveType_ConstantProduct);
+  uint32_t pool = UINT32_MAX;
+  key(k, 's', n);
+  cr_assert(TokenSwap_Routes_add_pool(routes, k, data, sizeof(data), &pool));
+  return pool;
+}
+
+/// Writes the balance of token account `side` of the pool keyed by `n`,
+/// returning how many routes that dirtied
+static size_t set_balance(TokenSwap_Routes *routes, uint8_t side, uint32_t n,
+                          uint64_t amount) {
+  uint8_t data[TokenSwap_Token_Account_LEN];
+  uint8_t address[32];
+  memset(data, 0, sizeof(data));
+  TokenSwap_write_u64(data + TokenSwap_Token_Account_amount_OFFSET, amount);
+  data[TokenSwap_Token_Account_state_OFFSET] = 1;
+  key(address, side, n);
+  return TokenSwap_Routes_update(routes, address, data, sizeof(data));
+}
+
+/// Three pools over mints 0 -> 1 -> 2, with balances
+static void setup(TokenSwap_Routes *routes) {
+  cr_assert(TokenSwap_Routes_init(routes));
+  for (uint32_t n = 0; n < 3; n++) {
+    cr_assert(n == add_pool(routes, n, n < 2 ? n : 0, n < 2 ? n + 1 : 2));
+    set_balance(routes, 'a', n, 1000000);
+    set_balance(routes, 'b', n, 2000000);
+  }
+}
+
+Test(token_swap_routes, only_routes_through_a_pool_are_dirtied) {
+  TokenSwap_Routes routes;
+  setup(&routes);
+  const TokenSwap_Hop first[] = {{0, TokenSwap_TradeDirection_AtoB},
+                                 {1, TokenSwap_TradeDirection_AtoB}};
+  const TokenSwap_Hop second[] = {{1, TokenSwap_TradeDirection_BtoA}};
+  const TokenSwap_Hop third[] = {{2, TokenSwap_TradeDirection_AtoB}};
+  uint32_t ids[3];
+  cr_assert(TokenSwap_Routes_add_route(&routes, first, 2, 1000, &ids[0]));
+  cr_assert(TokenSwap_Routes_add_route(&routes, second, 1, 1000, &ids[1]));
+  cr_assert(TokenSwap_Routes_add_route(&routes, third, 1, 1000, &ids[2]));
+  // Hops must chain mints
+  const TokenSwap_Hop broken[] = {{0, TokenSwap_TradeDirection_AtoB},
+                                  {2, TokenSwap_TradeDirection_AtoB}};
+  uint32_t unused;
+  cr_assert(!TokenSwap_Routes_add_route(&routes, broken, 2, 1000, &unused));
+  cr_assert(3 == TokenSwap_Routes_refresh(&routes, NULL));
+
+  uint64_t before = TokenSwap_Routes_quote(&routes, ids[0]);
+  cr_assert(before != 0);
+  cr_assert(1 == set_balance(&routes, 'a', 0, 2000000));
+  cr_assert(routes.routes[ids[0]].dirty);
+  cr_assert(!routes.routes[ids[1]].dirty && !routes.routes[ids[2]].dirty);
+  uint32_t refreshed[3];
+  cr_assert(1 == TokenSwap_Routes_refresh(&routes, refreshed));
+  cr_assert(refreshed[0] == ids[0]);
+  cr_assert(TokenSwap_Routes_quote(&routes, ids[0]) < before);
+
+  // Pool 1 holds two routes, each dirtied and queued once however often
+  cr_assert(2 == set_balance(&routes, 'b', 1, 3000000));
+  cr_assert(0 == set_balance(&routes, 'b', 1, 4000000));
+  cr_assert(2 == routes.queue_len);
+  cr_assert(2 == TokenSwap_Routes_refresh(&routes, NULL));
+  TokenSwap_Routes_free(&routes);
+}
+
+Test(token_swap_routes, unchanged_writes_dirty_nothing) {
+  TokenSwap_Routes routes;
+  setup(&routes);
+  const TokenSwap_Hop hops[] = {{0, TokenSwap_TradeDirection_AtoB}};
+  uint32_t route;
+  cr_assert(TokenSwap_Routes_add_route(&routes, hops, 1, 1000, &route));
+  cr_assert(1 == TokenSwap_Routes_refresh(&routes, NULL));
+
+  cr_assert(0 == set_balance(&routes, 'a', 0, 1000000));
+  cr_assert(0 == set_balance(&routes, 'b', 0, 2000000));
+  uint8_t mint[TokenSwap_Token_Mint_LEN] = {0};
+  mint[TokenSwap_Token_Mint_is_initialized_OFFSET] = 1;
+  TokenSwap_write_u64(mint + TokenSwap_Token_Mint_supply_OFFSET, 77);
+  uint8_t address[32];
+  key(address, 'p', 0);
+  cr_assert(0 == TokenSwap_Routes_update(&routes, address, mint, sizeof(mint)));
+  cr_assert(77 == routes.pools[0].pool_mint_supply);
+  key(address, 'x', 0);
+  cr_assert(0 == TokenSwap_Routes_update(&routes, address, mint, sizeof(mint)));
+  cr_assert(0 == routes.queue_len && !routes.routes[route].dirty);
+
+  // Closing a token account makes the pool unquotable
+  key(address, 'a', 0);
+  cr_assert(1 == TokenSwap_Routes_update(&routes, address, NULL, 0));
+  cr_assert(0 == TokenSwap_Routes_quote(&routes, route));
+  TokenSwap_Routes_free(&routes);
+}
+
+Test(token_swap_routes, failed_growth_rolls_back) {
+  TokenSwap_Routes routes;
+  setup(&routes);
+  const TokenSwap_Hop first[] = {{0, TokenSwap_TradeDirection_AtoB}};
+  const TokenSwap_Hop both[] = {{0, TokenSwap_TradeDirection_AtoB},
+                                {1, TokenSwap_TradeDirection_AtoB}};
+  uint32_t route;
+  cr_assert(TokenSwap_Routes_add_route(&routes, first, 1, 1000, &route));
+  cr_assert(1 == TokenSwap_Routes_refresh(&routes, NULL));
+
+  // The queue grows, pool 0 has room to list the route and pool 1 fails to
+  reallocs_left = 1;
+  cr_assert(!TokenSwap_Routes_add_route(&routes, both, 2, 1000, &route));
+  reallocs_left = -1;
+  cr_assert(1 == routes.routes_len);
+  cr_assert(1 == routes.pools[0].routes_len);
+  cr_assert(0 == routes.pools[1].routes_len);
+  cr_assert(1 == set_balance(&routes, 'a', 0, 5));
+
+  cr_assert(TokenSwap_Routes_add_route(&routes, both, 2, 1000, &route));
+  cr_assert(1 == route);
+  cr_assert(2 == routes.pools[0].routes_len);
+  cr_assert(1 == routes.pools[1].routes_len);
+  cr_assert(2 == TokenSwap_Routes_refresh(&routes, NULL));
+  TokenSwap_Routes_free(&routes);
+}
@@ -0,0 +1,567 @@
+/**
+ * @brief Batch derivation of program addresses, such as associated token
+ * accounts
+ *
+ * Computes what `Pubkey::create_program_address` and
+ * `Pubkey::find_program_address` compute, for many seed sets at once.  The
+ * SHA-256 of eight candidate addresses is computed in parallel, one per lane
+ * of GCC vector words that compile to SSE2 or, with `-mavx2`, AVX2
+ * instructions.  Checking that a candidate is not an ed25519 point takes one
+ * field exponentiation, more than its hash, so `TokenAddress_find_batch`
+ * also splits the batch across threads.
+ *
+ * The curve check mirrors curve25519-dalek's `CompressedEdwardsY::decompress`
+ * as used by the runtime: the sign bit is ignored and `y` need not be
+ * canonical, and an address is a point exactly when `(y^2 - 1) / (d y^2 + 1)`
+ * is a square.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "spl-pubkey.h"
+
+/// Limits checked by `create_program_address`, the bump seed included
+#define TokenAddress_MAX_SEEDS 16
+#define TokenAddress_MAX_SEED_LEN 32
+
+/// Addresses hashed in parallel
+#define TokenAddress_LANES 8
+
+/// Blocks of the longest message, every seed and the bump, program id and
+/// marker, padded
+#define TokenAddress_MAX_BLOCKS                                                \
+  (((TokenAddress_MAX_SEEDS - 1) * TokenAddress_MAX_SEED_LEN + 1 + 32 + 21 +   \
+    9 + 63) /                                                                  \
+   64)
+
+/// Seed sets claimed by a thread at a time
+#define TokenAddress_DEFAULT_CHUNK_LEN 1024
+
+static const char TokenAddress_MARKER[] = "ProgramDerivedAddress";
+
+/// `TokenkegQfeZyiNwAJbNbGKPFXCWuBvf9Ss623VQ5DA`
+static const uint8_t TokenAddress_TOKEN_PROGRAM_ID[32] = {
+    6,   221, 246, 225, 215, 101, 161, 147, 217, 203, 225,
+    70,  206, 235, 121, 172, 28,  180, 133, 237, 95,  91,
+    55,  145, 58,  140, 245, 133, 126, 255, 0,   169};
+
+/// `ATokenGPvbdGVxr1b2hvZbsiqW5xWH25efTNsLJA8knL`
+static const uint8_t TokenAddress_ASSOCIATED_TOKEN_PROGRAM_ID[32] = {
+    140, 151, 37,  143, 78,  36,  137, 241, 187, 61,  16,
+    41,  20,  142, 13,  131, 11,  90,  19,  153, 218, 255,
+    16,  132, 4,   142, 123, 216, 219, 233, 248, 89};
+
+typedef struct TokenAddress_Seed {
+  const uint8_t *addr;
+  uint64_t len;
+} TokenAddress_Seed;
+
+/// Seeds of one address, without the bump seed
+typedef struct TokenAddress_Seeds {
+  const TokenAddress_Seed *seeds;
+  uint64_t len;
+} TokenAddress_Seeds;
+
+/// Eight 32-bit words, one per lane
+typedef uint32_t TokenAddress_Words
+    __attribute__((vector_size(4 * TokenAddress_LANES)));
+
+static const uint32_t TokenAddress_SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static const uint32_t TokenAddress_SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+/// Padded message of each lane
+typedef struct TokenAddress_Messages {
+  uint8_t bytes[TokenAddress_LANES][TokenAddress_MAX_BLOCKS * 64];
+  /// Blocks of each lane, zero for an unused lane
+  uint32_t blocks[TokenAddress_LANES];
+} TokenAddress_Messages;
+
+/// Writes the padded message hashed for `seeds` and `bump` to `message`,
+/// returning its blocks, or zero if `create_program_address` rejects the
+/// seeds
+static inline uint32_t TokenAddress_message(uint8_t *message,
+                                            const TokenAddress_Seeds *seeds,
+                                            uint8_t bump,
+                                            const uint8_t *program_id) {
+  if (seeds->len >= TokenAddress_MAX_SEEDS) {
+    return 0;
+  }
+  uint64_t len = 0;
+  for (uint64_t i = 0; i < seeds->len; i++) {
+    if (seeds->seeds[i].len > TokenAddress_MAX_SEED_LEN) {
+      return 0;
+    }
+    memcpy(message + len, seeds->seeds[i].addr, seeds->seeds[i].len);
+    len += seeds->seeds[i].len;
+  }
+  message[len++] = bump;
+  memcpy(message + len, program_id, 32);
+  len += 32;
+  memcpy(message + len, TokenAddress_MARKER, sizeof(TokenAddress_MARKER) - 1);
+  len += sizeof(TokenAddress_MARKER) - 1;
+
+  uint32_t blocks = (uint32_t)((len + 9 + 63) / 64);
+  uint64_t bits = len * 8;
+  message[len] = 0x80;
+  memset(message + len + 1, 0, blocks * 64 - len - 1);
+  for (int i = 0; i < 8; i++) {
+    message[blocks * 64 - 1 - i] = (uint8_t)(bits >> (8 * i));
+  }
+  return blocks;
+}
+
+/// Rotates every lane of `x` right, a macro as passing vector words by value
+/// depends on the enabled instruction set
+#define TokenAddress_ROTR(x, n) ((x) >> (n) | (x) << (32 - (n)))
+
+/// Hashes the message of every lane, lanes with fewer blocks keeping their
+/// state while the longer ones are hashed
+static inline void
+TokenAddress_sha256_lanes(const TokenAddress_Messages *messages,
+                          uint8_t (*digests)[32]) {
+  TokenAddress_Words state[8];
+  uint32_t most = 0;
+  for (int lane = 0; lane < TokenAddress_LANES; lane++) {
+    most = messages->blocks[lane] > most ? messages->blocks[lane] : most;
+  }
+  for (int i = 0; i < 8; i++) {
+    for (int lane = 0; lane < TokenAddress_LANES; lane++) {
+      state[i][lane] = TokenAddress_SHA256_IV[i];
+    }
+  }
+
+  for (uint32_t block = 0; block < most; block++) {
+    TokenAddress_Words w[16];
+    TokenAddress_Words active;
+    for (int lane = 0; lane < TokenAddress_LANES; lane++) {
+      const uint8_t *bytes = messages->bytes[lane] + 64 * block;
+      for (int t = 0; t < 16; t++) {
+        w[t][lane] = (uint32_t)bytes[4 * t] << 24 |
+                     (uint32_t)bytes[4 * t + 1] << 16 |
+                     (uint32_t)bytes[4 * t + 2] << 8 | bytes[4 * t + 3];
+      }
+      active[lane] = block < messages->blocks[lane] ? UINT32_MAX : 0;
+    }
+
+    TokenAddress_Words a = state[0], b = state[1], c = state[2],
+                       d = state[3], e = state[4], f = state[5],
+                       g = state[6], h = state[7];
+    for (int t = 0; t < 64; t++) {
+      if (t >= 16) {
+        TokenAddress_Words w15 = w[(t - 15) & 15];
+        TokenAddress_Words w2 = w[(t - 2) & 15];
+        TokenAddress_Words s0 = TokenAddress_ROTR(w15, 7) ^
+                                TokenAddress_ROTR(w15, 18) ^ (w15 >> 3);
+        TokenAddress_Words s1 = TokenAddress_ROTR(w2, 17) ^
+                                TokenAddress_ROTR(w2, 19) ^ (w2 >> 10);
+        w[t & 15] += s0 + w[(t - 7) & 15] + s1;
+      }
+      TokenAddress_Words s1 = TokenAddress_ROTR(e, 6) ^
+                              TokenAddress_ROTR(e, 11) ^
+                              TokenAddress_ROTR(e, 25);
+      TokenAddress_Words ch = (e & f) ^ (~e & g);
+      TokenAddress_Words t1 =
+          h + s1 + ch + TokenAddress_SHA256_K[t] + w[t & 15];
+      TokenAddress_Words s0 = TokenAddress_ROTR(a, 2) ^
+                              TokenAddress_ROTR(a, 13) ^
+                              TokenAddress_ROTR(a, 22);
+      TokenAddress_Words maj = (a & b) ^ (a & c) ^ (b & c);
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + s0 + maj;
+    }
+    state[0] += a & active;
+    state[1] += b & active;
+    state[2] += c & active;
+    state[3] += d & active;
+    state[4] += e & active;
+    state[5] += f & active;
+    state[6] += g & active;
+    state[7] += h & active;
+  }
+
+  for (int lane = 0; lane < TokenAddress_LANES; lane++) {
+    for (int i = 0; i < 8; i++) {
+      uint32_t word = state[i][lane];
+      digests[lane][4 * i] = (uint8_t)(word >> 24);
+      digests[lane][4 * i + 1] = (uint8_t)(word >> 16);
+      digests[lane][4 * i + 2] = (uint8_t)(word >> 8);
+      digests[lane][4 * i + 3] = (uint8_t)word;
+    }
+  }
+}
+
+typedef unsigned __int128 TokenAddress_u128;
+
+/// Element of the field modulo 2^255 - 19 in five 51-bit limbs, which may
+/// exceed 51 bits between operations
+typedef struct TokenAddress_Fe {
+  uint64_t v[5];
+} TokenAddress_Fe;
+
+#define TokenAddress_MASK51 ((UINT64_C(1) << 51) - 1)
+
+/// Edwards `d`, -121665/121666
+static const TokenAddress_Fe TokenAddress_D = {
+    {929955233495203, 466365720129213, 1662059464998953, 2033849074728123,
+     1442794654840575}};
+
+/// Carries the limbs of a product into a field element
+static inline TokenAddress_Fe TokenAddress_fe_carry(TokenAddress_u128 r[5]) {
+  TokenAddress_Fe h;
+  r[1] += (uint64_t)(r[0] >> 51);
+  h.v[0] = (uint64_t)r[0] & TokenAddress_MASK51;
+  r[2] += (uint64_t)(r[1] >> 51);
+  h.v[1] = (uint64_t)r[1] & TokenAddress_MASK51;
+  r[3] += (uint64_t)(r[2] >> 51);
+  h.v[2] = (uint64_t)r[2] & TokenAddress_MASK51;
+  r[4] += (uint64_t)(r[3] >> 51);
+  h.v[3] = (uint64_t)r[3] & TokenAddress_MASK51;
+  uint64_t carry = (uint64_t)(r[4] >> 51);
+  h.v[4] = (uint64_t)r[4] & TokenAddress_MASK51;
+  h.v[0] += carry * 19;
+  h.v[1] += h.v[0] >> 51;
+  h.v[0] &= TokenAddress_MASK51;
+  return h;
+}
+
+static inline TokenAddress_Fe TokenAddress_fe_mul(const TokenAddress_Fe *f,
+                                                  const TokenAddress_Fe *g) {
+  const uint64_t *a = f->v;
+  const uint64_t *b = g->v;
+  uint64_t b1 = 19 * b[1], b2 = 19 * b[2], b3 = 19 * b[3], b4 = 19 * b[4];
+  TokenAddress_u128 r[5];
+  r[0] = (TokenAddress_u128)a[0] * b[0] + (TokenAddress_u128)a[1] * b4 +
+         (TokenAddress_u128)a[2] * b3 + (TokenAddress_u128)a[3] * b2 +
+         (TokenAddress_u128)a[4] * b1;
+  r[1] = (TokenAddress_u128)a[0] * b[1] + (TokenAddress_u128)a[1] * b[0] +
+         (TokenAddress_u128)a[2] * b4 + (TokenAddress_u128)a[3] * b3 +
+         (TokenAddress_u128)a[4] * b2;
+  r[2] = (TokenAddress_u128)a[0] * b[2] + (TokenAddress_u128)a[1] * b[1] +
+         (TokenAddress_u128)a[2] * b[0] + (TokenAddress_u128)a[3] * b4 +
+         (TokenAddress_u128)a[4] * b3;
+  r[3] = (TokenAddress_u128)a[0] * b[3] + (TokenAddress_u128)a[1] * b[2] +
+         (TokenAddress_u128)a[2] * b[1] + (TokenAddress_u128)a[3] * b[0] +
+         (TokenAddress_u128)a[4] * b4;
+  r[4] = (TokenAddress_u128)a[0] * b[4] + (TokenAddress_u128)a[1] * b[3] +
+         (TokenAddress_u128)a[2] * b[2] + (TokenAddress_u128)a[3] * b[1] +
+         (TokenAddress_u128)a[4] * b[0];
+  return TokenAddress_fe_carry(r);
+}
+
+/// Squares `f` `n` times
+static inline TokenAddress_Fe TokenAddress_fe_sq(TokenAddress_Fe f, int n) {
+  for (int i = 0; i < n; i++) {
+    const uint64_t *a = f.v;
+    uint64_t a0 = 2 * a[0], a1 = 2 * a[1], a3_19 = 19 * a[3],
+             a4_19 = 19 * a[4];
+    TokenAddress_u128 r[5];
+    r[0] = (TokenAddress_u128)a[0] * a[0] + (TokenAddress_u128)a1 * a4_19 +
+           (TokenAddress_u128)(2 * a[2]) * a3_19;
+    r[1] = (TokenAddress_u128)a0 * a[1] +
+           (TokenAddress_u128)(2 * a[2]) * a4_19 +
+           (TokenAddress_u128)a[3] * a3_19;
+    r[2] = (TokenAddress_u128)a0 * a[2] + (TokenAddress_u128)a[1] * a[1] +
+           (TokenAddress_u128)(2 * a[3]) * a4_19;
+    r[3] = (TokenAddress_u128)a0 * a[3] + (TokenAddress_u128)a1 * a[2] +
+           (TokenAddress_u128)a[4] * a4_19;
+    r[4] = (TokenAddress_u128)a0 * a[4] + (TokenAddress_u128)a1 * a[3] +
+           (TokenAddress_u128)a[2] * a[2];
+    f = TokenAddress_fe_carry(r);
+  }
+  return f;
+}
+
+/// Reduces `f` to its canonical limbs
+static inline TokenAddress_Fe TokenAddress_fe_reduce(TokenAddress_Fe f) {
+  TokenAddress_u128 r[5] = {f.v[0], f.v[1], f.v[2], f.v[3], f.v[4]};
+  f = TokenAddress_fe_carry(r);
+  // Adding 19 carries out of bit 255 exactly when f >= p
+  uint64_t q = (f.v[0] + 19) >> 51;
+  q = (f.v[1] + q) >> 51;
+  q = (f.v[2] + q) >> 51;
+  q = (f.v[3] + q) >> 51;
+  q = (f.v[4] + q) >> 51;
+  f.v[0] += 19 * q;
+  for (int i = 0; i < 4; i++) {
+    f.v[i + 1] += f.v[i] >> 51;
+    f.v[i] &= TokenAddress_MASK51;
+  }
+  f.v[4] &= TokenAddress_MASK51;
+  return f;
+}
+
+/// `z^(2^252 - 3)`
+static inline TokenAddress_Fe
+TokenAddress_fe_pow22523(const TokenAddress_Fe *z) {
+  TokenAddress_Fe t0 = TokenAddress_fe_sq(*z, 1);
+  TokenAddress_Fe t1 = TokenAddress_fe_sq(t0, 2);
+  t1 = TokenAddress_fe_mul(z, &t1);
+  t0 = TokenAddress_fe_mul(&t0, &t1);
+  t0 = TokenAddress_fe_sq(t0, 1);
+  t0 = TokenAddress_fe_mul(&t1, &t0);
+  t1 = TokenAddress_fe_sq(t0, 5);
+  t0 = TokenAddress_fe_mul(&t1, &t0);
+  t1 = TokenAddress_fe_sq(t0, 10);
+  t1 = TokenAddress_fe_mul(&t1, &t0);
+  TokenAddress_Fe t2 = TokenAddress_fe_sq(t1, 20);
+  t1 = TokenAddress_fe_mul(&t2, &t1);
+  t1 = TokenAddress_fe_sq(t1, 10);
+  t0 = TokenAddress_fe_mul(&t1, &t0);
+  t1 = TokenAddress_fe_sq(t0, 50);
+  t1 = TokenAddress_fe_mul(&t1, &t0);
+  t2 = TokenAddress_fe_sq(t1, 100);
+  t1 = TokenAddress_fe_mul(&t2, &t1);
+  t1 = TokenAddress_fe_sq(t1, 50);
+  t0 = TokenAddress_fe_mul(&t1, &t0);
+  t0 = TokenAddress_fe_sq(t0, 2);
+  return TokenAddress_fe_mul(&t0, z);
+}
+
+/// Returns whether `key` decompresses to an ed25519 point, in which case it
+/// is never a program address
+static inline bool TokenAddress_is_on_curve(const uint8_t *key) {
+  SplPubkey_Words words = SplPubkey_load(key);
+  TokenAddress_Fe y = {{
+      words.x[0] & TokenAddress_MASK51,
+      (words.x[0] >> 51 | words.x[1] << 13) & TokenAddress_MASK51,
+      (words.x[1] >> 38 | words.x[2] << 26) & TokenAddress_MASK51,
+      (words.x[2] >> 25 | words.x[3] << 39) & TokenAddress_MASK51,
+      (words.x[3] >> 12) & TokenAddress_MASK51,
+  }};
+  TokenAddress_Fe y2 = TokenAddress_fe_sq(y, 1);
+  // u = y^2 - 1, plus 2p to stay positive, and v = d y^2 + 1
+  TokenAddress_Fe u = {
+      {y2.v[0] + 0xfffffffffffda - 1, y2.v[1] + 0xffffffffffffe,
+       y2.v[2] + 0xffffffffffffe, y2.v[3] + 0xffffffffffffe,
+       y2.v[4] + 0xffffffffffffe}};
+  TokenAddress_Fe v = TokenAddress_fe_mul(&TokenAddress_D, &y2);
+  v.v[0] += 1;
+  // u / v is a square exactly when u v is, v never being zero.  By Euler's
+  // criterion (u v)^((p - 1) / 2) is then 0 or 1 rather than -1, and
+  // (p - 1) / 2 = 4 (2^252 - 3) + 2.
+  TokenAddress_Fe w = TokenAddress_fe_mul(&u, &v);
+  TokenAddress_Fe t = TokenAddress_fe_pow22523(&w);
+  t = TokenAddress_fe_sq(t, 2);
+  TokenAddress_Fe w2 = TokenAddress_fe_sq(w, 1);
+  t = TokenAddress_fe_reduce(TokenAddress_fe_mul(&t, &w2));
+  return (t.v[0] | t.v[1] | t.v[2] | t.v[3] | t.v[4]) == 0 ||
+         ((t.v[0] ^ 1) | t.v[1] | t.v[2] | t.v[3] | t.v[4]) == 0;
+}
+
+/**
+ * `Pubkey::create_program_address` of `seeds` followed by the one-byte
+ * `bump` seed, returning `false` if the seeds are rejected or the address is
+ * on the curve
+ */
+static inline bool TokenAddress_create(const TokenAddress_Seeds *seeds,
+                                       uint8_t bump, const uint8_t *program_id,
+                                       uint8_t *address) {
+  TokenAddress_Messages messages;
+  uint8_t digests[TokenAddress_LANES][32];
+  memset(&messages, 0, sizeof(messages));
+  messages.blocks[0] =
+      TokenAddress_message(messages.bytes[0], seeds, bump, program_id);
+  if (messages.blocks[0] == 0) {
+    return false;
+  }
+  TokenAddress_sha256_lanes(&messages, digests);
+  if (TokenAddress_is_on_curve(digests[0])) {
+    return false;
+  }
+  memcpy(address, digests[0], 32);
+  return true;
+}
+
+/**
+ * `Pubkey::find_program_address` of every one of `count` seed sets, storing
+ * each address and bump seed to `addresses` and `bumps`, and returning how
+ * many were found
+ *
+ * Each seed set is tried with bump seeds from 255 down to 1.  A seed set
+ * that is rejected or has no address gets a bump of zero, which is never a
+ * bump that is found.
+ */
+static inline uint64_t TokenAddress_find_lanes(const TokenAddress_Seeds *seeds,
+                                               uint64_t count,
+                                               const uint8_t *program_id,
+                                               uint8_t (*addresses)[32],
+                                               uint8_t *bumps) {
+  TokenAddress_Messages messages;
+  uint8_t digests[TokenAddress_LANES][32];
+  // Seed set and bump of each lane
+  uint64_t items[TokenAddress_LANES];
+  uint8_t lane_bumps[TokenAddress_LANES];
+  memset(&messages, 0, sizeof(messages));
+  uint64_t next = 0;
+  uint64_t found = 0;
+  int active = 0;
+  for (;;) {
+    for (int lane = 0; lane < TokenAddress_LANES; lane++) {
+      while (messages.blocks[lane] == 0 && next < count) {
+        items[lane] = next;
+        lane_bumps[lane] = 255;
+        messages.blocks[lane] = TokenAddress_message(
+            messages.bytes[lane], &seeds[next], 255, program_id);
+        if (messages.blocks[lane] == 0) {
+          memset(addresses[next], 0, 32);
+          bumps[next] = 0;
+        } else {
+          active++;
+        }
+        next++;
+      }
+    }
+    if (active == 0) {
+      return found;
+    }
+    TokenAddress_sha256_lanes(&messages, digests);
+    for (int lane = 0; lane < TokenAddress_LANES; lane++) {
+      if (messages.blocks[lane] == 0) {
+        continue;
+      }
+      uint64_t item = items[lane];
+      if (!TokenAddress_is_on_curve(digests[lane])) {
+        memcpy(addresses[item], digests[lane], 32);
+        bumps[item] = lane_bumps[lane];
+        found++;
+      } else if (lane_bumps[lane] > 1) {
+        messages.blocks[lane] = TokenAddress_message(
+            messages.bytes[lane], &seeds[item], --lane_bumps[lane],
+            program_id);
+        continue;
+      } else {
+        memset(addresses[item], 0, 32);
+        bumps[item] = 0;
+      }
+      messages.blocks[lane] = 0;
+      active--;
+    }
+  }
+}
+
+/// Work shared by the threads of a batch
+typedef struct TokenAddress_Job {
+  const TokenAddress_Seeds *seeds;
+  uint64_t count;
+  const uint8_t *program_id;
+  uint8_t (*addresses)[32];
+  uint8_t *bumps;
+  uint64_t chunk_len;
+  atomic_uint_fast64_t next_chunk;
+  atomic_uint_fast64_t found;
+} TokenAddress_Job;
+
+static inline void *TokenAddress_work(void *argument) {
+  TokenAddress_Job *job = (TokenAddress_Job *)argument;
+  uint64_t chunks = (job->count + job->chunk_len - 1) / job->chunk_len;
+  for (;;) {
+    uint64_t chunk = atomic_fetch_add(&job->next_chunk, 1);
+    if (chunk >= chunks) {
+      break;
+    }
+    uint64_t first = chunk * job->chunk_len;
+    uint64_t len = job->count - first < job->chunk_len ? job->count - first
+                                                      : job->chunk_len;
+    atomic_fetch_add(&job->found,
+                     TokenAddress_find_lanes(job->seeds + first, len,
+                                             job->program_id,
+                                             job->addresses + first,
+                                             job->bumps + first));
+  }
+  return NULL;
+}
+
+/**
+ * Finds the addresses of `count` seed sets like `TokenAddress_find_lanes`,
+ * on `threads` threads, the calling thread being one of them
+ *
+ * Every seed set is derived even if some threads cannot be started.
+ */
+static inline uint64_t TokenAddress_find_batch(const TokenAddress_Seeds *seeds,
+                                               uint64_t count,
+                                               const uint8_t *program_id,
+                                               uint8_t (*addresses)[32],
+                                               uint8_t *bumps, int threads) {
+  TokenAddress_Job job;
+  job.seeds = seeds;
+  job.count = count;
+  job.program_id = program_id;
+  job.addresses = addresses;
+  job.bumps = bumps;
+  job.chunk_len = TokenAddress_DEFAULT_CHUNK_LEN;
+  atomic_init(&job.next_chunk, 0);
+  atomic_init(&job.found, 0);
+
+  threads = threads < 1 ? 1 : threads;
+  pthread_t *workers = (pthread_t *)calloc(threads, sizeof(*workers));
+  int started = 0;
+  for (; workers != NULL && started < threads - 1; started++) {
+    if (pthread_create(&workers[started], NULL, TokenAddress_work, &job) !=
+        0) {
+      break;
+    }
+  }
+  TokenAddress_work(&job);
+  for (int i = 0; i < started; i++) {
+    pthread_join(workers[i], NULL);
+  }
+  free(workers);
+  return atomic_load(&job.found);
+}
+
+/**
+ * Finds the associated token account of each of `count` wallets for the
+ * mint of the same index, as `get_associated_token_address` does, returning
+ * how many were found
+ */
+static inline uint64_t TokenAddress_associated_batch(
+    const uint8_t (*wallets)[32], const uint8_t (*mints)[32], uint64_t count,
+    uint8_t (*addresses)[32], uint8_t *bumps, int threads) {
+  TokenAddress_Seed *seed_list =
+      (TokenAddress_Seed *)malloc(3 * count * sizeof(*seed_list));
+  TokenAddress_Seeds *seeds =
+      (TokenAddress_Seeds *)malloc(count * sizeof(*seeds));
+  if (count > 0 && (seed_list == NULL || seeds == NULL)) {
+    free(seed_list);
+    free(seeds);
+    return 0;
+  }
+  for (uint64_t i = 0; i < count; i++) {
+    seed_list[3 * i] = (TokenAddress_Seed){wallets[i], 32};
+    seed_list[3 * i + 1] =
+        (TokenAddress_Seed){TokenAddress_TOKEN_PROGRAM_ID, 32};
+    seed_list[3 * i + 2] = (TokenAddress_Seed){mints[i], 32};
+    seeds[i] = (TokenAddress_Seeds){&seed_list[3 * i], 3};
+  }
+  uint64_t found =
+      TokenAddress_find_batch(seeds, count,
+                              TokenAddress_ASSOCIATED_TOKEN_PROGRAM_ID,
+                              addresses, bumps, threads);
+  free(seeds);
+  free(seed_list);
+  return found;
+}
@@ -0,0 +1,260 @@
+/**
+ * @brief Lock-free cache of packed token accounts, one writer and many readers
+ *
+ * An ingestion thread writes each account update in place while any number of
+ * query threads read balances.  Every entry is guarded by a sequence lock: the
+ * writer makes the sequence odd, stores the record and makes it even again,
+ * and a reader retries a copy whose sequence was odd or changed under it.
+ * Readers therefore never block the writer and never see a torn record, and
+ * the writer never waits for readers.
+ *
+ * Records are stored as relaxed atomic words so that these racing copies are
+ * well defined C11.  The table has a fixed capacity and never moves entries,
+ * and an address keeps its entry once written, a closed account being marked
+ * absent, so readers need no memory reclamation.
+ *
+ * Slots are found by a hash keyed by a random seed drawn for each cache, see
+ * `token-hash.h`, so addresses ground to collide cannot lengthen the probe
+ * runs every reader copies a record for.
+ */
+#pragma once
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "spl-pubkey.h"
+#include "token-hash.h"
+#include "token-layout.h"
+
+/// Words of packed account data, rounded up
+#define TokenCache_DATA_WORDS ((Token_Account_LEN + 7) / 8)
+
+typedef enum TokenCache_Result {
+  /// The entry now holds the write
+  TokenCache_Result_Updated,
+  /// The entry already holds a later slot, the write was ignored
+  TokenCache_Result_Stale,
+  /// The address is new and the cache has no room for it
+  TokenCache_Result_Full,
+} TokenCache_Result;
+
+/// Words of an entry guarded by its sequence
+typedef struct TokenCache_Record {
+  uint64_t address[4];
+  uint64_t slot;
+  /// Zero once the account is closed or no longer a token account
+  uint64_t present;
+  uint64_t data[TokenCache_DATA_WORDS];
+} TokenCache_Record;
+
+#define TokenCache_RECORD_WORDS (sizeof(TokenCache_Record) / 8)
+
+/// Cache line aligned so that writes to one entry do not disturb readers of
+/// its neighbours more than necessary
+typedef struct TokenCache_Entry {
+  _Alignas(64) _Atomic uint64_t sequence;
+  _Atomic uint64_t words[TokenCache_RECORD_WORDS];
+} TokenCache_Entry;
+
+typedef struct TokenCache {
+  TokenCache_Entry *entries;
+  /// Power of two, twice the number of accounts the cache was sized for
+  size_t capacity;
+  /// Entries in use, written only by the writer
+  size_t len;
+  /// Random key of the hash placing addresses
+  TokenHash_Seed seed;
+} TokenCache;
+
+/// Balance fields of an account
+typedef struct TokenCache_Balance {
+  uint64_t slot;
+  uint64_t amount;
+  uint64_t delegated_amount;
+  Token_AccountState state;
+} TokenCache_Balance;
+
+/// Initializes an empty cache with room for `accounts` addresses, failing if
+/// no seed could be drawn from the system's entropy source
+static inline bool TokenCache_init(TokenCache *cache, size_t accounts) {
+  if (!TokenHash_Seed_init(&cache->seed)) {
+    return false;
+  }
+  size_t power = 16;
+  while (power < 2 * accounts) {
+    power *= 2;
+  }
+  cache->entries = (TokenCache_Entry *)aligned_alloc(
+      _Alignof(TokenCache_Entry), power * sizeof(TokenCache_Entry));
+  if (cache->entries == NULL) {
+    return false;
+  }
+  for (size_t i = 0; i < power; i++) {
+    atomic_init(&cache->entries[i].sequence, 0);
+    for (size_t w = 0; w < TokenCache_RECORD_WORDS; w++) {
+      atomic_init(&cache->entries[i].words[w], 0);
+    }
+  }
+  cache->capacity = power;
+  cache->len = 0;
+  return true;
+}
+
+/// Frees the cache once no thread uses it
+static inline void TokenCache_free(TokenCache *cache) {
+  free(cache->entries);
+  cache->entries = NULL;
+  cache->capacity = 0;
+  cache->len = 0;
+}
+
+/**
+ * Copies the record of `entry` consistently, returning `false` if the entry
+ * has never been written
+ */
+static inline bool TokenCache_Entry_load(const TokenCache_Entry *entry,
+                                         TokenCache_Record *record) {
+  uint64_t words[TokenCache_RECORD_WORDS];
+  for (;;) {
+    uint64_t before = atomic_load_explicit(
+        (_Atomic uint64_t *)&entry->sequence, memory_order_acquire);
+    if (before == 0) {
+      return false;
+    }
+    if (before & 1) {
+      continue;
+    }
+    for (size_t w = 0; w < TokenCache_RECORD_WORDS; w++) {
+      words[w] = atomic_load_explicit(
+          (_Atomic uint64_t *)&entry->words[w], memory_order_relaxed);
+    }
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t after = atomic_load_explicit(
+        (_Atomic uint64_t *)&entry->sequence, memory_order_relaxed);
+    if (before == after) {
+      memcpy(record, words, sizeof(*record));
+      return true;
+    }
+  }
+}
+
+/**
+ * Copies the packed data of the account at `address` to `data`, of
+ * `Token_Account_LEN` bytes, and the slot it was written for to `slot`
+ *
+ * Safe on any thread concurrently with the writer.  Returns `false` if the
+ * account is not cached or is closed.
+ */
+static inline bool TokenCache_read(const TokenCache *cache,
+                                   const uint8_t *address, uint8_t *data,
+                                   uint64_t *slot) {
+  size_t mask = cache->capacity - 1;
+  size_t index = TokenHash_pubkey(&cache->seed, address, 0) & mask;
+  for (size_t probes = 0; probes < cache->capacity; probes++) {
+    TokenCache_Record record;
+    if (!TokenCache_Entry_load(&cache->entries[index], &record)) {
+      return false;
+    }
+    if (SplPubkey_eq((const uint8_t *)record.address, address)) {
+      if (!record.present) {
+        return false;
+      }
+      memcpy(data, record.data, Token_Account_LEN);
+      *slot = record.slot;
+      return true;
+    }
+    index = (index + 1) & mask;
+  }
+  return false;
+}
+
+/// Reads the balance fields of the account at `address`, like
+/// `TokenCache_read`
+static inline bool TokenCache_balance(const TokenCache *cache,
+                                      const uint8_t *address,
+                                      TokenCache_Balance *balance) {
+  uint8_t data[Token_Account_LEN];
+  if (!TokenCache_read(cache, address, data, &balance->slot)) {
+    return false;
+  }
+  balance->amount = Token_Account_get_amount(data);
+  balance->delegated_amount = Token_Account_get_delegated_amount(data);
+  balance->state = Token_Account_get_state(data);
+  return true;
+}
+
+/// Returns the entry of `address` or the empty entry where it belongs, or
+/// `NULL` if the table is full.  Writer only.
+static inline TokenCache_Entry *TokenCache_entry(TokenCache *cache,
+                                                 const uint8_t *address) {
+  size_t mask = cache->capacity - 1;
+  size_t index = TokenHash_pubkey(&cache->seed, address, 0) & mask;
+  for (size_t probes = 0; probes < cache->capacity; probes++) {
+    TokenCache_Entry *entry = &cache->entries[index];
+    // No other thread writes, so the words can be read without the lock
+    if (atomic_load_explicit(&entry->sequence, memory_order_relaxed) == 0) {
+      return entry;
+    }
+    uint64_t key[4];
+    for (size_t w = 0; w < 4; w++) {
+      key[w] = atomic_load_explicit(&entry->words[w], memory_order_relaxed);
+    }
+    if (SplPubkey_eq((const uint8_t *)key, address)) {
+      return entry;
+    }
+    index = (index + 1) & mask;
+  }
+  return NULL;
+}
+
+/**
+ * Writes the account at `address` as of `slot`, from the writer thread only
+ *
+ * `data` that is not an initialized token account marks the account absent.
+ * A write for an earlier slot than the cached one is ignored, so replayed or
+ * reordered updates cannot roll an account back.  A new address fails once
+ * the cache holds as many accounts as it was sized for.
+ */
+static inline TokenCache_Result TokenCache_write(TokenCache *cache,
+                                                 const uint8_t *address,
+                                                 uint64_t slot,
+                                                 const uint8_t *data,
+                                                 uint64_t data_len) {
+  TokenCache_Entry *entry = TokenCache_entry(cache, address);
+  if (entry == NULL) {
+    return TokenCache_Result_Full;
+  }
+  uint64_t sequence =
+      atomic_load_explicit(&entry->sequence, memory_order_relaxed);
+  if (sequence == 0) {
+    if (2 * (cache->len + 1) > cache->capacity) {
+      return TokenCache_Result_Full;
+    }
+    cache->len++;
+  } else if (slot < atomic_load_explicit(&entry->words[4],
+                                         memory_order_relaxed)) {
+    return TokenCache_Result_Stale;
+  }
+
+  TokenCache_Record record;
+  memset(&record, 0, sizeof(record));
+  memcpy(record.address, address, 32);
+  record.slot = slot;
+  record.present = Token_Account_is_initialized(data, data_len);
+  if (record.present) {
+    memcpy(record.data, data, Token_Account_LEN);
+  }
+  uint64_t words[TokenCache_RECORD_WORDS];
+  memcpy(words, &record, sizeof(words));
+
+  // An empty entry goes from 0 to 1 and then 2, any other from even to odd
+  // and back to even, so readers tell a write in progress from a stable one
+  atomic_store_explicit(&entry->sequence, sequence + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  for (size_t w = 0; w < TokenCache_RECORD_WORDS; w++) {
+    atomic_store_explicit(&entry->words[w], words[w], memory_order_relaxed);
+  }
+  atomic_store_explicit(&entry->sequence, sequence + 2, memory_order_release);
+  return TokenCache_Result_Updated;
+}
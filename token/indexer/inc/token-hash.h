@@ -0,0 +1,40 @@
+/**
+ * @brief Seeded pubkey hashes for the indexer's hash tables
+ *
+ * Owners, mints and addresses are chosen by whoever creates the accounts, so
+ * a table hashing them with the unkeyed `SplPubkey_hash` can be fed keys
+ * ground to share a probe sequence, slowing every lookup down.  Each table
+ * instead draws a random seed when it is created and keys its hash with it,
+ * so colliding keys cannot be found without knowing the seed.
+ */
+#pragma once
+
+#include <sys/random.h>
+
+#include "spl-pubkey.h"
+
+/// Random key of a table's hash
+typedef struct TokenHash_Seed {
+  uint64_t x[4];
+} TokenHash_Seed;
+
+/// Draws `seed` from the system's entropy source, failing if it cannot
+static inline bool TokenHash_Seed_init(TokenHash_Seed *seed) {
+  return getentropy(seed->x, sizeof(seed->x)) == 0;
+}
+
+/// Folds the 128-bit product of `a` and `b` into 64 bits
+static inline uint64_t TokenHash_mix(uint64_t a, uint64_t b) {
+  unsigned __int128 product = (unsigned __int128)a * b;
+  return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+/// Hash of `key` keyed by `seed`, chained from the hash `h` of earlier keys.
+/// Every word is mixed with its own seed word before the multiplications, so
+/// no relation between words collides without knowing the seed.
+static inline uint64_t TokenHash_pubkey(const TokenHash_Seed *seed,
+                                        const uint8_t *key, uint64_t h) {
+  SplPubkey_Words words = SplPubkey_load(key);
+  return TokenHash_mix(words.x[0] ^ seed->x[0] ^ h, words.x[1] ^ seed->x[1]) ^
+         TokenHash_mix(words.x[2] ^ seed->x[2], words.x[3] ^ seed->x[3]);
+}
@@ -0,0 +1,392 @@
+/**
+ * @brief Pipelined decoding of token instruction history
+ *
+ * Historical indexing runs three stages over confirmed blocks:
+ *
+ *   fetch -> decode -> apply
+ *
+ * A fetch thread produces blocks in slot order, decoder threads decode the
+ * token instructions of different blocks in parallel, and the calling thread
+ * applies the decoded blocks strictly in the order they were fetched, so an
+ * index it updates sees history exactly as a serial pass would.  The stages
+ * share a bounded ring of in-flight blocks: fetching waits once the ring is
+ * full, so a slow apply stage holds back the rest instead of using unbounded
+ * memory.
+ *
+ * `TokenHistory_decode` is also usable on its own and accepts exactly what
+ * `TokenInstruction::unpack` accepts.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "token-layout.h"
+
+/// Blocks in flight when `TokenHistory_run` is given a depth of zero
+#define TokenHistory_DEFAULT_DEPTH 64
+
+/**
+ * Decodes instruction `data` by its tag into the body structs of `token.h`,
+ * returning `false` if the program would reject it
+ */
+static inline bool TokenHistory_decode(const uint8_t *data, uint64_t data_len,
+                                       Token_TokenInstruction *instruction) {
+  if (data_len == 0) {
+    return false;
+  }
+  memset(instruction, 0, sizeof(*instruction));
+  instruction->tag = (Token_TokenInstruction_Tag)data[0];
+  const uint8_t *rest = data + 1;
+  uint64_t rest_len = data_len - 1;
+  switch (data[0]) {
+  case Token_TokenInstruction_InitializeMint: {
+    Token_TokenInstruction_Token_InitializeMint_Body *body =
+        &instruction->initialize_mint;
+    if (rest_len < 34 || rest[33] > 1 || (rest[33] == 1 && rest_len < 66)) {
+      return false;
+    }
+    body->decimals = rest[0];
+    memcpy(body->mint_authority, rest + 1, 32);
+    if (rest[33] == 1) {
+      body->freeze_authority.tag = Token_COption_Pubkey_Some_Pubkey;
+      memcpy(body->freeze_authority.some, rest + 34, 32);
+    }
+    return true;
+  }
+  case Token_TokenInstruction_InitializeMultisig:
+    if (rest_len < 1) {
+      return false;
+    }
+    instruction->initialize_multisig.m = rest[0];
+    return true;
+  case Token_TokenInstruction_Transfer:
+  case Token_TokenInstruction_Approve:
+  case Token_TokenInstruction_MintTo:
+  case Token_TokenInstruction_Burn:
+    if (rest_len < 8) {
+      return false;
+    }
+    // Every amount body is laid out alike
+    instruction->transfer.amount = Token_read_u64(rest);
+    return true;
+  case Token_TokenInstruction_SetAuthority: {
+    Token_TokenInstruction_Token_SetAuthority_Body *body =
+        &instruction->set_authority;
+    if (rest_len < 2 || rest[0] > Token_AuthorityType_CloseAccount ||
+        rest[1] > 1 || (rest[1] == 1 && rest_len < 34)) {
+      return false;
+    }
+    body->authority_type = (Token_AuthorityType)rest[0];
+    if (rest[1] == 1) {
+      body->new_authority.tag = Token_COption_Pubkey_Some_Pubkey;
+      memcpy(body->new_authority.some, rest + 2, 32);
+    }
+    return true;
+  }
+  case Token_TokenInstruction_InitializeAccount:
+  case Token_TokenInstruction_Revoke:
+  case Token_TokenInstruction_CloseAccount:
+  case Token_TokenInstruction_FreezeAccount:
+  case Token_TokenInstruction_ThawAccount:
+    return true;
+  case Token_TokenInstruction_TransferChecked:
+  case Token_TokenInstruction_ApproveChecked:
+  case Token_TokenInstruction_MintToChecked:
+  case Token_TokenInstruction_BurnChecked:
+    if (rest_len < 9) {
+      return false;
+    }
+    // Every checked amount body is laid out alike
+    instruction->transfer_checked.amount = Token_read_u64(rest);
+    instruction->transfer_checked.decimals = rest[8];
+    return true;
+  case Token_TokenInstruction_InitializeAccount2:
+    if (rest_len < 32) {
+      return false;
+    }
+    memcpy(instruction->initialize_account2.owner, rest, 32);
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// A token program instruction of a block
+typedef struct TokenHistory_Instruction {
+  const uint8_t *data;
+  uint64_t data_len;
+  /// Keys of the instruction's accounts, in instruction order
+  const uint8_t (*accounts)[32];
+  uint64_t accounts_len;
+  /// Set by the decode stage, `false` if the program would reject the data
+  bool is_valid;
+  Token_TokenInstruction instruction;
+} TokenHistory_Instruction;
+
+/// The token instructions of a block's successful transactions, in order
+typedef struct TokenHistory_Block {
+  uint64_t slot;
+  TokenHistory_Instruction *instructions;
+  uint64_t instructions_len;
+  /// Left to the fetch stage, such as the memory backing the block
+  void *context;
+} TokenHistory_Block;
+
+/// Change of one account's balance
+typedef struct TokenHistory_Delta {
+  const uint8_t *account;
+  uint64_t amount;
+  /// Whether the amount is added rather than subtracted
+  bool credit;
+} TokenHistory_Delta;
+
+/**
+ * Stores the balance changes of a decoded instruction to `deltas`, returning
+ * how many there are, none for instructions that move no tokens
+ */
+static inline size_t
+TokenHistory_deltas(const TokenHistory_Instruction *instruction,
+                    TokenHistory_Delta deltas[2]) {
+  if (!instruction->is_valid) {
+    return 0;
+  }
+  const Token_TokenInstruction *decoded = &instruction->instruction;
+  const uint8_t(*accounts)[32] = instruction->accounts;
+  uint64_t accounts_len = instruction->accounts_len;
+  switch (decoded->tag) {
+  case Token_TokenInstruction_Transfer:
+  case Token_TokenInstruction_TransferChecked: {
+    // TransferChecked passes the mint between source and destination
+    uint64_t destination =
+        decoded->tag == Token_TokenInstruction_Transfer ? 1 : 2;
+    if (accounts_len <= destination) {
+      return 0;
+    }
+    deltas[0] = (TokenHistory_Delta){accounts[0], decoded->transfer.amount,
+                                     false};
+    deltas[1] = (TokenHistory_Delta){accounts[destination],
+                                     decoded->transfer.amount, true};
+    return 2;
+  }
+  case Token_TokenInstruction_MintTo:
+  case Token_TokenInstruction_MintToChecked:
+    if (accounts_len < 2) {
+      return 0;
+    }
+    deltas[0] =
+        (TokenHistory_Delta){accounts[1], decoded->mint_to.amount, true};
+    return 1;
+  case Token_TokenInstruction_Burn:
+  case Token_TokenInstruction_BurnChecked:
+    if (accounts_len < 1) {
+      return 0;
+    }
+    deltas[0] = (TokenHistory_Delta){accounts[0], decoded->burn.amount, false};
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+/// Stores the next block, returning `false` once there are no more
+typedef bool (*TokenHistory_Fetch)(void *context, TokenHistory_Block **block);
+/// Consumes a decoded block, returning `false` stops the pipeline
+typedef bool (*TokenHistory_Apply)(void *context, TokenHistory_Block *block);
+/// Disposes of a block fetched but never applied because the pipeline stopped
+typedef void (*TokenHistory_Release)(void *context, TokenHistory_Block *block);
+
+typedef struct TokenHistory_Stages {
+  TokenHistory_Fetch fetch;
+  TokenHistory_Apply apply;
+  /// May be `NULL`
+  TokenHistory_Release release;
+  void *context;
+} TokenHistory_Stages;
+
+typedef enum TokenHistory_State {
+  TokenHistory_State_Fetched,
+  TokenHistory_State_Decoding,
+  TokenHistory_State_Decoded,
+} TokenHistory_State;
+
+/// In-flight blocks, the `i`th fetched block held at `i % depth`
+typedef struct TokenHistory_Ring {
+  pthread_mutex_t lock;
+  /// Signalled when a block is fetched or the fetch stage ends
+  pthread_cond_t fetched;
+  /// Signalled when a block is decoded
+  pthread_cond_t decoded;
+  /// Signalled when a block is applied or the pipeline stops
+  pthread_cond_t applied;
+  TokenHistory_Block **blocks;
+  TokenHistory_State *states;
+  uint64_t depth;
+  /// Sequence numbers of the next block to fetch, decode and apply
+  uint64_t fetch_next;
+  uint64_t decode_next;
+  uint64_t apply_next;
+  bool fetch_done;
+  bool stopped;
+  const TokenHistory_Stages *stages;
+} TokenHistory_Ring;
+
+static inline void TokenHistory_decode_block(TokenHistory_Block *block) {
+  for (uint64_t i = 0; i < block->instructions_len; i++) {
+    TokenHistory_Instruction *instruction = &block->instructions[i];
+    instruction->is_valid =
+        TokenHistory_decode(instruction->data, instruction->data_len,
+                            &instruction->instruction);
+  }
+}
+
+static inline void *TokenHistory_fetch_stage(void *argument) {
+  TokenHistory_Ring *ring = (TokenHistory_Ring *)argument;
+  for (;;) {
+    pthread_mutex_lock(&ring->lock);
+    while (!ring->stopped &&
+           ring->fetch_next - ring->apply_next == ring->depth) {
+      pthread_cond_wait(&ring->applied, &ring->lock);
+    }
+    bool stopped = ring->stopped;
+    pthread_mutex_unlock(&ring->lock);
+
+    TokenHistory_Block *block = NULL;
+    if (stopped || !ring->stages->fetch(ring->stages->context, &block)) {
+      break;
+    }
+    pthread_mutex_lock(&ring->lock);
+    uint64_t at = ring->fetch_next % ring->depth;
+    ring->blocks[at] = block;
+    ring->states[at] = TokenHistory_State_Fetched;
+    ring->fetch_next++;
+    pthread_cond_signal(&ring->fetched);
+    pthread_mutex_unlock(&ring->lock);
+  }
+  pthread_mutex_lock(&ring->lock);
+  ring->fetch_done = true;
+  pthread_cond_broadcast(&ring->fetched);
+  pthread_cond_broadcast(&ring->decoded);
+  pthread_mutex_unlock(&ring->lock);
+  return NULL;
+}
+
+static inline void *TokenHistory_decode_stage(void *argument) {
+  TokenHistory_Ring *ring = (TokenHistory_Ring *)argument;
+  pthread_mutex_lock(&ring->lock);
+  for (;;) {
+    while (!ring->stopped && ring->decode_next == ring->fetch_next &&
+           !ring->fetch_done) {
+      pthread_cond_wait(&ring->fetched, &ring->lock);
+    }
+    if (ring->stopped || ring->decode_next == ring->fetch_next) {
+      break;
+    }
+    uint64_t at = ring->decode_next++ % ring->depth;
+    TokenHistory_Block *block = ring->blocks[at];
+    ring->states[at] = TokenHistory_State_Decoding;
+    pthread_mutex_unlock(&ring->lock);
+
+    TokenHistory_decode_block(block);
+
+    pthread_mutex_lock(&ring->lock);
+    ring->states[at] = TokenHistory_State_Decoded;
+    pthread_cond_broadcast(&ring->decoded);
+  }
+  pthread_mutex_unlock(&ring->lock);
+  return NULL;
+}
+
+/**
+ * Runs the pipeline until the fetch stage has no more blocks or the apply
+ * stage stops it
+ *
+ * Blocks are decoded on `decoders` threads and applied on the calling thread
+ * in fetch order.  At most `depth` blocks, `TokenHistory_DEFAULT_DEPTH` if
+ * zero, are in flight at once.  Returns `false` if the pipeline could not be
+ * started or the apply stage stopped it.
+ */
+static inline bool TokenHistory_run(const TokenHistory_Stages *stages,
+                                    int decoders, uint64_t depth) {
+  TokenHistory_Ring ring;
+  memset(&ring, 0, sizeof(ring));
+  ring.depth = depth == 0 ? TokenHistory_DEFAULT_DEPTH : depth;
+  ring.stages = stages;
+  ring.blocks =
+      (TokenHistory_Block **)calloc(ring.depth, sizeof(*ring.blocks));
+  ring.states =
+      (TokenHistory_State *)calloc(ring.depth, sizeof(*ring.states));
+  decoders = decoders < 1 ? 1 : decoders;
+  pthread_t *threads = (pthread_t *)calloc(decoders, sizeof(*threads));
+  bool ok = ring.blocks != NULL && ring.states != NULL && threads != NULL;
+  pthread_mutex_init(&ring.lock, NULL);
+  pthread_cond_init(&ring.fetched, NULL);
+  pthread_cond_init(&ring.decoded, NULL);
+  pthread_cond_init(&ring.applied, NULL);
+
+  pthread_t fetcher;
+  bool fetching =
+      ok && pthread_create(&fetcher, NULL, TokenHistory_fetch_stage, &ring) ==
+                0;
+  int started = 0;
+  for (; fetching && started < decoders; started++) {
+    if (pthread_create(&threads[started], NULL, TokenHistory_decode_stage,
+                       &ring) != 0) {
+      break;
+    }
+  }
+  ok = fetching && started > 0;
+
+  pthread_mutex_lock(&ring.lock);
+  ring.stopped = !ok;
+  while (!ring.stopped) {
+    uint64_t at = ring.apply_next % ring.depth;
+    while (ring.apply_next == ring.fetch_next ||
+           ring.states[at] != TokenHistory_State_Decoded) {
+      if (ring.fetch_done && ring.apply_next == ring.fetch_next) {
+        break;
+      }
+      pthread_cond_wait(&ring.decoded, &ring.lock);
+    }
+    if (ring.apply_next == ring.fetch_next) {
+      break;
+    }
+    TokenHistory_Block *block = ring.blocks[at];
+    pthread_mutex_unlock(&ring.lock);
+
+    bool more = stages->apply(stages->context, block);
+
+    pthread_mutex_lock(&ring.lock);
+    ring.apply_next++;
+    if (!more) {
+      ring.stopped = true;
+      ok = false;
+    }
+    pthread_cond_broadcast(&ring.applied);
+  }
+  pthread_cond_broadcast(&ring.fetched);
+  pthread_cond_broadcast(&ring.applied);
+  pthread_mutex_unlock(&ring.lock);
+
+  for (int i = 0; i < started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  if (fetching) {
+    pthread_join(fetcher, NULL);
+  }
+  // Only blocks past the last applied one remain
+  for (uint64_t i = ring.apply_next; i < ring.fetch_next; i++) {
+    if (stages->release != NULL) {
+      stages->release(stages->context, ring.blocks[i % ring.depth]);
+    }
+  }
+  pthread_cond_destroy(&ring.applied);
+  pthread_cond_destroy(&ring.decoded);
+  pthread_cond_destroy(&ring.fetched);
+  pthread_mutex_destroy(&ring.lock);
+  free(threads);
+  free(ring.states);
+  free(ring.blocks);
+  return ok;
+}
@@ -0,0 +1,275 @@
+/**
+ * @brief In-memory index of token accounts by owner and mint
+ *
+ * Maps each (owner, mint) pair to the addresses of its accounts, kept up to
+ * date from a stream of account writes such as `TokenStream` records.  An
+ * owner can hold any number of accounts of a mint, so every account is an
+ * entry of its own, hashed by its pair so that the accounts of a pair share
+ * one probe sequence.  A second table keyed by address remembers where each
+ * account is indexed, so a write that changes its owner or closes it moves or
+ * drops the old entry.
+ *
+ * Both tables use linear probing over entries holding their keys inline, so a
+ * lookup reads consecutive slots without following any pointer, and delete by
+ * shifting entries back rather than leaving tombstones.
+ *
+ * Both hashes are keyed by a random seed drawn for each index, see
+ * `token-hash.h`.
+ */
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "spl-pubkey.h"
+#include "token-hash.h"
+#include "token-layout.h"
+
+typedef struct TokenOwnerIndex_Entry {
+  /// Hash the entry is placed by, zero marks an empty slot.  Hashes have their
+  /// top bit set, leaving the low bits that pick the home slot random.
+  uint64_t hash;
+  uint8_t owner[32];
+  uint8_t mint[32];
+  uint8_t address[32];
+} TokenOwnerIndex_Entry;
+
+/// Open-addressing table, grown to stay at most half full
+typedef struct TokenOwnerIndex_Table {
+  TokenOwnerIndex_Entry *slots;
+  /// Power of two
+  size_t capacity;
+  size_t len;
+} TokenOwnerIndex_Table;
+
+typedef struct TokenOwnerIndex {
+  /// Entries placed by the hash of their owner and mint
+  TokenOwnerIndex_Table pairs;
+  /// The same entries placed by the hash of their address
+  TokenOwnerIndex_Table addresses;
+  /// Random key of both hashes
+  TokenHash_Seed seed;
+} TokenOwnerIndex;
+
+/// Nonzero hash of an (owner, mint) pair
+static inline uint64_t TokenOwnerIndex_pair_hash(const TokenOwnerIndex *index,
+                                                 const uint8_t *owner,
+                                                 const uint8_t *mint) {
+  uint64_t h = TokenHash_pubkey(&index->seed, owner, 0);
+  return TokenHash_pubkey(&index->seed, mint, h) | 1ULL << 63;
+}
+
+/// Nonzero hash of an account address
+static inline uint64_t
+TokenOwnerIndex_address_hash(const TokenOwnerIndex *index,
+                             const uint8_t *address) {
+  return TokenHash_pubkey(&index->seed, address, 0) | 1ULL << 63;
+}
+
+static inline bool TokenOwnerIndex_Table_init(TokenOwnerIndex_Table *table,
+                                              size_t capacity) {
+  size_t power = 16;
+  while (power < 2 * capacity) {
+    power *= 2;
+  }
+  table->slots =
+      (TokenOwnerIndex_Entry *)calloc(power, sizeof(*table->slots));
+  table->capacity = power;
+  table->len = 0;
+  return table->slots != NULL;
+}
+
+static inline void TokenOwnerIndex_Table_free(TokenOwnerIndex_Table *table) {
+  free(table->slots);
+  table->slots = NULL;
+  table->capacity = 0;
+  table->len = 0;
+}
+
+/// Places `entry` in the first empty slot of its probe sequence, assuming
+/// the table has room
+static inline void
+TokenOwnerIndex_Table_place(TokenOwnerIndex_Table *table,
+                            const TokenOwnerIndex_Entry *entry) {
+  size_t mask = table->capacity - 1;
+  size_t slot = entry->hash & mask;
+  while (table->slots[slot].hash != 0) {
+    slot = (slot + 1) & mask;
+  }
+  table->slots[slot] = *entry;
+  table->len++;
+}
+
+static inline bool TokenOwnerIndex_Table_insert(
+    TokenOwnerIndex_Table *table, const TokenOwnerIndex_Entry *entry) {
+  if (2 * (table->len + 1) > table->capacity) {
+    TokenOwnerIndex_Table grown;
+    if (!TokenOwnerIndex_Table_init(&grown, table->capacity)) {
+      return false;
+    }
+    for (size_t i = 0; i < table->capacity; i++) {
+      if (table->slots[i].hash != 0) {
+        TokenOwnerIndex_Table_place(&grown, &table->slots[i]);
+      }
+    }
+    TokenOwnerIndex_Table_free(table);
+    *table = grown;
+  }
+  TokenOwnerIndex_Table_place(table, entry);
+  return true;
+}
+
+/// Returns the slot of the entry for `address` placed by `hash`, or `NULL`
+static inline TokenOwnerIndex_Entry *
+TokenOwnerIndex_Table_find(const TokenOwnerIndex_Table *table, uint64_t hash,
+                           const uint8_t *address) {
+  size_t mask = table->capacity - 1;
+  for (size_t slot = hash & mask; table->slots[slot].hash != 0;
+       slot = (slot + 1) & mask) {
+    if (table->slots[slot].hash == hash &&
+        SplPubkey_eq(table->slots[slot].address, address)) {
+      return &table->slots[slot];
+    }
+  }
+  return NULL;
+}
+
+/// Empties `entry`'s slot, shifting back later entries of the run that
+/// would otherwise no longer be reachable from their home slot
+static inline void TokenOwnerIndex_Table_remove(TokenOwnerIndex_Table *table,
+                                                TokenOwnerIndex_Entry *entry) {
+  size_t mask = table->capacity - 1;
+  size_t hole = (size_t)(entry - table->slots);
+  for (size_t slot = (hole + 1) & mask; table->slots[slot].hash != 0;
+       slot = (slot + 1) & mask) {
+    size_t home = table->slots[slot].hash & mask;
+    // Move the entry into the hole unless its home lies after the hole,
+    // cyclically, up to its slot
+    if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+      table->slots[hole] = table->slots[slot];
+      hole = slot;
+    }
+  }
+  table->slots[hole].hash = 0;
+  table->len--;
+}
+
+/// Initializes an empty index sized for `capacity` accounts before growing,
+/// failing if no seed could be drawn from the system's entropy source
+static inline bool TokenOwnerIndex_init(TokenOwnerIndex *index,
+                                        size_t capacity) {
+  if (!TokenHash_Seed_init(&index->seed)) {
+    return false;
+  }
+  if (!TokenOwnerIndex_Table_init(&index->pairs, capacity)) {
+    return false;
+  }
+  if (!TokenOwnerIndex_Table_init(&index->addresses, capacity)) {
+    TokenOwnerIndex_Table_free(&index->pairs);
+    return false;
+  }
+  return true;
+}
+
+static inline void TokenOwnerIndex_free(TokenOwnerIndex *index) {
+  TokenOwnerIndex_Table_free(&index->pairs);
+  TokenOwnerIndex_Table_free(&index->addresses);
+}
+
+/// Number of indexed accounts
+static inline size_t TokenOwnerIndex_len(const TokenOwnerIndex *index) {
+  return index->addresses.len;
+}
+
+/// Drops the account at `address` from the index, if it is indexed
+static inline void TokenOwnerIndex_remove(TokenOwnerIndex *index,
+                                          const uint8_t *address) {
+  TokenOwnerIndex_Entry *by_address = TokenOwnerIndex_Table_find(
+      &index->addresses, TokenOwnerIndex_address_hash(index, address), address);
+  if (by_address == NULL) {
+    return;
+  }
+  uint64_t pair_hash =
+      TokenOwnerIndex_pair_hash(index, by_address->owner, by_address->mint);
+  TokenOwnerIndex_Entry *by_pair =
+      TokenOwnerIndex_Table_find(&index->pairs, pair_hash, address);
+  TokenOwnerIndex_Table_remove(&index->pairs, by_pair);
+  TokenOwnerIndex_Table_remove(&index->addresses, by_address);
+}
+
+/**
+ * Applies a write of `data` to the account at `address`
+ *
+ * An initialized or frozen account is indexed under its owner and mint; any
+ * other data, such as a closed account or one reassigned to another program,
+ * drops the address from the index.  Returns `false` only if a table could
+ * not grow, leaving the account unindexed.
+ */
+static inline bool TokenOwnerIndex_update(TokenOwnerIndex *index,
+                                          const uint8_t *address,
+                                          const uint8_t *data,
+                                          uint64_t data_len) {
+  if (!Token_Account_is_initialized(data, data_len)) {
+    TokenOwnerIndex_remove(index, address);
+    return true;
+  }
+  const uint8_t *owner = Token_Account_get_owner(data);
+  const uint8_t *mint = Token_Account_get_mint(data);
+  const TokenOwnerIndex_Entry *current = TokenOwnerIndex_Table_find(
+      &index->addresses, TokenOwnerIndex_address_hash(index, address), address);
+  if (current != NULL) {
+    // Most writes only change balances
+    if (SplPubkey_eq(current->owner, owner) &&
+        SplPubkey_eq(current->mint, mint)) {
+      return true;
+    }
+    TokenOwnerIndex_remove(index, address);
+  }
+
+  TokenOwnerIndex_Entry entry;
+  memcpy(entry.owner, owner, 32);
+  memcpy(entry.mint, mint, 32);
+  memcpy(entry.address, address, 32);
+  uint64_t pair_hash = TokenOwnerIndex_pair_hash(index, owner, mint);
+  entry.hash = pair_hash;
+  if (!TokenOwnerIndex_Table_insert(&index->pairs, &entry)) {
+    return false;
+  }
+  entry.hash = TokenOwnerIndex_address_hash(index, address);
+  if (!TokenOwnerIndex_Table_insert(&index->addresses, &entry)) {
+    TokenOwnerIndex_Table_remove(
+        &index->pairs,
+        TokenOwnerIndex_Table_find(&index->pairs, pair_hash, address));
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Finds the accounts of `mint` owned by `owner`
+ *
+ * Writes the addresses of up to `max` of them to `addresses` and returns how
+ * many there are in all, in no particular order.
+ */
+static inline size_t TokenOwnerIndex_find(const TokenOwnerIndex *index,
+                                          const uint8_t *owner,
+                                          const uint8_t *mint,
+                                          uint8_t (*addresses)[32],
+                                          size_t max) {
+  const TokenOwnerIndex_Table *table = &index->pairs;
+  uint64_t hash = TokenOwnerIndex_pair_hash(index, owner, mint);
+  size_t mask = table->capacity - 1;
+  size_t found = 0;
+  for (size_t slot = hash & mask; table->slots[slot].hash != 0;
+       slot = (slot + 1) & mask) {
+    const TokenOwnerIndex_Entry *entry = &table->slots[slot];
+    if (entry->hash == hash && SplPubkey_eq(entry->owner, owner) &&
+        SplPubkey_eq(entry->mint, mint)) {
+      if (found < max) {
+        memcpy(addresses[found], entry->address, 32);
+      }
+      found++;
+    }
+  }
+  return found;
+}
@@ -0,0 +1,259 @@
+/**
+ * @brief Parallel per-mint aggregation over packed SPL Token accounts
+ *
+ * Splits an array of packed `Token_Account` records, such as the records
+ * column of a snapshot, into fixed-size chunks that worker threads claim from
+ * a shared atomic cursor, so a thread that finishes early keeps taking chunks
+ * from the rest.  Each thread totals its chunks into a private mint-keyed
+ * hash map, and the maps are merged once every thread is done.
+ *
+ * Uninitialized and invalid records are not counted.  Each map keys its hash
+ * with a seed of its own, see `token-hash.h`, so mints ground to collide
+ * cannot slow a scan down.
+ */
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "spl-pubkey.h"
+#include "token-hash.h"
+#include "token-layout.h"
+
+typedef unsigned __int128 TokenScan_u128;
+
+/// Records claimed by a thread at a time
+#define TokenScan_DEFAULT_CHUNK_LEN 4096
+
+/// Totals of every account of a mint
+typedef struct TokenScan_MintTotals {
+  uint8_t mint[32];
+  /// Number of accounts, zero marks an unused slot
+  uint64_t accounts;
+  /// Number of accounts holding a non-zero amount
+  uint64_t holders;
+  /// Sum of `amount`, wide enough for any number of accounts
+  TokenScan_u128 amount;
+  /// Sum of `delegated_amount`
+  TokenScan_u128 delegated_amount;
+} TokenScan_MintTotals;
+
+/// Open-addressing map of mint to totals, grown to stay at most half full
+typedef struct TokenScan_Map {
+  TokenScan_MintTotals *slots;
+  /// Power of two
+  size_t capacity;
+  size_t len;
+  /// Random key of the hash placing mints
+  TokenHash_Seed seed;
+} TokenScan_Map;
+
+/// Initializes an empty map with room for `capacity` mints, failing if it
+/// cannot be allocated or no seed could be drawn
+static inline bool TokenScan_Map_init(TokenScan_Map *map, size_t capacity) {
+  if (!TokenHash_Seed_init(&map->seed)) {
+    *map = (TokenScan_Map){NULL, 0, 0, map->seed};
+    return false;
+  }
+  size_t power = 16;
+  while (power < capacity) {
+    power *= 2;
+  }
+  map->slots = (TokenScan_MintTotals *)calloc(power, sizeof(*map->slots));
+  map->capacity = power;
+  map->len = 0;
+  return map->slots != NULL;
+}
+
+static inline void TokenScan_Map_free(TokenScan_Map *map) {
+  free(map->slots);
+  map->slots = NULL;
+  map->capacity = 0;
+  map->len = 0;
+}
+
+/// Returns the slot for `mint`, or the empty slot where it belongs
+static inline TokenScan_MintTotals *
+TokenScan_Map_slot(const TokenScan_Map *map, const uint8_t *mint) {
+  size_t slot = TokenHash_pubkey(&map->seed, mint, 0) & (map->capacity - 1);
+  while (map->slots[slot].accounts != 0 &&
+         !SplPubkey_eq(map->slots[slot].mint, mint)) {
+    slot = (slot + 1) & (map->capacity - 1);
+  }
+  return &map->slots[slot];
+}
+
+/// Returns the totals of `mint`, or `NULL` if it has no accounts
+static inline const TokenScan_MintTotals *
+TokenScan_Map_find(const TokenScan_Map *map, const uint8_t *mint) {
+  const TokenScan_MintTotals *totals = TokenScan_Map_slot(map, mint);
+  return totals->accounts == 0 ? NULL : totals;
+}
+
+static inline bool TokenScan_Map_grow(TokenScan_Map *map) {
+  TokenScan_Map grown;
+  if (!TokenScan_Map_init(&grown, map->capacity * 2)) {
+    return false;
+  }
+  for (size_t i = 0; i < map->capacity; i++) {
+    if (map->slots[i].accounts != 0) {
+      *TokenScan_Map_slot(&grown, map->slots[i].mint) = map->slots[i];
+    }
+  }
+  grown.len = map->len;
+  TokenScan_Map_free(map);
+  *map = grown;
+  return true;
+}
+
+/// Adds `totals` to the totals of its mint
+static inline bool TokenScan_Map_add(TokenScan_Map *map,
+                                     const TokenScan_MintTotals *totals) {
+  if (2 * (map->len + 1) > map->capacity && !TokenScan_Map_grow(map)) {
+    return false;
+  }
+  TokenScan_MintTotals *slot = TokenScan_Map_slot(map, totals->mint);
+  if (slot->accounts == 0) {
+    memcpy(slot->mint, totals->mint, 32);
+    map->len++;
+  }
+  slot->accounts += totals->accounts;
+  slot->holders += totals->holders;
+  slot->amount += totals->amount;
+  slot->delegated_amount += totals->delegated_amount;
+  return true;
+}
+
+/// Adds every entry of `source` into `map`
+static inline bool TokenScan_Map_merge(TokenScan_Map *map,
+                                       const TokenScan_Map *source) {
+  for (size_t i = 0; i < source->capacity; i++) {
+    if (source->slots[i].accounts != 0 &&
+        !TokenScan_Map_add(map, &source->slots[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Totals `count` packed records into `map`
+static inline bool TokenScan_records(TokenScan_Map *map,
+                                     const uint8_t *records, uint64_t count) {
+  // Accounts of a mint are usually adjacent, e.g. in a snapshot, so runs are
+  // totalled before touching the map
+  TokenScan_MintTotals run = {{0}, 0, 0, 0, 0};
+  for (uint64_t i = 0; i < count; i++) {
+    const uint8_t *record = records + Token_Account_LEN * i;
+    if (!Token_Account_is_initialized(record, Token_Account_LEN)) {
+      continue;
+    }
+    const uint8_t *mint = Token_Account_get_mint(record);
+    if (run.accounts != 0 && !SplPubkey_eq(run.mint, mint)) {
+      if (!TokenScan_Map_add(map, &run)) {
+        return false;
+      }
+      run = (TokenScan_MintTotals){{0}, 0, 0, 0, 0};
+    }
+    uint64_t amount = Token_Account_get_amount(record);
+    memcpy(run.mint, mint, 32);
+    run.accounts++;
+    run.holders += amount != 0;
+    run.amount += amount;
+    run.delegated_amount += Token_Account_get_delegated_amount(record);
+  }
+  return run.accounts == 0 || TokenScan_Map_add(map, &run);
+}
+
+/// Work shared by the threads of a scan
+typedef struct TokenScan_Job {
+  const uint8_t *records;
+  uint64_t count;
+  uint64_t chunk_len;
+  atomic_uint_fast64_t next_chunk;
+  atomic_bool failed;
+} TokenScan_Job;
+
+typedef struct TokenScan_Worker {
+  TokenScan_Job *job;
+  pthread_t thread;
+  TokenScan_Map map;
+} TokenScan_Worker;
+
+static inline void *TokenScan_work(void *argument) {
+  TokenScan_Worker *worker = (TokenScan_Worker *)argument;
+  TokenScan_Job *job = worker->job;
+  uint64_t chunks = (job->count + job->chunk_len - 1) / job->chunk_len;
+  for (;;) {
+    uint64_t chunk = atomic_fetch_add(&job->next_chunk, 1);
+    if (chunk >= chunks || atomic_load(&job->failed)) {
+      break;
+    }
+    uint64_t first = chunk * job->chunk_len;
+    uint64_t len = job->count - first < job->chunk_len ? job->count - first
+                                                      : job->chunk_len;
+    if (!TokenScan_records(&worker->map,
+                           job->records + Token_Account_LEN * first, len)) {
+      atomic_store(&job->failed, true);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Totals `count` packed records on `threads` threads into `totals`, which
+ * must be initialized and may already hold totals
+ *
+ * A `chunk_len` of zero uses `TokenScan_DEFAULT_CHUNK_LEN`.  Returns `false`
+ * if a thread or map could not be allocated.
+ */
+static inline bool TokenScan_run(const uint8_t *records, uint64_t count,
+                                 int threads, uint64_t chunk_len,
+                                 TokenScan_Map *totals) {
+  TokenScan_Job job;
+  job.records = records;
+  job.count = count;
+  job.chunk_len = chunk_len == 0 ? TokenScan_DEFAULT_CHUNK_LEN : chunk_len;
+  atomic_init(&job.next_chunk, 0);
+  atomic_init(&job.failed, false);
+
+  threads = threads < 1 ? 1 : threads;
+  TokenScan_Worker *workers =
+      (TokenScan_Worker *)calloc(threads, sizeof(*workers));
+  if (workers == NULL) {
+    return false;
+  }
+  int started = 0;
+  for (; started < threads; started++) {
+    workers[started].job = &job;
+    if (!TokenScan_Map_init(&workers[started].map, 0)) {
+      break;
+    }
+    if (pthread_create(&workers[started].thread, NULL, TokenScan_work,
+                       &workers[started]) != 0) {
+      TokenScan_Map_free(&workers[started].map);
+      break;
+    }
+  }
+  // Threads that did start still cover every chunk
+  bool ok = started > 0;
+  for (int i = 0; i < started; i++) {
+    pthread_join(workers[i].thread, NULL);
+    ok = ok && TokenScan_Map_merge(totals, &workers[i].map);
+    TokenScan_Map_free(&workers[i].map);
+  }
+  free(workers);
+  return ok && !atomic_load(&job.failed);
+}
+
+/// Returns whether the accounts of the mint at `mint_address` add up to the
+/// supply in its packed `mint_data`.  The native mint's supply is always
+/// zero, so it only matches while no wrapped SOL is held.
+static inline bool TokenScan_supply_matches(const TokenScan_Map *totals,
+                                            const uint8_t *mint_address,
+                                            const uint8_t *mint_data) {
+  const TokenScan_MintTotals *mint = TokenScan_Map_find(totals, mint_address);
+  TokenScan_u128 amount = mint == NULL ? 0 : mint->amount;
+  return amount == Token_Mint_get_supply(mint_data);
+}
@@ -0,0 +1,366 @@
+/**
+ * @brief Columnar, memory-mappable snapshots of SPL Token accounts
+ *
+ * A snapshot stores each account's address, mint, owner and amount in
+ * separate columns, next to the full packed `Token_Account` data, with all
+ * columns sorted by mint and then owner.  A sorted mint index maps each mint
+ * to its range of rows, so a scan like "all balances for mint X" touches only
+ * the index and the amount column.
+ *
+ * The file is little-endian and is used in place: `TokenSnapshot_map` is a
+ * single `mmap` and every column is a pointer into the mapping.  Column
+ * widths and the packed record length come from token-layout.h.
+ *
+ *   header   TokenSnapshot_Header
+ *   keys     count * 32, account addresses
+ *   mints    count * 32
+ *   owners   count * 32
+ *   amounts  count * uint64_t
+ *   records  count * Token_Account_LEN, packed account data
+ *   index    mint_count * TokenSnapshot_MintRange, sorted by mint
+ *
+ * Every section starts on a `TokenSnapshot_ALIGN` boundary.
+ */
+#pragma once
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "token-layout.h"
+
+#define TokenSnapshot_MAGIC "SPLTSNAP"
+#define TokenSnapshot_VERSION 1
+#define TokenSnapshot_ALIGN 64
+
+/// Length of an input record, the account address followed by its data
+#define TokenSnapshot_INPUT_RECORD_LEN (32 + Token_Account_LEN)
+
+/// Starts the file
+typedef struct TokenSnapshot_Header {
+  char magic[8];
+  uint32_t version;
+  /// `Token_Account_LEN` of the writer, rejected by readers built against
+  /// another layout
+  uint32_t record_len;
+  uint64_t count;
+  uint64_t mint_count;
+  /// Byte offsets of the sections from the start of the file
+  uint64_t keys_offset;
+  uint64_t mints_offset;
+  uint64_t owners_offset;
+  uint64_t amounts_offset;
+  uint64_t records_offset;
+  uint64_t index_offset;
+  /// Total file length
+  uint64_t len;
+  uint8_t reserved[40];
+} TokenSnapshot_Header;
+
+/// Rows `[first, first + count)` hold the accounts of `mint`
+typedef struct TokenSnapshot_MintRange {
+  uint8_t mint[32];
+  uint64_t first;
+  uint64_t count;
+} TokenSnapshot_MintRange;
+
+/// An open snapshot, every pointer refers into the file's memory
+typedef struct TokenSnapshot {
+  const uint8_t *data;
+  uint64_t len;
+  uint64_t count;
+  uint64_t mint_count;
+  const uint8_t (*keys)[32];
+  const uint8_t (*mints)[32];
+  const uint8_t (*owners)[32];
+  const uint64_t *amounts;
+  const uint8_t *records;
+  const TokenSnapshot_MintRange *index;
+  /// Whether `data` is a mapping owned by the snapshot
+  bool mapped;
+} TokenSnapshot;
+
+static inline uint64_t TokenSnapshot_align(uint64_t offset) {
+  return (offset + TokenSnapshot_ALIGN - 1) & ~(uint64_t)(TokenSnapshot_ALIGN - 1);
+}
+
+/// Lays out the sections of a snapshot of `count` accounts and `mint_count`
+/// mints
+static inline void TokenSnapshot_Header_init(TokenSnapshot_Header *header,
+                                             uint64_t count,
+                                             uint64_t mint_count) {
+  memset(header, 0, sizeof(*header));
+  memcpy(header->magic, TokenSnapshot_MAGIC, sizeof(header->magic));
+  header->version = TokenSnapshot_VERSION;
+  header->record_len = Token_Account_LEN;
+  header->count = count;
+  header->mint_count = mint_count;
+  header->keys_offset = TokenSnapshot_align(sizeof(*header));
+  header->mints_offset = TokenSnapshot_align(header->keys_offset + 32 * count);
+  header->owners_offset = TokenSnapshot_align(header->mints_offset + 32 * count);
+  header->amounts_offset =
+      TokenSnapshot_align(header->owners_offset + 32 * count);
+  header->records_offset =
+      TokenSnapshot_align(header->amounts_offset + sizeof(uint64_t) * count);
+  header->index_offset = TokenSnapshot_align(header->records_offset +
+                                             Token_Account_LEN * count);
+  header->len = header->index_offset +
+                sizeof(TokenSnapshot_MintRange) * mint_count;
+}
+
+/// Opens a snapshot held in memory, checking that every section lies within
+/// `len` bytes and that the mint index splits the rows into consecutive,
+/// non-empty ranges in strictly ascending mint order.  `data` must be
+/// `TokenSnapshot_ALIGN` aligned and outlive `snapshot`.
+static inline bool TokenSnapshot_open(TokenSnapshot *snapshot,
+                                      const uint8_t *data, uint64_t len) {
+  const TokenSnapshot_Header *header = (const TokenSnapshot_Header *)data;
+  if (len < sizeof(*header) ||
+      memcmp(header->magic, TokenSnapshot_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != TokenSnapshot_VERSION ||
+      header->record_len != Token_Account_LEN) {
+    return false;
+  }
+  // Rebuild the layout from the counts rather than trusting the offsets
+  if (header->count > len / Token_Account_LEN ||
+      header->mint_count > header->count) {
+    return false;
+  }
+  TokenSnapshot_Header expected;
+  TokenSnapshot_Header_init(&expected, header->count, header->mint_count);
+  if (expected.keys_offset != header->keys_offset ||
+      expected.mints_offset != header->mints_offset ||
+      expected.owners_offset != header->owners_offset ||
+      expected.amounts_offset != header->amounts_offset ||
+      expected.records_offset != header->records_offset ||
+      expected.index_offset != header->index_offset ||
+      expected.len != header->len || header->len > len) {
+    return false;
+  }
+  // Lookups trust the index, so each range must start where the previous one
+  // ended and name the mint of its rows
+  const TokenSnapshot_MintRange *index =
+      (const TokenSnapshot_MintRange *)(data + header->index_offset);
+  const uint8_t(*mints)[32] =
+      (const uint8_t(*)[32])(data + header->mints_offset);
+  uint64_t end = 0;
+  for (uint64_t i = 0; i < header->mint_count; i++) {
+    if (index[i].first != end || index[i].count == 0 ||
+        index[i].count > header->count - end ||
+        memcmp(index[i].mint, mints[end], 32) != 0 ||
+        (i > 0 && memcmp(index[i - 1].mint, index[i].mint, 32) >= 0)) {
+      return false;
+    }
+    end += index[i].count;
+  }
+  if (end != header->count) {
+    return false;
+  }
+
+  snapshot->data = data;
+  snapshot->len = len;
+  snapshot->count = header->count;
+  snapshot->mint_count = header->mint_count;
+  snapshot->keys = (const uint8_t(*)[32])(data + header->keys_offset);
+  snapshot->mints = (const uint8_t(*)[32])(data + header->mints_offset);
+  snapshot->owners = (const uint8_t(*)[32])(data + header->owners_offset);
+  snapshot->amounts = (const uint64_t *)(data + header->amounts_offset);
+  snapshot->records = data + header->records_offset;
+  snapshot->index = index;
+  snapshot->mapped = false;
+  return true;
+}
+
+/// Maps the snapshot file at `path` read-only with a single `mmap`
+static inline bool TokenSnapshot_map(TokenSnapshot *snapshot,
+                                     const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  void *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  if (!TokenSnapshot_open(snapshot, data, st.st_size)) {
+    munmap(data, st.st_size);
+    return false;
+  }
+  snapshot->mapped = true;
+  return true;
+}
+
+static inline void TokenSnapshot_unmap(TokenSnapshot *snapshot) {
+  if (snapshot->mapped) {
+    munmap((void *)snapshot->data, snapshot->len);
+    snapshot->mapped = false;
+  }
+}
+
+/// Packed `Token_Account` data of row `row`
+static inline const uint8_t *TokenSnapshot_record(const TokenSnapshot *snapshot,
+                                                  uint64_t row) {
+  return snapshot->records + Token_Account_LEN * row;
+}
+
+/// Finds the rows holding accounts of `mint` by binary search of the index,
+/// returning `NULL` if there are none
+static inline const TokenSnapshot_MintRange *
+TokenSnapshot_find_mint(const TokenSnapshot *snapshot, const uint8_t *mint) {
+  uint64_t low = 0;
+  uint64_t high = snapshot->mint_count;
+  while (low < high) {
+    uint64_t middle = low + (high - low) / 2;
+    int order = memcmp(snapshot->index[middle].mint, mint, 32);
+    if (order == 0) {
+      return &snapshot->index[middle];
+    }
+    if (order < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return NULL;
+}
+
+/// Sums the balances of every account of `mint`, reading only the index and
+/// the amount column.  Returns `false` if the sum overflows, which a valid
+/// mint's supply never does.
+static inline bool TokenSnapshot_mint_total(const TokenSnapshot *snapshot,
+                                            const uint8_t *mint,
+                                            uint64_t *total) {
+  *total = 0;
+  const TokenSnapshot_MintRange *range = TokenSnapshot_find_mint(snapshot, mint);
+  if (range == NULL) {
+    return true;
+  }
+  const uint64_t *amounts = snapshot->amounts + range->first;
+  for (uint64_t i = 0; i < range->count; i++) {
+    if (__builtin_add_overflow(*total, amounts[i], total)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Orders input records by mint, then owner
+static inline int TokenSnapshot_compare_inputs(const void *one,
+                                               const void *two) {
+  const uint8_t *a = *(const uint8_t *const *)one + 32;
+  const uint8_t *b = *(const uint8_t *const *)two + 32;
+  int order = memcmp(a + Token_Account_mint_OFFSET,
+                     b + Token_Account_mint_OFFSET, 32);
+  if (order == 0) {
+    order = memcmp(a + Token_Account_owner_OFFSET,
+                   b + Token_Account_owner_OFFSET, 32);
+  }
+  return order;
+}
+
+/// Pads the file from `*written` up to the section starting at `offset`
+static inline bool TokenSnapshot_pad(FILE *out, uint64_t *written,
+                                     uint64_t offset) {
+  static const uint8_t padding[TokenSnapshot_ALIGN] = {0};
+  uint64_t len = offset - *written;
+  *written = offset;
+  return len < sizeof(padding) && fwrite(padding, 1, len, out) == len;
+}
+
+static inline bool TokenSnapshot_put(FILE *out, uint64_t *written,
+                                     const void *data, uint64_t len) {
+  *written += len;
+  return fwrite(data, 1, len, out) == len;
+}
+
+static inline const uint8_t *TokenSnapshot_input_mint(const uint8_t *input) {
+  return input + 32 + Token_Account_mint_OFFSET;
+}
+
+/**
+ * Writes a snapshot of `count` input records, each the account address
+ * followed by its packed data as `TokenSnapshot_INPUT_RECORD_LEN` bytes
+ *
+ * Records that are not initialized `Token_Account` data are skipped and
+ * counted in `skipped` if it is not `NULL`.  Returns `false` on allocation or write
+ * failure.
+ */
+static inline bool TokenSnapshot_write(FILE *out, const uint8_t *inputs,
+                                       uint64_t count, uint64_t *skipped) {
+  const uint8_t **rows = (const uint8_t **)malloc(sizeof(*rows) * (count + 1));
+  if (rows == NULL) {
+    return false;
+  }
+  uint64_t rows_len = 0;
+  for (uint64_t i = 0; i < count; i++) {
+    const uint8_t *input = inputs + TokenSnapshot_INPUT_RECORD_LEN * i;
+    if (Token_Account_is_initialized(input + 32, Token_Account_LEN)) {
+      rows[rows_len++] = input;
+    }
+  }
+  if (skipped != NULL) {
+    *skipped = count - rows_len;
+  }
+  qsort(rows, rows_len, sizeof(*rows), TokenSnapshot_compare_inputs);
+
+  uint64_t mint_count = 0;
+  for (uint64_t i = 0; i < rows_len; i++) {
+    if (i == 0 || memcmp(TokenSnapshot_input_mint(rows[i - 1]),
+                         TokenSnapshot_input_mint(rows[i]), 32) != 0) {
+      mint_count++;
+    }
+  }
+
+  TokenSnapshot_Header header;
+  TokenSnapshot_Header_init(&header, rows_len, mint_count);
+  uint64_t written = 0;
+  bool ok = TokenSnapshot_put(out, &written, &header, sizeof(header));
+
+  // Each column is written in a single pass over the sorted rows
+  ok = ok && TokenSnapshot_pad(out, &written, header.keys_offset);
+  for (uint64_t i = 0; ok && i < rows_len; i++) {
+    ok = TokenSnapshot_put(out, &written, rows[i], 32);
+  }
+  ok = ok && TokenSnapshot_pad(out, &written, header.mints_offset);
+  for (uint64_t i = 0; ok && i < rows_len; i++) {
+    ok = TokenSnapshot_put(out, &written, TokenSnapshot_input_mint(rows[i]), 32);
+  }
+  ok = ok && TokenSnapshot_pad(out, &written, header.owners_offset);
+  for (uint64_t i = 0; ok && i < rows_len; i++) {
+    ok = TokenSnapshot_put(
+        out, &written, Token_Account_get_owner(rows[i] + 32), 32);
+  }
+  ok = ok && TokenSnapshot_pad(out, &written, header.amounts_offset);
+  for (uint64_t i = 0; ok && i < rows_len; i++) {
+    uint64_t amount = Token_Account_get_amount(rows[i] + 32);
+    ok = TokenSnapshot_put(out, &written, &amount, sizeof(amount));
+  }
+  ok = ok && TokenSnapshot_pad(out, &written, header.records_offset);
+  for (uint64_t i = 0; ok && i < rows_len; i++) {
+    ok = TokenSnapshot_put(out, &written, rows[i] + 32, Token_Account_LEN);
+  }
+  ok = ok && TokenSnapshot_pad(out, &written, header.index_offset);
+  uint64_t first = 0;
+  for (uint64_t i = 1; ok && i <= rows_len; i++) {
+    if (i == rows_len || memcmp(TokenSnapshot_input_mint(rows[first]),
+                                TokenSnapshot_input_mint(rows[i]), 32) != 0) {
+      TokenSnapshot_MintRange range = {.first = first, .count = i - first};
+      memcpy(range.mint, TokenSnapshot_input_mint(rows[first]), 32);
+      ok = TokenSnapshot_put(out, &written, &range, sizeof(range));
+      first = i;
+    }
+  }
+
+  free(rows);
+  return ok && written == header.len;
+}
@@ -0,0 +1,190 @@
+/**
+ * @brief Streaming parser for packed SPL Token accounts
+ *
+ * Consumes a byte stream of frames, each an account address, its data length
+ * as a little-endian `uint32_t` and the packed data, fed in chunks of any
+ * size:
+ *
+ *   address[32] | data_len | data[data_len]
+ *
+ * Mints, accounts and multisigs are told apart by data length and handed to
+ * a callback as a view of the frame.  A frame that lies within one chunk is
+ * viewed in place; only a frame split across chunks is assembled, in a buffer
+ * inside the `TokenStream`, so the parser never allocates.  Frames of any
+ * other length are skipped without being buffered.
+ */
+#pragma once
+
+#include <string.h>
+
+#include "token-layout.h"
+
+/// Length of the address and data length preceding the data of a frame
+#define TokenStream_FRAME_HEADER_LEN 36
+
+/// Longest frame the parser delivers
+#define TokenStream_MAX_FRAME_LEN \
+  (TokenStream_FRAME_HEADER_LEN + Token_Multisig_LEN)
+
+/// Account type of a record, known from its data length
+typedef enum TokenStream_Kind {
+  TokenStream_Kind_Mint,
+  TokenStream_Kind_Account,
+  TokenStream_Kind_Multisig,
+} TokenStream_Kind;
+
+/// A view of a single frame, valid only during the callback
+typedef struct TokenStream_Record {
+  TokenStream_Kind kind;
+  const uint8_t *address;
+  /// Packed data, not yet validated, see `Token_*_is_valid`
+  const uint8_t *data;
+  uint32_t data_len;
+} TokenStream_Record;
+
+/// Receives each record, returning `false` stops the stream
+typedef bool (*TokenStream_Callback)(void *context,
+                                     const TokenStream_Record *record);
+
+typedef struct TokenStream {
+  TokenStream_Callback callback;
+  void *context;
+  /// Frames delivered to the callback
+  uint64_t records;
+  /// Frames skipped for their data length
+  uint64_t skipped;
+  /// Set once the callback stops the stream
+  bool stopped;
+  /// Bytes of the frame being skipped still to come
+  uint64_t skip_len;
+  /// Start of a frame split across chunks
+  size_t buffered;
+  uint8_t buffer[TokenStream_MAX_FRAME_LEN];
+} TokenStream;
+
+static inline void TokenStream_init(TokenStream *stream,
+                                    TokenStream_Callback callback,
+                                    void *context) {
+  stream->callback = callback;
+  stream->context = context;
+  stream->records = 0;
+  stream->skipped = 0;
+  stream->stopped = false;
+  stream->skip_len = 0;
+  stream->buffered = 0;
+}
+
+/// Returns the kind of data `data_len` bytes long, or `false` if it is not a
+/// token program account
+static inline bool TokenStream_kind(uint32_t data_len,
+                                    TokenStream_Kind *kind) {
+  switch (data_len) {
+  case Token_Mint_LEN:
+    *kind = TokenStream_Kind_Mint;
+    return true;
+  case Token_Account_LEN:
+    *kind = TokenStream_Kind_Account;
+    return true;
+  case Token_Multisig_LEN:
+    *kind = TokenStream_Kind_Multisig;
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Delivers the complete frame at `frame`
+static inline void TokenStream_deliver(TokenStream *stream,
+                                       const uint8_t *frame,
+                                       TokenStream_Kind kind,
+                                       uint32_t data_len) {
+  TokenStream_Record record = {kind, frame,
+                               frame + TokenStream_FRAME_HEADER_LEN, data_len};
+  stream->records++;
+  if (!stream->callback(stream->context, &record)) {
+    stream->stopped = true;
+  }
+}
+
+/**
+ * Parses the next `len` bytes of the stream, invoking the callback for every
+ * frame they complete
+ *
+ * Returns `false` once the callback has stopped the stream, after which the
+ * rest of the input is ignored.
+ */
+static inline bool TokenStream_feed(TokenStream *stream, const uint8_t *data,
+                                    size_t len) {
+  while (len > 0 && !stream->stopped) {
+    if (stream->skip_len > 0) {
+      size_t skip = stream->skip_len < len ? stream->skip_len : len;
+      stream->skip_len -= skip;
+      data += skip;
+      len -= skip;
+      continue;
+    }
+
+    // Find the frame header either in the buffer, completing it from this
+    // chunk, or in place
+    const uint8_t *header = data;
+    if (stream->buffered > 0 ||
+        len < TokenStream_FRAME_HEADER_LEN) {
+      if (stream->buffered < TokenStream_FRAME_HEADER_LEN) {
+        size_t take = TokenStream_FRAME_HEADER_LEN - stream->buffered;
+        take = take < len ? take : len;
+        memcpy(stream->buffer + stream->buffered, data, take);
+        stream->buffered += take;
+        data += take;
+        len -= take;
+        if (stream->buffered < TokenStream_FRAME_HEADER_LEN) {
+          return true;
+        }
+      }
+      header = stream->buffer;
+    }
+
+    uint32_t data_len = Token_read_u32(header + 32);
+    TokenStream_Kind kind;
+    if (!TokenStream_kind(data_len, &kind)) {
+      stream->skipped++;
+      stream->skip_len = data_len;
+      if (header == data) {
+        data += TokenStream_FRAME_HEADER_LEN;
+        len -= TokenStream_FRAME_HEADER_LEN;
+      }
+      stream->buffered = 0;
+      continue;
+    }
+
+    size_t frame_len = TokenStream_FRAME_HEADER_LEN + data_len;
+    if (header == data && len >= frame_len) {
+      TokenStream_deliver(stream, data, kind, data_len);
+      data += frame_len;
+      len -= frame_len;
+      continue;
+    }
+    if (header == data) {
+      // The frame runs past this chunk, keep what there is of it
+      memcpy(stream->buffer, data, len);
+      stream->buffered = len;
+      return true;
+    }
+    size_t take = frame_len - stream->buffered;
+    take = take < len ? take : len;
+    memcpy(stream->buffer + stream->buffered, data, take);
+    stream->buffered += take;
+    data += take;
+    len -= take;
+    if (stream->buffered == frame_len) {
+      stream->buffered = 0;
+      TokenStream_deliver(stream, stream->buffer, kind, data_len);
+    }
+  }
+  return !stream->stopped;
+}
+
+/// Returns whether the stream ended on a frame boundary
+static inline bool TokenStream_finish(const TokenStream *stream) {
+  return stream->stopped ||
+         (stream->buffered == 0 && stream->skip_len == 0);
+}
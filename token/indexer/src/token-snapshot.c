@@ -0,0 +1,135 @@
+/**
+ * @brief Writes and queries token account snapshots
+ *
+ *   token-snapshot write <accounts> <snapshot>
+ *     Converts a dump of accounts, each a 32-byte address followed by the
+ *     165-byte packed account data, into a snapshot.
+ *
+ *   token-snapshot info <snapshot>
+ *     Prints the number of accounts and mints.
+ *
+ *   token-snapshot total <snapshot> <mint>
+ *     Prints the number of accounts and total balance of a base58 mint.
+ */
+#include "token-snapshot.h"
+
+static const char BASE58_ALPHABET[] =
+    "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+/// Decodes a base58 pubkey, failing unless it is exactly 32 bytes
+static bool decode_pubkey(const char *text, uint8_t *key) {
+  uint8_t bytes[64] = {0};
+  size_t leading_zeros = 0;
+  while (text[leading_zeros] == '1') {
+    leading_zeros++;
+  }
+  for (const char *c = text; *c != '\0'; c++) {
+    const char *digit = strchr(BASE58_ALPHABET, *c);
+    if (digit == NULL) {
+      return false;
+    }
+    uint32_t carry = (uint32_t)(digit - BASE58_ALPHABET);
+    for (int i = sizeof(bytes) - 1; i >= 0; i--) {
+      carry += 58 * (uint32_t)bytes[i];
+      bytes[i] = carry & 0xff;
+      carry >>= 8;
+    }
+    if (carry != 0) {
+      return false;
+    }
+  }
+  size_t start = 0;
+  while (start < sizeof(bytes) && bytes[start] == 0) {
+    start++;
+  }
+  if (leading_zeros + sizeof(bytes) - start != 32) {
+    return false;
+  }
+  memset(key, 0, leading_zeros);
+  memcpy(key + leading_zeros, bytes + start, sizeof(bytes) - start);
+  return true;
+}
+
+static int write_snapshot(const char *input_path, const char *output_path) {
+  int fd = open(input_path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    perror(input_path);
+    return 1;
+  }
+  if (st.st_size % TokenSnapshot_INPUT_RECORD_LEN != 0) {
+    fprintf(stderr, "%s: not a whole number of %d-byte records\n", input_path,
+            TokenSnapshot_INPUT_RECORD_LEN);
+    return 1;
+  }
+  const uint8_t *inputs = NULL;
+  if (st.st_size > 0) {
+    inputs = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (inputs == MAP_FAILED) {
+      perror(input_path);
+      return 1;
+    }
+  }
+  close(fd);
+
+  FILE *out = fopen(output_path, "wb");
+  if (out == NULL) {
+    perror(output_path);
+    return 1;
+  }
+  uint64_t count = st.st_size / TokenSnapshot_INPUT_RECORD_LEN;
+  uint64_t skipped = 0;
+  bool ok = TokenSnapshot_write(out, inputs, count, &skipped);
+  if (fclose(out) != 0 || !ok) {
+    fprintf(stderr, "%s: failed to write snapshot\n", output_path);
+    return 1;
+  }
+  printf("wrote %llu accounts, skipped %llu invalid records\n",
+         (unsigned long long)(count - skipped), (unsigned long long)skipped);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc == 4 && strcmp(argv[1], "write") == 0) {
+    return write_snapshot(argv[2], argv[3]);
+  }
+
+  TokenSnapshot snapshot;
+  if ((argc == 3 && strcmp(argv[1], "info") == 0) ||
+      (argc == 4 && strcmp(argv[1], "total") == 0)) {
+    if (!TokenSnapshot_map(&snapshot, argv[2])) {
+      fprintf(stderr, "%s: not a valid snapshot\n", argv[2]);
+      return 1;
+    }
+  } else {
+    fprintf(stderr, "usage: %s write <accounts> <snapshot>\n"
+                    "       %s info <snapshot>\n"
+                    "       %s total <snapshot> <mint>\n",
+            argv[0], argv[0], argv[0]);
+    return 1;
+  }
+
+  int result = 0;
+  if (argc == 3) {
+    printf("%llu accounts, %llu mints\n", (unsigned long long)snapshot.count,
+           (unsigned long long)snapshot.mint_count);
+  } else {
+    uint8_t mint[32];
+    uint64_t total;
+    const TokenSnapshot_MintRange *range;
+    if (!decode_pubkey(argv[3], mint)) {
+      fprintf(stderr, "%s: not a base58 pubkey\n", argv[3]);
+      result = 1;
+    } else if (!TokenSnapshot_mint_total(&snapshot, mint, &total)) {
+      fprintf(stderr, "%s: total overflows\n", argv[3]);
+      result = 1;
+    } else {
+      range = TokenSnapshot_find_mint(&snapshot, mint);
+      printf("%llu accounts, total %llu\n",
+             (unsigned long long)(range == NULL ? 0 : range->count),
+             (unsigned long long)total);
+    }
+  }
+  TokenSnapshot_unmap(&snapshot);
+  return result;
+}
@@ -0,0 +1,178 @@
+#include "token-address.h"
+#include <criterion/criterion.h>
+
+#define ADDRESSES 5000
+
+/// Parses `hex` into `key`
+static void hex_key(uint8_t *key, const char *hex) {
+  for (int i = 0; i < 32; i++) {
+    unsigned byte;
+    sscanf(hex + 2 * i, "%2x", &byte);
+    key[i] = (uint8_t)byte;
+  }
+}
+
+Test(token_address, curve) {
+  // Whether each key is an ed25519 point, as curve25519-dalek decides
+  static const struct {
+    const char *key;
+    bool on_curve;
+  } keys[] = {
+      {"0000000000000000000000000000000000000000000000000000000000000000",
+       true},
+      {"5866666666666666666666666666666666666666666666666666666666666666",
+       true},
+      {"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+       true},
+      {"edffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff7f",
+       true},
+      {"6e340b9cffb37a989ca544e6bb780a2c78901d3fb33738768511a30617afa01d",
+       false},
+      {"4bf5122f344554c53bde2ebb8cd2b7e3d1600ad631c385a5d7cce23c7785459a",
+       true},
+      {"dbc1b4c900ffe48d575b5da5c638040125f65db0fe3e24494b76ea986457d986",
+       false},
+      {"084fed08b978af4d7d196a7446a86b58009e636b611db16211b65a9aadff29c5",
+       true},
+      {"e52d9c508c502347344d8c07ad91cbd6068afc75ff6292f062a09ca381c89e71",
+       false},
+      {"e77b9a9ae9e30b0dbdb6f510a264ef9de781501d7b6b92ae89eb059c5ab743db",
+       false},
+      {"67586e98fad27da0b9968bc039a1ef34c939b9b8e523a8bef89d478608c5ecf6",
+       true},
+      {"ca358758f6d27e6cf45272937977a748fd88391db679ceda7dc7bf1f005ee879",
+       true},
+      {"beead77994cf573341ec17b58bbf7eb34d2711c993c1d976b128b3188dc1829a",
+       true},
+      {"2b4c342f5433ebe591a1da77e013d1b72475562d48578dca8b84bac6651c3cb9",
+       false},
+      {"01ba4719c80b6fe911b091a7c05124b64eeece964e09c058ef8f9805daca546b",
+       true},
+      {"e7cf46a078fed4fafd0b5e3aff144802b853f8ae459a4f0c14add3314b7cc3a6",
+       true},
+  };
+  for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+    uint8_t key[32];
+    hex_key(key, keys[i].key);
+    cr_assert(TokenAddress_is_on_curve(key) == keys[i].on_curve);
+  }
+}
+
+Test(token_address, create) {
+  uint8_t program_id[32];
+  for (int i = 0; i < 32; i++) {
+    program_id[i] = (uint8_t)(i + 1);
+  }
+  const uint8_t butter[] = "You pass butter";
+  TokenAddress_Seed seed_list[TokenAddress_MAX_SEEDS] = {
+      {butter, sizeof(butter) - 1}};
+  TokenAddress_Seeds seeds = {seed_list, 1};
+  uint8_t address[32];
+  uint8_t expected[32];
+  hex_key(expected,
+          "ed2c5fd547e093a5e49cdc7cb3d5710bad4fd0470a7c308e2748f2551a6c2a25");
+  cr_assert(TokenAddress_create(&seeds, 255, program_id, address));
+  cr_assert(0 == memcmp(address, expected, 32));
+  // The next bump gives an ed25519 point
+  cr_assert(!TokenAddress_create(&seeds, 254, program_id, address));
+
+  uint8_t found[1][32];
+  uint8_t found_bump;
+  cr_assert(TokenAddress_find_lanes(&seeds, 1, program_id, found,
+                                    &found_bump) == 1);
+  cr_assert(found_bump == 255);
+  cr_assert(0 == memcmp(found[0], expected, 32));
+
+  // Seeds past the limits are rejected
+  seed_list[0].len = TokenAddress_MAX_SEED_LEN + 1;
+  cr_assert(!TokenAddress_create(&seeds, 255, program_id, address));
+  cr_assert(TokenAddress_find_lanes(&seeds, 1, program_id, found,
+                                    &found_bump) == 0);
+  cr_assert(found_bump == 0);
+  for (int i = 0; i < TokenAddress_MAX_SEEDS; i++) {
+    seed_list[i] = (TokenAddress_Seed){butter, 1};
+  }
+  seeds.len = TokenAddress_MAX_SEEDS;
+  cr_assert(!TokenAddress_create(&seeds, 255, program_id, address));
+  seeds.len = TokenAddress_MAX_SEEDS - 1;
+  cr_assert(TokenAddress_find_lanes(&seeds, 1, program_id, found,
+                                    &found_bump) == 1);
+}
+
+static void wallet(uint8_t *key, uint32_t i) {
+  for (int j = 0; j < 32; j++) {
+    key[j] = (uint8_t)(i * 31 + j * 7);
+  }
+}
+
+static void mint(uint8_t *key, uint32_t i) { memset(key, i % 7 + 1, 32); }
+
+Test(token_address, associated) {
+  // `get_associated_token_address_and_bump_seed` of the first wallets
+  static const struct {
+    uint8_t address[32];
+    uint8_t bump;
+  } expected[] = {
+      {{0x6c, 0xc5, 0x14, 0xeb, 0x7a, 0xe9, 0x91, 0x12, 0x66, 0x5b,
+        0xac, 0x66, 0x11, 0x99, 0x25, 0x75, 0x8a, 0xd3, 0xf8, 0xc1,
+        0xc6, 0x76, 0x87, 0xa8, 0xc1, 0xa9, 0x0a, 0x9e, 0x73, 0xc4,
+        0xca, 0x3b},
+       253},
+      {{0x60, 0xe3, 0x81, 0x9c, 0xe4, 0x48, 0x80, 0xac, 0x8f, 0xe6,
+        0xdd, 0x94, 0x8c, 0xb1, 0x60, 0xff, 0x82, 0x1e, 0xe0, 0x6b,
+        0x67, 0x51, 0x55, 0x55, 0x10, 0x33, 0x5a, 0x04, 0xee, 0x85,
+        0xcb, 0x61},
+       254},
+      {{0x07, 0x1c, 0x9a, 0x25, 0x94, 0x44, 0x6a, 0xd9, 0x54, 0x82,
+        0x76, 0xc3, 0x94, 0x27, 0xf6, 0xd6, 0x09, 0xf5, 0x4c, 0x09,
+        0xbe, 0x4c, 0xc7, 0xa2, 0x44, 0xfc, 0x3c, 0xaf, 0x97, 0xb3,
+        0xad, 0xbb},
+       253},
+      {{0x81, 0x16, 0x92, 0x25, 0x92, 0x68, 0x1a, 0xdc, 0xd6, 0x02,
+        0x34, 0x79, 0x7e, 0x76, 0xef, 0x19, 0x8e, 0xbd, 0xa2, 0x3f,
+        0xce, 0x7d, 0x03, 0x56, 0xe3, 0xeb, 0x55, 0x21, 0xbb, 0xcc,
+        0xa9, 0x91},
+       252},
+      {{0xa1, 0xf2, 0x29, 0x71, 0x26, 0xc4, 0x16, 0x2a, 0x01, 0xd5,
+        0xb1, 0xd5, 0x32, 0xef, 0x87, 0x23, 0x64, 0x71, 0xe3, 0xc3,
+        0xfc, 0x0a, 0xf6, 0x9b, 0xb1, 0x1a, 0x75, 0xf1, 0x36, 0xfb,
+        0x25, 0x3b},
+       255},
+      {{0x03, 0x4f, 0xe5, 0xaa, 0xc3, 0x4a, 0x3a, 0x72, 0x4b, 0x49,
+        0xa6, 0x64, 0x53, 0xe3, 0x39, 0x68, 0x5a, 0x08, 0xef, 0x48,
+        0x09, 0xc9, 0x56, 0x94, 0x6a, 0x80, 0x57, 0x86, 0x3e, 0xcf,
+        0xfd, 0xfc},
+       254},
+  };
+  static uint8_t wallets[ADDRESSES][32];
+  static uint8_t mints[ADDRESSES][32];
+  static uint8_t addresses[ADDRESSES][32];
+  static uint8_t bumps[ADDRESSES];
+  for (uint32_t i = 0; i < ADDRESSES; i++) {
+    wallet(wallets[i], i);
+    mint(mints[i], i);
+  }
+  cr_assert(TokenAddress_associated_batch(wallets, mints, ADDRESSES, addresses,
+                                          bumps, 3) == ADDRESSES);
+  for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+    cr_assert(0 == memcmp(addresses[i], expected[i].address, 32));
+    cr_assert(bumps[i] == expected[i].bump);
+  }
+
+  // Every address matches its own derivation, whichever lane and thread
+  // computed it
+  for (uint32_t i = 0; i < ADDRESSES; i += 7) {
+    TokenAddress_Seed seed_list[] = {
+        {wallets[i], 32}, {TokenAddress_TOKEN_PROGRAM_ID, 32}, {mints[i], 32}};
+    TokenAddress_Seeds seeds = {seed_list, 3};
+    uint8_t address[32];
+    cr_assert(TokenAddress_create(&seeds, bumps[i],
+                                  TokenAddress_ASSOCIATED_TOKEN_PROGRAM_ID,
+                                  address));
+    cr_assert(0 == memcmp(address, addresses[i], 32));
+    cr_assert(bumps[i] == 255 ||
+              !TokenAddress_create(&seeds, bumps[i] + 1,
+                                   TokenAddress_ASSOCIATED_TOKEN_PROGRAM_ID,
+                                   address));
+  }
+}
@@ -0,0 +1,199 @@
+#include "token-cache.h"
+#include <criterion/criterion.h>
+#include <pthread.h>
+
+#define ACCOUNTS 64
+#define READERS 4
+#define WRITES 200000
+
+static void address(uint8_t *key, uint32_t n) {
+  memset(key, 0, 32);
+  key[0] = 'a';
+  memcpy(key + 1, &n, sizeof(n));
+}
+
+/// Account whose every field is derived from `n`, so that a record mixing
+/// two writes is detected
+static void account(uint8_t *data, uint64_t n) {
+  memset(data, 0, Token_Account_LEN);
+  memset(data + Token_Account_mint_OFFSET, (uint8_t)n, 32);
+  memset(data + Token_Account_owner_OFFSET, (uint8_t)(n >> 8), 32);
+  Token_Account_set_amount(data, n);
+  Token_Account_set_state(data, Token_AccountState_Initialized);
+  Token_Account_set_delegated_amount(data, 3 * n);
+}
+
+static void check_account(const uint8_t *data, uint64_t slot) {
+  uint64_t n = Token_Account_get_amount(data);
+  cr_assert(n == slot);
+  cr_assert(Token_Account_get_delegated_amount(data) == 3 * n);
+  for (int i = 0; i < 32; i++) {
+    cr_assert(data[Token_Account_mint_OFFSET + i] == (uint8_t)n);
+    cr_assert(data[Token_Account_owner_OFFSET + i] == (uint8_t)(n >> 8));
+  }
+}
+
+Test(token_cache, write_and_read) {
+  TokenCache cache;
+  cr_assert(TokenCache_init(&cache, ACCOUNTS));
+  uint8_t key[32];
+  uint8_t data[Token_Account_LEN];
+  uint8_t read[Token_Account_LEN];
+  uint64_t slot;
+
+  address(key, 1);
+  cr_assert(!TokenCache_read(&cache, key, read, &slot));
+  account(data, 10);
+  cr_assert(TokenCache_write(&cache, key, 10, data, sizeof(data)) ==
+            TokenCache_Result_Updated);
+  cr_assert(TokenCache_read(&cache, key, read, &slot));
+  cr_assert(slot == 10);
+  cr_assert(0 == memcmp(data, read, sizeof(data)));
+
+  TokenCache_Balance balance;
+  cr_assert(TokenCache_balance(&cache, key, &balance));
+  cr_assert(balance.amount == 10);
+  cr_assert(balance.delegated_amount == 30);
+  cr_assert(balance.state == Token_AccountState_Initialized);
+
+  // An earlier slot does not roll the account back
+  account(data, 9);
+  cr_assert(TokenCache_write(&cache, key, 9, data, sizeof(data)) ==
+            TokenCache_Result_Stale);
+  cr_assert(TokenCache_balance(&cache, key, &balance));
+  cr_assert(balance.amount == 10);
+
+  // Closing marks the account absent
+  cr_assert(TokenCache_write(&cache, key, 11, data, 0) ==
+            TokenCache_Result_Updated);
+  cr_assert(!TokenCache_read(&cache, key, read, &slot));
+
+  // So does data the program would not unpack, such as all zeroes
+  account(data, 12);
+  cr_assert(TokenCache_write(&cache, key, 12, data, sizeof(data)) ==
+            TokenCache_Result_Updated);
+  cr_assert(TokenCache_read(&cache, key, read, &slot));
+  memset(data, 0, sizeof(data));
+  cr_assert(TokenCache_write(&cache, key, 13, data, sizeof(data)) ==
+            TokenCache_Result_Updated);
+  cr_assert(!TokenCache_read(&cache, key, read, &slot));
+  cr_assert(cache.len == 1);
+  TokenCache_free(&cache);
+}
+
+Test(token_cache, full) {
+  TokenCache cache;
+  cr_assert(TokenCache_init(&cache, 8));
+  uint8_t key[32];
+  uint8_t data[Token_Account_LEN];
+  account(data, 1);
+  size_t written = 0;
+  for (uint32_t n = 0; n < 100; n++) {
+    address(key, n);
+    TokenCache_Result result =
+        TokenCache_write(&cache, key, 1, data, sizeof(data));
+    if (result == TokenCache_Result_Updated) {
+      written++;
+    } else {
+      cr_assert(result == TokenCache_Result_Full);
+    }
+  }
+  cr_assert(written == cache.capacity / 2);
+  // Cached accounts can still be updated
+  address(key, 0);
+  cr_assert(TokenCache_write(&cache, key, 2, data, sizeof(data)) ==
+            TokenCache_Result_Updated);
+  TokenCache_free(&cache);
+}
+
+typedef struct {
+  TokenCache *cache;
+  atomic_bool *done;
+  uint64_t reads;
+} Reader;
+
+static void *read_accounts(void *argument) {
+  Reader *reader = argument;
+  uint8_t key[32];
+  uint8_t data[Token_Account_LEN];
+  uint64_t slot;
+  uint32_t n = 0;
+  while (!atomic_load(reader->done)) {
+    address(key, n++ % ACCOUNTS);
+    if (TokenCache_read(reader->cache, key, data, &slot)) {
+      check_account(data, slot);
+      reader->reads++;
+    }
+  }
+  return NULL;
+}
+
+Test(token_cache, readers_never_see_torn_records) {
+  TokenCache cache;
+  cr_assert(TokenCache_init(&cache, ACCOUNTS));
+  atomic_bool done;
+  atomic_init(&done, false);
+  pthread_t threads[READERS];
+  Reader readers[READERS];
+  for (int i = 0; i < READERS; i++) {
+    readers[i] = (Reader){&cache, &done, 0};
+    cr_assert(0 == pthread_create(&threads[i], NULL, read_accounts,
+                                  &readers[i]));
+  }
+
+  uint8_t key[32];
+  uint8_t data[Token_Account_LEN];
+  for (uint64_t slot = 1; slot <= WRITES; slot++) {
+    address(key, slot % ACCOUNTS);
+    account(data, slot);
+    cr_assert(TokenCache_write(&cache, key, slot, data, sizeof(data)) ==
+              TokenCache_Result_Updated);
+  }
+  atomic_store(&done, true);
+  uint64_t reads = 0;
+  for (int i = 0; i < READERS; i++) {
+    pthread_join(threads[i], NULL);
+    reads += readers[i].reads;
+  }
+  cr_assert(reads > 0);
+
+  uint64_t slot;
+  for (uint32_t n = 0; n < ACCOUNTS; n++) {
+    address(key, n);
+    cr_assert(TokenCache_read(&cache, key, data, &slot));
+    check_account(data, slot);
+    cr_assert(slot > WRITES - ACCOUNTS);
+  }
+  TokenCache_free(&cache);
+}
+
+Test(token_cache, seeded_hash_spreads_colliding_addresses) {
+  TokenCache cache;
+  TokenCache other;
+  cr_assert(TokenCache_init(&cache, 512));
+  cr_assert(TokenCache_init(&other, 512));
+  cr_assert(0 != memcmp(&cache.seed, &other.seed, sizeof(cache.seed)));
+
+  // Addresses whose words fold to the same `SplPubkey_hash` would share one
+  // probe run, each read copying every record before its own
+  uint8_t data[Token_Account_LEN];
+  account(data, 1);
+  size_t mask = cache.capacity - 1;
+  uint64_t displacement = 0;
+  for (uint64_t i = 0; i < 512; i++) {
+    uint64_t words[4] = {i, i, 0, 0};
+    uint8_t key[32];
+    memcpy(key, words, sizeof(key));
+    cr_assert(SplPubkey_hash(key) == SplPubkey_hash((uint8_t[32]){0}));
+    cr_assert(TokenCache_write(&cache, key, 1, data, sizeof(data)) ==
+              TokenCache_Result_Updated);
+    size_t home = TokenHash_pubkey(&cache.seed, key, 0) & mask;
+    size_t index = (size_t)(TokenCache_entry(&cache, key) - cache.entries);
+    displacement += (index - home) & mask;
+  }
+  // Half full with random home slots, an entry is on average under one slot
+  // past its home
+  cr_assert(displacement < 4 * 512);
+  TokenCache_free(&cache);
+  TokenCache_free(&other);
+}
@@ -0,0 +1,109 @@
+#include "token-compact.h"
+#include <criterion/criterion.h>
+
+/// Random valid packed account, with `None` payloads zeroed like `pack` does
+static void random_account(uint8_t *data) {
+  for (int i = 0; i < Token_Account_LEN; i++) {
+    data[i] = (uint8_t)rand();
+  }
+  uint8_t key[32];
+  for (int i = 0; i < 32; i++) {
+    key[i] = (uint8_t)rand();
+  }
+  uint64_t reserve = (uint64_t)rand() << 20;
+  Token_Account_set_delegate(data, rand() % 2 ? key : NULL);
+  Token_Account_set_state(data, rand() % 3);
+  Token_Account_set_is_native(data, rand() % 2 ? &reserve : NULL);
+  Token_Account_set_close_authority(data, rand() % 2 ? key : NULL);
+  if (Token_Account_get_delegate(data) == NULL) {
+    memset(data + Token_Account_delegate_OFFSET + 4, 0, 32);
+  }
+  if (!Token_Account_get_is_native(data, &reserve)) {
+    memset(data + Token_Account_is_native_OFFSET + 4, 0, 8);
+  }
+  if (Token_Account_get_close_authority(data) == NULL) {
+    memset(data + Token_Account_close_authority_OFFSET + 4, 0, 32);
+  }
+}
+
+Test(token_compact, smaller_than_bindings) {
+  cr_assert(sizeof(TokenCompact_Account) == 160);
+  cr_assert(sizeof(TokenCompact_Account) < sizeof(Token_Account));
+}
+
+Test(token_compact, packed_round_trip) {
+  srand(1);
+  for (int round = 0; round < 10000; round++) {
+    uint8_t data[Token_Account_LEN];
+    uint8_t packed[Token_Account_LEN];
+    random_account(data);
+    TokenCompact_Account account = {0};
+    cr_assert(TokenCompact_Account_unpack(&account, data, sizeof(data)));
+    TokenCompact_Account_pack(&account, packed);
+    cr_assert(0 == memcmp(data, packed, sizeof(data)));
+
+    cr_assert(account.amount == Token_Account_get_amount(data));
+    cr_assert(0 == memcmp(account.owner, Token_Account_get_owner(data), 32));
+    const uint8_t *delegate = Token_Account_get_delegate(data);
+    if (delegate == NULL) {
+      cr_assert(TokenCompact_Account_delegate(&account) == NULL);
+    } else {
+      cr_assert(0 ==
+                memcmp(TokenCompact_Account_delegate(&account), delegate, 32));
+    }
+  }
+}
+
+Test(token_compact, none_payloads_are_zero) {
+  uint8_t data[Token_Account_LEN];
+  memset(data, 0xab, sizeof(data));
+  Token_Account_set_delegate(data, NULL);
+  Token_Account_set_state(data, Token_AccountState_Initialized);
+  Token_Account_set_is_native(data, NULL);
+  Token_Account_set_close_authority(data, NULL);
+
+  TokenCompact_Account account;
+  memset(&account, 0xcd, sizeof(account));
+  cr_assert(TokenCompact_Account_unpack(&account, data, sizeof(data)));
+  cr_assert(account.flags == 0);
+  cr_assert(account.native_reserve == 0);
+  for (int i = 0; i < 32; i++) {
+    cr_assert(account.delegate[i] == 0);
+    cr_assert(account.close_authority[i] == 0);
+  }
+}
+
+Test(token_compact, rejects_invalid) {
+  uint8_t data[Token_Account_LEN];
+  srand(2);
+  random_account(data);
+  TokenCompact_Account account;
+  cr_assert(!TokenCompact_Account_unpack(&account, data, sizeof(data) - 1));
+  data[Token_Account_state_OFFSET] = 3;
+  cr_assert(!TokenCompact_Account_unpack(&account, data, sizeof(data)));
+  random_account(data);
+  Token_write_u32(data + Token_Account_delegate_OFFSET, 2);
+  cr_assert(!TokenCompact_Account_unpack(&account, data, sizeof(data)));
+}
+
+Test(token_compact, bindings_round_trip) {
+  srand(3);
+  for (int round = 0; round < 1000; round++) {
+    uint8_t data[Token_Account_LEN];
+    random_account(data);
+    TokenCompact_Account account = {0};
+    TokenCompact_Account another = {0};
+    Token_Account bindings;
+    cr_assert(TokenCompact_Account_unpack(&account, data, sizeof(data)));
+    TokenCompact_Account_to_bindings(&account, &bindings);
+
+    cr_assert(bindings.amount == account.amount);
+    cr_assert((bindings.delegate.tag == Token_COption_Pubkey_Some_Pubkey) ==
+              ((account.flags & TokenCompact_HAS_DELEGATE) != 0));
+    cr_assert((bindings.is_native.tag == Token_COption_u64_Some_u64) ==
+              ((account.flags & TokenCompact_IS_NATIVE) != 0));
+
+    TokenCompact_Account_from_bindings(&another, &bindings);
+    cr_assert(0 == memcmp(&account, &another, sizeof(account)));
+  }
+}
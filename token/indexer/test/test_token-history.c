@@ -0,0 +1,202 @@
+#include "token-history.h"
+#include <criterion/criterion.h>
+
+#define BLOCKS 500
+#define INSTRUCTIONS 20
+#define ACCOUNTS 16
+
+Test(token_history, decode) {
+  Token_TokenInstruction instruction;
+  uint8_t data[70] = {0};
+
+  data[0] = Token_TokenInstruction_Transfer;
+  Token_write_u64(data + 1, 42);
+  cr_assert(TokenHistory_decode(data, 9, &instruction));
+  cr_assert(instruction.tag == Token_TokenInstruction_Transfer);
+  cr_assert(instruction.transfer.amount == 42);
+  // Trailing bytes are ignored, as by the program
+  cr_assert(TokenHistory_decode(data, 20, &instruction));
+  cr_assert(!TokenHistory_decode(data, 8, &instruction));
+
+  data[0] = Token_TokenInstruction_BurnChecked;
+  data[9] = 6;
+  cr_assert(TokenHistory_decode(data, 10, &instruction));
+  cr_assert(instruction.burn_checked.amount == 42);
+  cr_assert(instruction.burn_checked.decimals == 6);
+  cr_assert(!TokenHistory_decode(data, 9, &instruction));
+
+  data[0] = Token_TokenInstruction_SetAuthority;
+  data[1] = Token_AuthorityType_CloseAccount;
+  data[2] = 0;
+  cr_assert(TokenHistory_decode(data, 3, &instruction));
+  cr_assert(instruction.set_authority.new_authority.tag ==
+            Token_COption_Pubkey_None_Pubkey);
+  data[2] = 1;
+  memset(data + 3, 7, 32);
+  cr_assert(!TokenHistory_decode(data, 34, &instruction));
+  cr_assert(TokenHistory_decode(data, 35, &instruction));
+  cr_assert(instruction.set_authority.new_authority.tag ==
+            Token_COption_Pubkey_Some_Pubkey);
+  cr_assert(instruction.set_authority.new_authority.some[31] == 7);
+  data[2] = 2;
+  cr_assert(!TokenHistory_decode(data, 35, &instruction));
+  data[1] = Token_AuthorityType_CloseAccount + 1;
+  data[2] = 0;
+  cr_assert(!TokenHistory_decode(data, 3, &instruction));
+
+  data[0] = Token_TokenInstruction_InitializeMint;
+  data[1] = 9;
+  data[34] = 0;
+  cr_assert(TokenHistory_decode(data, 35, &instruction));
+  cr_assert(instruction.initialize_mint.decimals == 9);
+  cr_assert(instruction.initialize_mint.freeze_authority.tag ==
+            Token_COption_Pubkey_None_Pubkey);
+  data[34] = 1;
+  cr_assert(!TokenHistory_decode(data, 66, &instruction));
+  cr_assert(TokenHistory_decode(data, 67, &instruction));
+
+  data[0] = Token_TokenInstruction_CloseAccount;
+  cr_assert(TokenHistory_decode(data, 1, &instruction));
+  data[0] = Token_TokenInstruction_InitializeAccount2 + 1;
+  cr_assert(!TokenHistory_decode(data, 70, &instruction));
+  cr_assert(!TokenHistory_decode(data, 0, &instruction));
+}
+
+static uint8_t keys[ACCOUNTS][32];
+
+typedef struct {
+  TokenHistory_Block block;
+  TokenHistory_Instruction instructions[INSTRUCTIONS];
+  uint8_t data[INSTRUCTIONS][10];
+  uint8_t accounts[INSTRUCTIONS][3][32];
+} TestBlock;
+
+typedef struct {
+  TestBlock *blocks;
+  int fetched;
+  int applied;
+  int stop_at;
+  int released;
+  /// Balances applied by the pipeline and computed serially
+  int64_t balances[ACCOUNTS];
+  int64_t expected[ACCOUNTS];
+} History;
+
+static void random_block(TestBlock *test, uint64_t slot, History *history) {
+  test->block.slot = slot;
+  test->block.instructions = test->instructions;
+  test->block.instructions_len = INSTRUCTIONS;
+  for (int i = 0; i < INSTRUCTIONS; i++) {
+    static const uint8_t tags[] = {
+        Token_TokenInstruction_Transfer, Token_TokenInstruction_TransferChecked,
+        Token_TokenInstruction_MintTo, Token_TokenInstruction_BurnChecked,
+        Token_TokenInstruction_Approve};
+    uint8_t tag = tags[rand() % sizeof(tags)];
+    uint64_t amount = rand() % 1000;
+    int a = rand() % ACCOUNTS;
+    int b = rand() % ACCOUNTS;
+    test->data[i][0] = tag;
+    Token_write_u64(test->data[i] + 1, amount);
+    test->data[i][9] = 2;
+    memcpy(test->accounts[i][0], keys[a], 32);
+    memcpy(test->accounts[i][1], keys[b], 32);
+    memcpy(test->accounts[i][2], keys[b], 32);
+    test->instructions[i] = (TokenHistory_Instruction){
+        .data = test->data[i],
+        .data_len = rand() % 20 == 0 ? 5 : 10,
+        .accounts = test->accounts[i],
+        .accounts_len = 3,
+    };
+    if (test->instructions[i].data_len < 9) {
+      continue;
+    }
+    switch (tag) {
+    case Token_TokenInstruction_Transfer:
+    case Token_TokenInstruction_TransferChecked:
+      history->expected[a] -= amount;
+      history->expected[b] += amount;
+      break;
+    case Token_TokenInstruction_MintTo:
+      history->expected[b] += amount;
+      break;
+    case Token_TokenInstruction_BurnChecked:
+      history->expected[a] -= amount;
+      break;
+    }
+  }
+}
+
+static bool fetch(void *context, TokenHistory_Block **block) {
+  History *history = context;
+  if (history->fetched == BLOCKS) {
+    return false;
+  }
+  *block = &history->blocks[history->fetched++].block;
+  return true;
+}
+
+static bool apply(void *context, TokenHistory_Block *block) {
+  History *history = context;
+  cr_assert(block->slot == (uint64_t)history->applied);
+  for (uint64_t i = 0; i < block->instructions_len; i++) {
+    TokenHistory_Delta deltas[2];
+    size_t count = TokenHistory_deltas(&block->instructions[i], deltas);
+    for (size_t d = 0; d < count; d++) {
+      int account = deltas[d].account[0];
+      history->balances[account] +=
+          deltas[d].credit ? (int64_t)deltas[d].amount
+                           : -(int64_t)deltas[d].amount;
+    }
+  }
+  history->applied++;
+  return history->applied != history->stop_at;
+}
+
+static void release(void *context, TokenHistory_Block *block) {
+  History *history = context;
+  cr_assert(block->slot >= (uint64_t)history->applied);
+  history->released++;
+}
+
+static void random_history(History *history) {
+  static TestBlock blocks[BLOCKS];
+  memset(history, 0, sizeof(*history));
+  history->blocks = blocks;
+  history->stop_at = -1;
+  for (int i = 0; i < ACCOUNTS; i++) {
+    memset(keys[i], i, 32);
+  }
+  for (int i = 0; i < BLOCKS; i++) {
+    random_block(&blocks[i], i, history);
+  }
+}
+
+Test(token_history, applies_in_order) {
+  const int decoders[] = {1, 2, 4, 8};
+  const uint64_t depths[] = {1, 3, 0};
+  srand(1);
+  for (int d = 0; d < 4; d++) {
+    for (int p = 0; p < 3; p++) {
+      History history;
+      random_history(&history);
+      TokenHistory_Stages stages = {fetch, apply, release, &history};
+      cr_assert(TokenHistory_run(&stages, decoders[d], depths[p]));
+      cr_assert(history.applied == BLOCKS);
+      cr_assert(history.released == 0);
+      cr_assert(0 == memcmp(history.balances, history.expected,
+                            sizeof(history.balances)));
+    }
+  }
+}
+
+Test(token_history, apply_stops) {
+  srand(2);
+  History history;
+  random_history(&history);
+  history.stop_at = 100;
+  TokenHistory_Stages stages = {fetch, apply, release, &history};
+  cr_assert(!TokenHistory_run(&stages, 4, 8));
+  cr_assert(history.applied == 100);
+  cr_assert(history.applied + history.released == history.fetched);
+  cr_assert(history.fetched <= 100 + 8 + 1);
+}
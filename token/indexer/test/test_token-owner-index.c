@@ -0,0 +1,164 @@
+#include "token-owner-index.h"
+#include <criterion/criterion.h>
+
+#define ADDRESSES 2000
+#define OWNERS 40
+#define MINTS 8
+
+static void key(uint8_t *key, uint8_t kind, uint32_t n) {
+  memset(key, 0, 32);
+  key[0] = kind;
+  memcpy(key + 1, &n, sizeof(n));
+}
+
+static void account(uint8_t *data, uint32_t owner, uint32_t mint) {
+  memset(data, 0, Token_Account_LEN);
+  uint8_t k[32];
+  key(k, 'm', mint);
+  Token_Account_set_mint(data, k);
+  key(k, 'o', owner);
+  Token_Account_set_owner(data, k);
+  Token_Account_set_amount(data, rand());
+  Token_Account_set_state(data, Token_AccountState_Initialized);
+}
+
+/// Owner and mint of every address, or -1 once it is not an account
+static int model_owner[ADDRESSES];
+static int model_mint[ADDRESSES];
+
+static void check_pair(const TokenOwnerIndex *index, int owner, int mint) {
+  static uint8_t found[ADDRESSES][32];
+  uint8_t o[32];
+  uint8_t m[32];
+  key(o, 'o', owner);
+  key(m, 'm', mint);
+  size_t count = TokenOwnerIndex_find(index, o, m, found, ADDRESSES);
+  size_t expected = 0;
+  for (int a = 0; a < ADDRESSES; a++) {
+    expected += model_owner[a] == owner && model_mint[a] == mint;
+  }
+  cr_assert(count == expected);
+  for (size_t i = 0; i < count; i++) {
+    uint32_t a;
+    cr_assert(found[i][0] == 'a');
+    memcpy(&a, found[i] + 1, sizeof(a));
+    cr_assert(model_owner[a] == owner && model_mint[a] == mint);
+  }
+}
+
+Test(token_owner_index, random_writes) {
+  TokenOwnerIndex index;
+  cr_assert(TokenOwnerIndex_init(&index, 0));
+  for (int a = 0; a < ADDRESSES; a++) {
+    model_owner[a] = -1;
+    model_mint[a] = -1;
+  }
+  srand(1);
+  for (int round = 0; round < 50000; round++) {
+    uint32_t a = rand() % ADDRESSES;
+    uint8_t address[32];
+    uint8_t data[Token_Account_LEN];
+    key(address, 'a', a);
+    switch (rand() % 8) {
+    case 0:
+      // Closed
+      cr_assert(TokenOwnerIndex_update(&index, address, data, 0));
+      model_owner[a] = model_mint[a] = -1;
+      break;
+    case 1:
+      account(data, 0, 0);
+      Token_Account_set_state(data, Token_AccountState_Uninitialized);
+      cr_assert(TokenOwnerIndex_update(&index, address, data, sizeof(data)));
+      model_owner[a] = model_mint[a] = -1;
+      break;
+    default: {
+      int owner = rand() % OWNERS;
+      int mint = rand() % MINTS;
+      account(data, owner, mint);
+      if (rand() % 4 == 0) {
+        Token_Account_set_state(data, Token_AccountState_Frozen);
+      }
+      cr_assert(TokenOwnerIndex_update(&index, address, data, sizeof(data)));
+      model_owner[a] = owner;
+      model_mint[a] = mint;
+    }
+    }
+    if (round % 5000 == 0) {
+      for (int owner = 0; owner < OWNERS; owner++) {
+        for (int mint = 0; mint < MINTS; mint++) {
+          check_pair(&index, owner, mint);
+        }
+      }
+    }
+  }
+
+  size_t indexed = 0;
+  for (int a = 0; a < ADDRESSES; a++) {
+    indexed += model_owner[a] >= 0;
+  }
+  cr_assert(TokenOwnerIndex_len(&index) == indexed);
+  cr_assert(index.pairs.len == indexed);
+  for (int owner = 0; owner < OWNERS; owner++) {
+    for (int mint = 0; mint < MINTS; mint++) {
+      check_pair(&index, owner, mint);
+    }
+  }
+  TokenOwnerIndex_free(&index);
+}
+
+Test(token_owner_index, find_limits_output) {
+  TokenOwnerIndex index;
+  cr_assert(TokenOwnerIndex_init(&index, 4));
+  uint8_t data[Token_Account_LEN];
+  uint8_t address[32];
+  account(data, 1, 2);
+  for (uint32_t a = 0; a < 100; a++) {
+    key(address, 'a', a);
+    cr_assert(TokenOwnerIndex_update(&index, address, data, sizeof(data)));
+  }
+  uint8_t found[3][32];
+  uint8_t owner[32];
+  uint8_t mint[32];
+  key(owner, 'o', 1);
+  key(mint, 'm', 2);
+  cr_assert(TokenOwnerIndex_find(&index, owner, mint, found, 3) == 100);
+  key(mint, 'm', 3);
+  cr_assert(TokenOwnerIndex_find(&index, owner, mint, found, 3) == 0);
+
+  for (uint32_t a = 0; a < 100; a++) {
+    key(address, 'a', a);
+    TokenOwnerIndex_remove(&index, address);
+  }
+  cr_assert(TokenOwnerIndex_len(&index) == 0);
+  key(mint, 'm', 2);
+  cr_assert(TokenOwnerIndex_find(&index, owner, mint, found, 3) == 0);
+  TokenOwnerIndex_free(&index);
+}
+
+Test(token_owner_index, seeded_hashes_spread_colliding_keys) {
+  TokenOwnerIndex index;
+  TokenOwnerIndex other;
+  cr_assert(TokenOwnerIndex_init(&index, 0));
+  cr_assert(TokenOwnerIndex_init(&other, 0));
+  cr_assert(0 != memcmp(&index.seed, &other.seed, sizeof(index.seed)));
+
+  // Owners whose words fold to the same `SplPubkey_hash` still spread over
+  // the table's home slots
+  static bool used[1024];
+  size_t slots = 0;
+  uint8_t mint[32];
+  key(mint, 'm', 1);
+  for (uint64_t i = 0; i < 1024; i++) {
+    uint64_t words[4] = {i, i, 0, 0};
+    uint8_t owner[32];
+    memcpy(owner, words, sizeof(owner));
+    cr_assert(SplPubkey_hash(owner) == SplPubkey_hash((uint8_t[32]){0}));
+    size_t slot = TokenOwnerIndex_pair_hash(&index, owner, mint) & 1023;
+    slots += !used[slot];
+    used[slot] = true;
+  }
+  // 1024 random slots cover about 1 - 1/e of them
+  cr_assert(slots > 550);
+  TokenOwnerIndex_free(&index);
+  TokenOwnerIndex_free(&other);
+}
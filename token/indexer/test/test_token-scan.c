@@ -0,0 +1,146 @@
+#include "token-scan.h"
+#include <criterion/criterion.h>
+
+#define RECORDS 20000
+#define MINTS 50
+
+static uint8_t records[RECORDS * Token_Account_LEN];
+
+static void random_records(void) {
+  for (int i = 0; i < RECORDS; i++) {
+    uint8_t *record = records + Token_Account_LEN * i;
+    memset(record, 0, Token_Account_LEN);
+    uint8_t mint[32] = {1 + rand() % MINTS, 7};
+    Token_Account_set_mint(record, mint);
+    Token_Account_set_amount(record, rand() % 4 == 0 ? 0 : (uint64_t)rand() << 20);
+    Token_Account_set_delegated_amount(record, rand() % 100);
+    Token_Account_set_state(record, rand() % 10 == 0
+                                        ? Token_AccountState_Frozen
+                                        : Token_AccountState_Initialized);
+    if (rand() % 50 == 0) {
+      Token_Account_set_state(record, Token_AccountState_Uninitialized);
+    } else if (rand() % 50 == 0) {
+      record[Token_Account_state_OFFSET] = 7;
+    }
+  }
+}
+
+static void assert_same(const TokenScan_Map *one, const TokenScan_Map *two) {
+  cr_assert(one->len == two->len);
+  for (size_t i = 0; i < one->capacity; i++) {
+    const TokenScan_MintTotals *a = &one->slots[i];
+    if (a->accounts == 0) {
+      continue;
+    }
+    const TokenScan_MintTotals *b = TokenScan_Map_find(two, a->mint);
+    cr_assert(NULL != b);
+    cr_assert(a->accounts == b->accounts);
+    cr_assert(a->holders == b->holders);
+    cr_assert(a->amount == b->amount);
+    cr_assert(a->delegated_amount == b->delegated_amount);
+  }
+}
+
+Test(token_scan, parallel_matches_sequential) {
+  srand(5);
+  random_records();
+
+  TokenScan_Map expected;
+  cr_assert(TokenScan_Map_init(&expected, 0));
+  uint64_t accounts = 0;
+  for (int i = 0; i < RECORDS; i++) {
+    const uint8_t *record = records + Token_Account_LEN * i;
+    if (Token_Account_is_valid(record, Token_Account_LEN) &&
+        Token_Account_get_state(record) != Token_AccountState_Uninitialized) {
+      accounts++;
+    }
+    // A run of one record at a time
+    cr_assert(TokenScan_records(&expected, record, 1));
+  }
+  cr_assert(MINTS == expected.len);
+
+  int threads[] = {1, 2, 8};
+  uint64_t chunk_lens[] = {1, 7, 0};
+  for (int t = 0; t < 3; t++) {
+    for (int c = 0; c < 3; c++) {
+      TokenScan_Map totals;
+      cr_assert(TokenScan_Map_init(&totals, 0));
+      cr_assert(TokenScan_run(records, RECORDS, threads[t], chunk_lens[c],
+                              &totals));
+      assert_same(&expected, &totals);
+      uint64_t total_accounts = 0;
+      for (size_t i = 0; i < totals.capacity; i++) {
+        total_accounts += totals.slots[i].accounts;
+      }
+      cr_assert(accounts == total_accounts);
+      TokenScan_Map_free(&totals);
+    }
+  }
+  TokenScan_Map_free(&expected);
+}
+
+Test(token_scan, supply_audit) {
+  uint8_t accounts[3 * Token_Account_LEN] = {0};
+  uint8_t mint[32] = {3};
+  for (int i = 0; i < 3; i++) {
+    uint8_t *record = accounts + Token_Account_LEN * i;
+    Token_Account_set_mint(record, mint);
+    Token_Account_set_amount(record, 10 * (i + 1));
+    Token_Account_set_state(record, Token_AccountState_Initialized);
+  }
+  TokenScan_Map totals;
+  cr_assert(TokenScan_Map_init(&totals, 0));
+  cr_assert(TokenScan_run(accounts, 3, 4, 1, &totals));
+
+  uint8_t mint_data[Token_Mint_LEN] = {0};
+  Token_Mint_set_supply(mint_data, 60);
+  cr_assert(TokenScan_supply_matches(&totals, mint, mint_data));
+  Token_Mint_set_supply(mint_data, 61);
+  cr_assert(!TokenScan_supply_matches(&totals, mint, mint_data));
+
+  uint8_t other[32] = {4};
+  Token_Mint_set_supply(mint_data, 0);
+  cr_assert(TokenScan_supply_matches(&totals, other, mint_data));
+
+  const TokenScan_MintTotals *found = TokenScan_Map_find(&totals, mint);
+  cr_assert(3 == found->accounts);
+  cr_assert(3 == found->holders);
+  TokenScan_Map_free(&totals);
+}
+
+Test(token_scan, empty) {
+  TokenScan_Map totals;
+  cr_assert(TokenScan_Map_init(&totals, 0));
+  cr_assert(TokenScan_run(records, 0, 4, 0, &totals));
+  cr_assert(0 == totals.len);
+  TokenScan_Map_free(&totals);
+}
+
+Test(token_scan, seeded_hash_spreads_colliding_mints) {
+  TokenScan_Map totals;
+  cr_assert(TokenScan_Map_init(&totals, 1024));
+  size_t mask = totals.capacity - 1;
+  uint64_t displacement = 0;
+  // Mints whose words fold to the same `SplPubkey_hash` would share one
+  // probe run, each added record walking all of it
+  for (uint64_t i = 0; i < 512; i++) {
+    uint64_t words[4] = {i, i, 0, 0};
+    TokenScan_MintTotals mint = {{0}, 1, 1, i, 0};
+    memcpy(mint.mint, words, sizeof(mint.mint));
+    cr_assert(SplPubkey_hash(mint.mint) == SplPubkey_hash((uint8_t[32]){0}));
+    cr_assert(TokenScan_Map_add(&totals, &mint));
+  }
+  cr_assert(totals.capacity == mask + 1);
+  for (uint64_t i = 0; i < 512; i++) {
+    uint64_t words[4] = {i, i, 0, 0};
+    const TokenScan_MintTotals *found =
+        TokenScan_Map_find(&totals, (const uint8_t *)words);
+    cr_assert(NULL != found && found->amount == i);
+    size_t home = TokenHash_pubkey(&totals.seed, found->mint, 0) & mask;
+    displacement += ((size_t)(found - totals.slots) - home) & mask;
+  }
+  // At most half full with random home slots, an entry is on average under
+  // one slot past its home
+  cr_assert(displacement < 4 * 512);
+  TokenScan_Map_free(&totals);
+}
@@ -0,0 +1,191 @@
+#include "token-snapshot.h"
+#include <criterion/criterion.h>
+
+/// Appends an input record for an initialized account
+static void add_account(uint8_t *inputs, uint64_t index, uint8_t key,
+                        uint8_t mint, uint8_t owner, uint64_t amount) {
+  uint8_t *input = inputs + TokenSnapshot_INPUT_RECORD_LEN * index;
+  memset(input, 0, TokenSnapshot_INPUT_RECORD_LEN);
+  input[0] = key;
+  uint8_t *data = input + 32;
+  uint8_t mint_key[32] = {mint};
+  uint8_t owner_key[32] = {owner};
+  Token_Account_set_mint(data, mint_key);
+  Token_Account_set_owner(data, owner_key);
+  Token_Account_set_amount(data, amount);
+  Token_Account_set_state(data, Token_AccountState_Initialized);
+}
+
+/// Writes `inputs` to a temporary file and maps it back
+static void write_and_map(TokenSnapshot *snapshot, const uint8_t *inputs,
+                          uint64_t count, uint64_t *skipped) {
+  char path[] = "/tmp/token-snapshot-XXXXXX";
+  int fd = mkstemp(path);
+  cr_assert(fd >= 0);
+  FILE *out = fdopen(fd, "wb");
+  cr_assert(TokenSnapshot_write(out, inputs, count, skipped));
+  cr_assert(0 == fclose(out));
+  cr_assert(TokenSnapshot_map(snapshot, path));
+  unlink(path);
+}
+
+Test(token_snapshot, columns) {
+  uint8_t inputs[TokenSnapshot_INPUT_RECORD_LEN * 5];
+  add_account(inputs, 0, 1, 9, 3, 100);
+  add_account(inputs, 1, 2, 7, 4, 20);
+  add_account(inputs, 2, 3, 9, 1, 5);
+  add_account(inputs, 3, 4, 8, 2, 0);
+  add_account(inputs, 4, 5, 9, 2, UINT64_MAX - 105);
+  TokenSnapshot snapshot;
+  uint64_t skipped;
+  write_and_map(&snapshot, inputs, 5, &skipped);
+
+  cr_assert(0 == skipped);
+  cr_assert(5 == snapshot.count);
+  cr_assert(3 == snapshot.mint_count);
+  cr_assert(0 == (uint64_t)snapshot.amounts % sizeof(uint64_t));
+
+  // Rows are sorted by mint, then owner
+  uint8_t expected_keys[] = {2, 4, 3, 5, 1};
+  for (uint64_t row = 0; row < snapshot.count; row++) {
+    cr_assert(expected_keys[row] == snapshot.keys[row][0]);
+    const uint8_t *record = TokenSnapshot_record(&snapshot, row);
+    cr_assert(0 == memcmp(snapshot.mints[row], Token_Account_get_mint(record), 32));
+    cr_assert(0 == memcmp(snapshot.owners[row], Token_Account_get_owner(record), 32));
+    cr_assert(snapshot.amounts[row] == Token_Account_get_amount(record));
+  }
+
+  uint8_t mint[32] = {9};
+  const TokenSnapshot_MintRange *range = TokenSnapshot_find_mint(&snapshot, mint);
+  cr_assert(NULL != range);
+  cr_assert(2 == range->first);
+  cr_assert(3 == range->count);
+  uint64_t total;
+  cr_assert(TokenSnapshot_mint_total(&snapshot, mint, &total));
+  cr_assert(UINT64_MAX == total);
+
+  mint[0] = 6;
+  cr_assert(NULL == TokenSnapshot_find_mint(&snapshot, mint));
+  cr_assert(TokenSnapshot_mint_total(&snapshot, mint, &total));
+  cr_assert(0 == total);
+  TokenSnapshot_unmap(&snapshot);
+}
+
+Test(token_snapshot, total_overflow) {
+  uint8_t inputs[TokenSnapshot_INPUT_RECORD_LEN * 2];
+  add_account(inputs, 0, 1, 9, 1, UINT64_MAX);
+  add_account(inputs, 1, 2, 9, 2, 1);
+  TokenSnapshot snapshot;
+  write_and_map(&snapshot, inputs, 2, NULL);
+  uint8_t mint[32] = {9};
+  uint64_t total;
+  cr_assert(!TokenSnapshot_mint_total(&snapshot, mint, &total));
+  TokenSnapshot_unmap(&snapshot);
+}
+
+Test(token_snapshot, invalid_records_are_skipped) {
+  uint8_t inputs[TokenSnapshot_INPUT_RECORD_LEN * 4];
+  add_account(inputs, 0, 1, 9, 1, 1);
+  add_account(inputs, 1, 2, 9, 2, 2);
+  add_account(inputs, 2, 3, 9, 3, 3);
+  add_account(inputs, 3, 4, 9, 4, 4);
+  inputs[TokenSnapshot_INPUT_RECORD_LEN + 32 + Token_Account_state_OFFSET] = 3;
+  // Uninitialized accounts unpack unchecked but not with `unpack`
+  inputs[TokenSnapshot_INPUT_RECORD_LEN * 3 + 32 + Token_Account_state_OFFSET] =
+      Token_AccountState_Uninitialized;
+  TokenSnapshot snapshot;
+  uint64_t skipped;
+  write_and_map(&snapshot, inputs, 4, &skipped);
+  cr_assert(2 == skipped);
+  cr_assert(2 == snapshot.count);
+  TokenSnapshot_unmap(&snapshot);
+}
+
+Test(token_snapshot, empty) {
+  TokenSnapshot snapshot;
+  write_and_map(&snapshot, NULL, 0, NULL);
+  cr_assert(0 == snapshot.count);
+  cr_assert(0 == snapshot.mint_count);
+  uint8_t mint[32] = {0};
+  cr_assert(NULL == TokenSnapshot_find_mint(&snapshot, mint));
+  TokenSnapshot_unmap(&snapshot);
+}
+
+Test(token_snapshot, corrupt_headers_are_rejected) {
+  static uint64_t data[4096];
+  uint8_t *bytes = (uint8_t *)data;
+  TokenSnapshot_Header header;
+  TokenSnapshot_Header_init(&header, 2, 1);
+  TokenSnapshot snapshot;
+  TokenSnapshot_MintRange range = {.first = 0, .count = 2};
+  memcpy(bytes + header.index_offset, &range, sizeof(range));
+
+  memcpy(bytes, &header, sizeof(header));
+  cr_assert(TokenSnapshot_open(&snapshot, bytes, header.len));
+  cr_assert(!TokenSnapshot_open(&snapshot, bytes, header.len - 1));
+
+  TokenSnapshot_Header bad = header;
+  bad.record_len = Token_Mint_LEN;
+  memcpy(bytes, &bad, sizeof(bad));
+  cr_assert(!TokenSnapshot_open(&snapshot, bytes, sizeof(data)));
+
+  bad = header;
+  bad.amounts_offset += 8;
+  memcpy(bytes, &bad, sizeof(bad));
+  cr_assert(!TokenSnapshot_open(&snapshot, bytes, sizeof(data)));
+
+  bad = header;
+  bad.count = UINT64_MAX / 8;
+  memcpy(bytes, &bad, sizeof(bad));
+  cr_assert(!TokenSnapshot_open(&snapshot, bytes, sizeof(data)));
+
+  bad = header;
+  bad.magic[0] = 'X';
+  memcpy(bytes, &bad, sizeof(bad));
+  cr_assert(!TokenSnapshot_open(&snapshot, bytes, sizeof(data)));
+}
+
+Test(token_snapshot, corrupt_index_is_rejected) {
+  static uint64_t data[4096];
+  uint8_t *bytes = (uint8_t *)data;
+  TokenSnapshot_Header header;
+  TokenSnapshot_Header_init(&header, 3, 2);
+  memcpy(bytes, &header, sizeof(header));
+  uint8_t(*mints)[32] = (uint8_t(*)[32])(bytes + header.mints_offset);
+  mints[0][0] = mints[1][0] = 1;
+  mints[2][0] = 2;
+  TokenSnapshot_MintRange *index =
+      (TokenSnapshot_MintRange *)(bytes + header.index_offset);
+  const TokenSnapshot_MintRange valid[2] = {{{1}, 0, 2}, {{2}, 2, 1}};
+  TokenSnapshot snapshot;
+
+  memcpy(index, valid, sizeof(valid));
+  cr_assert(TokenSnapshot_open(&snapshot, bytes, header.len));
+  cr_assert(&index[1] == TokenSnapshot_find_mint(&snapshot, mints[2]));
+
+  // Each change breaks a range: a gap, an overlap, rows past the end, an empty
+  // range, rows left uncovered and a mint other than that of its rows
+  const uint64_t ranges[][4] = {{0, 2, 3, 1}, {0, 2, 1, 2}, {0, 2, 2, 2},
+                                {0, 2, 2, 0}, {0, 1, 1, 1}, {1, 2, 3, 0}};
+  for (size_t i = 0; i < sizeof(ranges) / sizeof(ranges[0]); i++) {
+    memcpy(index, valid, sizeof(valid));
+    index[0].first = ranges[i][0];
+    index[0].count = ranges[i][1];
+    index[1].first = ranges[i][2];
+    index[1].count = ranges[i][3];
+    cr_assert(!TokenSnapshot_open(&snapshot, bytes, header.len));
+  }
+  memcpy(index, valid, sizeof(valid));
+  index[1].mint[0] = 3;
+  cr_assert(!TokenSnapshot_open(&snapshot, bytes, header.len));
+
+  // Mints out of order or repeated, with the mint column to match
+  mints[0][0] = mints[1][0] = 2;
+  mints[2][0] = 1;
+  index[0].mint[0] = 2;
+  index[1].mint[0] = 1;
+  cr_assert(!TokenSnapshot_open(&snapshot, bytes, header.len));
+  mints[2][0] = 2;
+  index[1].mint[0] = 2;
+  cr_assert(!TokenSnapshot_open(&snapshot, bytes, header.len));
+}
@@ -0,0 +1,149 @@
+#include "token-stream.h"
+#include <criterion/criterion.h>
+
+#define MAX_FRAMES 256
+
+/// A stream of frames and the records it should produce
+typedef struct {
+  uint8_t bytes[MAX_FRAMES * (TokenStream_FRAME_HEADER_LEN + 1000)];
+  size_t len;
+  size_t frame_offsets[MAX_FRAMES];
+  uint32_t frame_lens[MAX_FRAMES];
+  uint64_t frames;
+} Frames;
+
+static void add_frame(Frames *frames, uint32_t data_len) {
+  uint8_t *frame = frames->bytes + frames->len;
+  for (size_t i = 0; i < TokenStream_FRAME_HEADER_LEN + data_len; i++) {
+    frame[i] = (uint8_t)rand();
+  }
+  Token_write_u32(frame + 32, data_len);
+  frames->frame_offsets[frames->frames] = frames->len;
+  frames->frame_lens[frames->frames] = data_len;
+  frames->frames++;
+  frames->len += TokenStream_FRAME_HEADER_LEN + data_len;
+}
+
+typedef struct {
+  const Frames *frames;
+  int next;
+  int stop_after;
+} Expect;
+
+/// Checks each record against the next token account frame
+static bool check_record(void *context, const TokenStream_Record *record) {
+  Expect *expect = context;
+  const Frames *frames = expect->frames;
+  TokenStream_Kind kind;
+  while (!TokenStream_kind(frames->frame_lens[expect->next], &kind)) {
+    expect->next++;
+  }
+  const uint8_t *frame = frames->bytes + frames->frame_offsets[expect->next];
+  cr_assert(kind == record->kind);
+  cr_assert(frames->frame_lens[expect->next] == record->data_len);
+  cr_assert(0 == memcmp(frame, record->address, 32));
+  cr_assert(0 == memcmp(frame + TokenStream_FRAME_HEADER_LEN, record->data,
+                        record->data_len));
+  expect->next++;
+  return expect->next != expect->stop_after;
+}
+
+static void random_frames(Frames *frames, int count) {
+  const uint32_t lens[] = {Token_Mint_LEN, Token_Account_LEN,
+                           Token_Multisig_LEN, 0, 1, 164, 1000};
+  frames->len = 0;
+  frames->frames = 0;
+  for (int i = 0; i < count; i++) {
+    add_frame(frames, lens[rand() % (sizeof(lens) / sizeof(lens[0]))]);
+  }
+}
+
+static uint64_t token_frames(const Frames *frames) {
+  uint64_t count = 0;
+  TokenStream_Kind kind;
+  for (uint64_t i = 0; i < frames->frames; i++) {
+    count += TokenStream_kind(frames->frame_lens[i], &kind);
+  }
+  return count;
+}
+
+Test(token_stream, any_chunking) {
+  static Frames frames;
+  srand(1);
+  for (int round = 0; round < 200; round++) {
+    random_frames(&frames, MAX_FRAMES);
+    Expect expect = {&frames, 0, -1};
+    TokenStream stream;
+    TokenStream_init(&stream, check_record, &expect);
+    size_t max_chunk = round < 10 ? round + 1 : 1 + rand() % 2000;
+    for (size_t offset = 0; offset < frames.len;) {
+      size_t chunk = 1 + rand() % max_chunk;
+      chunk = chunk < frames.len - offset ? chunk : frames.len - offset;
+      cr_assert(TokenStream_feed(&stream, frames.bytes + offset, chunk));
+      offset += chunk;
+    }
+    cr_assert(TokenStream_finish(&stream));
+    cr_assert(token_frames(&frames) == stream.records);
+    cr_assert(frames.frames == stream.records + stream.skipped);
+  }
+}
+
+Test(token_stream, records_in_one_chunk_are_not_copied) {
+  static Frames frames;
+  frames.len = 0;
+  frames.frames = 0;
+  add_frame(&frames, Token_Account_LEN);
+  add_frame(&frames, 1000);
+  add_frame(&frames, Token_Mint_LEN);
+  Expect expect = {&frames, 0, -1};
+  TokenStream stream;
+  TokenStream_init(&stream, check_record, &expect);
+  cr_assert(TokenStream_feed(&stream, frames.bytes, frames.len));
+  cr_assert(2 == stream.records);
+  cr_assert(1 == stream.skipped);
+  cr_assert(TokenStream_finish(&stream));
+}
+
+static bool check_in_place(void *context, const TokenStream_Record *record) {
+  const TokenStream *stream = context;
+  cr_assert(record->address < stream->buffer ||
+            record->address >= stream->buffer + sizeof(stream->buffer));
+  return true;
+}
+
+Test(token_stream, in_place_view) {
+  static Frames frames;
+  frames.len = 0;
+  frames.frames = 0;
+  add_frame(&frames, Token_Multisig_LEN);
+  add_frame(&frames, Token_Account_LEN);
+  TokenStream stream;
+  TokenStream_init(&stream, check_in_place, &stream);
+  cr_assert(TokenStream_feed(&stream, frames.bytes, frames.len));
+  cr_assert(2 == stream.records);
+}
+
+Test(token_stream, stop_and_partial_frames) {
+  static Frames frames;
+  frames.len = 0;
+  frames.frames = 0;
+  for (int i = 0; i < 4; i++) {
+    add_frame(&frames, Token_Account_LEN);
+  }
+  Expect expect = {&frames, 0, 2};
+  TokenStream stream;
+  TokenStream_init(&stream, check_record, &expect);
+  cr_assert(!TokenStream_feed(&stream, frames.bytes, frames.len));
+  cr_assert(2 == stream.records);
+  cr_assert(!TokenStream_feed(&stream, frames.bytes, frames.len));
+  cr_assert(2 == stream.records);
+
+  expect = (Expect){&frames, 0, -1};
+  TokenStream_init(&stream, check_record, &expect);
+  cr_assert(TokenStream_feed(&stream, frames.bytes, frames.len - 1));
+  cr_assert(3 == stream.records);
+  cr_assert(!TokenStream_finish(&stream));
+  cr_assert(TokenStream_feed(&stream, frames.bytes + frames.len - 1, 1));
+  cr_assert(4 == stream.records);
+  cr_assert(TokenStream_finish(&stream));
+}
@@ -0,0 +1,411 @@
+/**
+ * @brief SPL Token instruction builders for C programs
+ *
+ * Each builder mirrors the function of the same name in
+ * `spl_token::instruction`.  The packed instruction data and account metas are
+ * written into caller-provided memory, so issuing a token cross-program
+ * invocation needs no heap allocation and no hand-packed bytes.
+ *
+ * `data` must hold at least the builder's `Token_*_DATA_LEN` bytes, and
+ * `accounts` the documented number of metas plus one per multisig signer.
+ * When `signers_len` is zero the authority itself is marked as the signer.
+ */
+#pragma once
+
+#include <solana_sdk.h>
+#include "token-layout.h"
+
+#define Token_TRANSFER_DATA_LEN 9
+#define Token_APPROVE_DATA_LEN 9
+#define Token_REVOKE_DATA_LEN 1
+#define Token_SET_AUTHORITY_DATA_LEN 35
+#define Token_MINT_TO_DATA_LEN 9
+#define Token_BURN_DATA_LEN 9
+#define Token_CLOSE_ACCOUNT_DATA_LEN 1
+#define Token_FREEZE_ACCOUNT_DATA_LEN 1
+#define Token_THAW_ACCOUNT_DATA_LEN 1
+#define Token_TRANSFER_CHECKED_DATA_LEN 10
+#define Token_APPROVE_CHECKED_DATA_LEN 10
+#define Token_MINT_TO_CHECKED_DATA_LEN 10
+#define Token_BURN_CHECKED_DATA_LEN 10
+
+/** Largest account list any builder produces */
+#define Token_MAX_INSTRUCTION_ACCOUNTS (4 + Token_MAX_SIGNERS)
+
+static inline void Token_account_meta(SolAccountMeta *meta, SolPubkey *key,
+                                      bool is_writable, bool is_signer) {
+  meta->pubkey = key;
+  meta->is_writable = is_writable;
+  meta->is_signer = is_signer;
+}
+
+/**
+ * Appends the authority and any multisig signers, returning the total number
+ * of account metas
+ */
+static inline uint64_t Token_authority_metas(SolAccountMeta *accounts,
+                                             uint64_t index,
+                                             SolPubkey *authority,
+                                             SolPubkey *const *signers,
+                                             uint64_t signers_len) {
+  Token_account_meta(&accounts[index++], authority, false, signers_len == 0);
+  for (uint64_t i = 0; i < signers_len; i++) {
+    Token_account_meta(&accounts[index++], signers[i], false, true);
+  }
+  return index;
+}
+
+static inline void Token_instruction(SolInstruction *instruction,
+                                     SolPubkey *token_program_id,
+                                     SolAccountMeta *accounts,
+                                     uint64_t account_len, uint8_t *data,
+                                     uint64_t data_len) {
+  instruction->program_id = token_program_id;
+  instruction->accounts = accounts;
+  instruction->account_len = account_len;
+  instruction->data = data;
+  instruction->data_len = data_len;
+}
+
+static inline void Token_pack_amount(uint8_t *data, uint8_t tag,
+                                     uint64_t amount) {
+  data[0] = tag;
+  Token_write_u64(data + 1, amount);
+}
+
+static inline void Token_pack_amount_checked(uint8_t *data, uint8_t tag,
+                                             uint64_t amount,
+                                             uint8_t decimals) {
+  Token_pack_amount(data, tag, amount);
+  data[9] = decimals;
+}
+
+/**
+ * Creates a `Transfer` instruction, 3 account metas
+ */
+static inline void Token_transfer(SolInstruction *instruction, uint8_t *data,
+                                  SolAccountMeta *accounts,
+                                  SolPubkey *token_program_id,
+                                  SolPubkey *source, SolPubkey *destination,
+                                  SolPubkey *authority,
+                                  SolPubkey *const *signers,
+                                  uint64_t signers_len, uint64_t amount) {
+  Token_pack_amount(data, Token_TokenInstruction_Transfer, amount);
+  Token_account_meta(&accounts[0], source, true, false);
+  Token_account_meta(&accounts[1], destination, true, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 2, authority, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_TRANSFER_DATA_LEN);
+}
+
+/**
+ * Creates an `Approve` instruction, 3 account metas
+ */
+static inline void Token_approve(SolInstruction *instruction, uint8_t *data,
+                                 SolAccountMeta *accounts,
+                                 SolPubkey *token_program_id, SolPubkey *source,
+                                 SolPubkey *delegate, SolPubkey *owner,
+                                 SolPubkey *const *signers,
+                                 uint64_t signers_len, uint64_t amount) {
+  Token_pack_amount(data, Token_TokenInstruction_Approve, amount);
+  Token_account_meta(&accounts[0], source, true, false);
+  Token_account_meta(&accounts[1], delegate, false, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 2, owner, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_APPROVE_DATA_LEN);
+}
+
+/**
+ * Creates a `Revoke` instruction, 2 account metas
+ */
+static inline void Token_revoke(SolInstruction *instruction, uint8_t *data,
+                                SolAccountMeta *accounts,
+                                SolPubkey *token_program_id, SolPubkey *source,
+                                SolPubkey *owner, SolPubkey *const *signers,
+                                uint64_t signers_len) {
+  data[0] = Token_TokenInstruction_Revoke;
+  Token_account_meta(&accounts[0], source, true, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 1, owner, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_REVOKE_DATA_LEN);
+}
+
+/**
+ * Creates a `SetAuthority` instruction, 2 account metas
+ *
+ * Passing `NULL` as `new_authority` removes the authority.
+ */
+static inline void
+Token_set_authority(SolInstruction *instruction, uint8_t *data,
+                    SolAccountMeta *accounts, SolPubkey *token_program_id,
+                    SolPubkey *owned, const SolPubkey *new_authority,
+                    Token_AuthorityType authority_type, SolPubkey *owner,
+                    SolPubkey *const *signers, uint64_t signers_len) {
+  uint64_t data_len = 3;
+  data[0] = Token_TokenInstruction_SetAuthority;
+  data[1] = (uint8_t)authority_type;
+  if (new_authority == NULL) {
+    data[2] = 0;
+  } else {
+    data[2] = 1;
+    sol_memcpy(data + 3, new_authority, sizeof(SolPubkey));
+    data_len += sizeof(SolPubkey);
+  }
+  Token_account_meta(&accounts[0], owned, true, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 1, owner, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    data_len);
+}
+
+/**
+ * Creates a `MintTo` instruction, 3 account metas
+ */
+static inline void Token_mint_to(SolInstruction *instruction, uint8_t *data,
+                                 SolAccountMeta *accounts,
+                                 SolPubkey *token_program_id, SolPubkey *mint,
+                                 SolPubkey *account, SolPubkey *owner,
+                                 SolPubkey *const *signers,
+                                 uint64_t signers_len, uint64_t amount) {
+  Token_pack_amount(data, Token_TokenInstruction_MintTo, amount);
+  Token_account_meta(&accounts[0], mint, true, false);
+  Token_account_meta(&accounts[1], account, true, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 2, owner, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_MINT_TO_DATA_LEN);
+}
+
+/**
+ * Creates a `Burn` instruction, 3 account metas
+ */
+static inline void Token_burn(SolInstruction *instruction, uint8_t *data,
+                              SolAccountMeta *accounts,
+                              SolPubkey *token_program_id, SolPubkey *account,
+                              SolPubkey *mint, SolPubkey *authority,
+                              SolPubkey *const *signers, uint64_t signers_len,
+                              uint64_t amount) {
+  Token_pack_amount(data, Token_TokenInstruction_Burn, amount);
+  Token_account_meta(&accounts[0], account, true, false);
+  Token_account_meta(&accounts[1], mint, true, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 2, authority, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_BURN_DATA_LEN);
+}
+
+/**
+ * Creates a `CloseAccount` instruction, 3 account metas
+ */
+static inline void
+Token_close_account(SolInstruction *instruction, uint8_t *data,
+                    SolAccountMeta *accounts, SolPubkey *token_program_id,
+                    SolPubkey *account, SolPubkey *destination,
+                    SolPubkey *owner, SolPubkey *const *signers,
+                    uint64_t signers_len) {
+  data[0] = Token_TokenInstruction_CloseAccount;
+  Token_account_meta(&accounts[0], account, true, false);
+  Token_account_meta(&accounts[1], destination, true, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 2, owner, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_CLOSE_ACCOUNT_DATA_LEN);
+}
+
+/**
+ * Creates a `FreezeAccount` instruction, 3 account metas
+ */
+static inline void
+Token_freeze_account(SolInstruction *instruction, uint8_t *data,
+                     SolAccountMeta *accounts, SolPubkey *token_program_id,
+                     SolPubkey *account, SolPubkey *mint, SolPubkey *owner,
+                     SolPubkey *const *signers, uint64_t signers_len) {
+  data[0] = Token_TokenInstruction_FreezeAccount;
+  Token_account_meta(&accounts[0], account, true, false);
+  Token_account_meta(&accounts[1], mint, false, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 2, owner, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_FREEZE_ACCOUNT_DATA_LEN);
+}
+
+/**
+ * Creates a `ThawAccount` instruction, 3 account metas
+ */
+static inline void
+Token_thaw_account(SolInstruction *instruction, uint8_t *data,
+                   SolAccountMeta *accounts, SolPubkey *token_program_id,
+                   SolPubkey *account, SolPubkey *mint, SolPubkey *owner,
+                   SolPubkey *const *signers, uint64_t signers_len) {
+  data[0] = Token_TokenInstruction_ThawAccount;
+  Token_account_meta(&accounts[0], account, true, false);
+  Token_account_meta(&accounts[1], mint, false, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 2, owner, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_THAW_ACCOUNT_DATA_LEN);
+}
+
+/**
+ * Creates a `TransferChecked` instruction, 4 account metas
+ */
+static inline void
+Token_transfer_checked(SolInstruction *instruction, uint8_t *data,
+                       SolAccountMeta *accounts, SolPubkey *token_program_id,
+                       SolPubkey *source, SolPubkey *mint,
+                       SolPubkey *destination, SolPubkey *authority,
+                       SolPubkey *const *signers, uint64_t signers_len,
+                       uint64_t amount, uint8_t decimals) {
+  Token_pack_amount_checked(data, Token_TokenInstruction_TransferChecked,
+                            amount, decimals);
+  Token_account_meta(&accounts[0], source, true, false);
+  Token_account_meta(&accounts[1], mint, false, false);
+  Token_account_meta(&accounts[2], destination, true, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 3, authority, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_TRANSFER_CHECKED_DATA_LEN);
+}
+
+/**
+ * Creates an `ApproveChecked` instruction, 4 account metas
+ */
+static inline void
+Token_approve_checked(SolInstruction *instruction, uint8_t *data,
+                      SolAccountMeta *accounts, SolPubkey *token_program_id,
+                      SolPubkey *source, SolPubkey *mint, SolPubkey *delegate,
+                      SolPubkey *owner, SolPubkey *const *signers,
+                      uint64_t signers_len, uint64_t amount,
+                      uint8_t decimals) {
+  Token_pack_amount_checked(data, Token_TokenInstruction_ApproveChecked,
+                            amount, decimals);
+  Token_account_meta(&accounts[0], source, true, false);
+  Token_account_meta(&accounts[1], mint, false, false);
+  Token_account_meta(&accounts[2], delegate, false, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 3, owner, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_APPROVE_CHECKED_DATA_LEN);
+}
+
+/**
+ * Creates a `MintToChecked` instruction, 3 account metas
+ */
+static inline void
+Token_mint_to_checked(SolInstruction *instruction, uint8_t *data,
+                      SolAccountMeta *accounts, SolPubkey *token_program_id,
+                      SolPubkey *mint, SolPubkey *account, SolPubkey *owner,
+                      SolPubkey *const *signers, uint64_t signers_len,
+                      uint64_t amount, uint8_t decimals) {
+  Token_pack_amount_checked(data, Token_TokenInstruction_MintToChecked, amount,
+                            decimals);
+  Token_account_meta(&accounts[0], mint, true, false);
+  Token_account_meta(&accounts[1], account, true, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 2, owner, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_MINT_TO_CHECKED_DATA_LEN);
+}
+
+/**
+ * Creates a `BurnChecked` instruction, 3 account metas
+ */
+static inline void
+Token_burn_checked(SolInstruction *instruction, uint8_t *data,
+                   SolAccountMeta *accounts, SolPubkey *token_program_id,
+                   SolPubkey *account, SolPubkey *mint, SolPubkey *authority,
+                   SolPubkey *const *signers, uint64_t signers_len,
+                   uint64_t amount, uint8_t decimals) {
+  Token_pack_amount_checked(data, Token_TokenInstruction_BurnChecked, amount,
+                            decimals);
+  Token_account_meta(&accounts[0], account, true, false);
+  Token_account_meta(&accounts[1], mint, true, false);
+  uint64_t account_len =
+      Token_authority_metas(accounts, 2, authority, signers, signers_len);
+  Token_instruction(instruction, token_program_id, accounts, account_len, data,
+                    Token_BURN_CHECKED_DATA_LEN);
+}
+
+/**
+ * Reusable `Transfer` invocation for programs that move tokens between many
+ * account pairs under one authority.
+ *
+ * The instruction, account metas and signer seeds are set up once by
+ * `Token_TransferBatch_init`; each transfer then only patches the source,
+ * destination and amount before invoking.  The instruction points into the
+ * batch itself, so a batch must not be copied or moved once initialized.
+ */
+typedef struct {
+  SolInstruction instruction;
+  SolAccountMeta accounts[3];
+  uint8_t data[Token_TRANSFER_DATA_LEN];
+  const SolAccountInfo *account_infos;
+  int account_infos_len;
+  const SolSignerSeeds *signers_seeds;
+  int signers_seeds_len;
+} Token_TransferBatch;
+
+/**
+ * One entry of a batched transfer
+ */
+typedef struct {
+  SolPubkey *source;
+  SolPubkey *destination;
+  uint64_t amount;
+} Token_TransferBatchEntry;
+
+/**
+ * Prepares a batch of transfers signed by `authority`
+ *
+ * `account_infos` must include the token program, the authority and every
+ * source and destination later passed to the batch.  `signers_seeds` may be
+ * `NULL` when `authority` signed the transaction itself.
+ */
+static inline void Token_TransferBatch_init(
+    Token_TransferBatch *batch, SolPubkey *token_program_id,
+    SolPubkey *authority, const SolAccountInfo *account_infos,
+    int account_infos_len, const SolSignerSeeds *signers_seeds,
+    int signers_seeds_len) {
+  Token_transfer(&batch->instruction, batch->data, batch->accounts,
+                 token_program_id, authority, authority, authority, NULL, 0,
+                 0);
+  batch->account_infos = account_infos;
+  batch->account_infos_len = account_infos_len;
+  batch->signers_seeds = signers_seeds;
+  batch->signers_seeds_len = signers_seeds_len;
+}
+
+/**
+ * Invokes a single transfer of the batch
+ */
+static inline uint64_t Token_TransferBatch_invoke(Token_TransferBatch *batch,
+                                                  SolPubkey *source,
+                                                  SolPubkey *destination,
+                                                  uint64_t amount) {
+  batch->accounts[0].pubkey = source;
+  batch->accounts[1].pubkey = destination;
+  Token_write_u64(batch->data + 1, amount);
+  return sol_invoke_signed(&batch->instruction, batch->account_infos,
+                           batch->account_infos_len, batch->signers_seeds,
+                           batch->signers_seeds_len);
+}
+
+/**
+ * Invokes every transfer in `entries` in order, stopping at the first failure
+ */
+static inline uint64_t
+Token_TransferBatch_invoke_all(Token_TransferBatch *batch,
+                               const Token_TransferBatchEntry *entries,
+                               uint64_t entries_len) {
+  for (uint64_t i = 0; i < entries_len; i++) {
+    uint64_t result = Token_TransferBatch_invoke(
+        batch, entries[i].source, entries[i].destination, entries[i].amount);
+    if (result != SUCCESS) {
+      return result;
+    }
+  }
+  return SUCCESS;
+}
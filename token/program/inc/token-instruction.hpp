@@ -0,0 +1,265 @@
+/**
+ * @brief SPL Token instruction data encoders for C++ clients
+ *
+ * `Token::Instruction<Tag>` describes the instruction with that
+ * `Token_TokenInstruction_Tag`: the most bytes its data takes, the account
+ * metas it expects before any multisig signers and a `pack` that writes the
+ * data exactly as `TokenInstruction::pack` does.  Every size is a constant
+ * expression, so a batch of instructions can be laid out in one buffer sized
+ * at compile time:
+ *
+ *   std::array<uint8_t, Token::batch_data_len<Token_TokenInstruction_Transfer,
+ *                                              Token_TokenInstruction_CloseAccount>>
+ *       buffer;
+ *   Token::Encoder encoder(buffer);
+ *   auto transfer = encoder.push<Token_TokenInstruction_Transfer>(amount);
+ *   auto close = encoder.push<Token_TokenInstruction_CloseAccount>();
+ *
+ * Header-only, depending only on `token-layout.h`, so it is usable off-chain
+ * where `solana_sdk.h` is not available.
+ */
+#pragma once
+
+#if __cplusplus < 202002L
+#error "token-instruction.hpp requires C++20 for std::span"
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+
+#include "token-layout.h"
+
+namespace Token {
+
+/// Marks an optional public key as `None`
+inline constexpr const uint8_t *NO_PUBKEY = nullptr;
+
+/// Writes a `COption<Pubkey>` the way instructions pack it, a single `0` or
+/// a `1` followed by the key, returning the bytes written
+inline size_t pack_pubkey_option(uint8_t *data, const uint8_t *key) {
+  if (key == NO_PUBKEY) {
+    data[0] = 0;
+    return 1;
+  }
+  data[0] = 1;
+  __builtin_memcpy(data + 1, key, 32);
+  return 33;
+}
+
+/// Instructions without data beyond the tag
+template <Token_TokenInstruction_Tag Tag, size_t Accounts> struct TagOnly {
+  static constexpr Token_TokenInstruction_Tag tag = Tag;
+  static constexpr size_t max_data_len = 1;
+  static constexpr size_t accounts_len = Accounts;
+
+  static size_t pack(uint8_t *data) {
+    data[0] = Tag;
+    return 1;
+  }
+};
+
+/// Instructions carrying an amount
+template <Token_TokenInstruction_Tag Tag, size_t Accounts> struct Amount {
+  static constexpr Token_TokenInstruction_Tag tag = Tag;
+  static constexpr size_t max_data_len = 9;
+  static constexpr size_t accounts_len = Accounts;
+
+  static size_t pack(uint8_t *data, uint64_t amount) {
+    data[0] = Tag;
+    Token_write_u64(data + 1, amount);
+    return 9;
+  }
+};
+
+/// Instructions carrying an amount and the mint's decimals
+template <Token_TokenInstruction_Tag Tag, size_t Accounts>
+struct AmountChecked {
+  static constexpr Token_TokenInstruction_Tag tag = Tag;
+  static constexpr size_t max_data_len = 10;
+  static constexpr size_t accounts_len = Accounts;
+
+  static size_t pack(uint8_t *data, uint64_t amount, uint8_t decimals) {
+    data[0] = Tag;
+    Token_write_u64(data + 1, amount);
+    data[9] = decimals;
+    return 10;
+  }
+};
+
+/**
+ * Instruction with the given tag
+ *
+ * `accounts_len` excludes multisig signers, which follow the authority.
+ */
+template <Token_TokenInstruction_Tag Tag> struct Instruction;
+
+template <>
+struct Instruction<Token_TokenInstruction_InitializeMint> {
+  static constexpr Token_TokenInstruction_Tag tag =
+      Token_TokenInstruction_InitializeMint;
+  static constexpr size_t max_data_len = 67;
+  static constexpr size_t accounts_len = 2;
+
+  /// `freeze_authority` may be `NO_PUBKEY`
+  static size_t pack(uint8_t *data, uint8_t decimals,
+                     const uint8_t *mint_authority,
+                     const uint8_t *freeze_authority) {
+    data[0] = tag;
+    data[1] = decimals;
+    __builtin_memcpy(data + 2, mint_authority, 32);
+    return 34 + pack_pubkey_option(data + 34, freeze_authority);
+  }
+};
+
+template <>
+struct Instruction<Token_TokenInstruction_InitializeAccount>
+    : TagOnly<Token_TokenInstruction_InitializeAccount, 4> {};
+
+/// `accounts_len` excludes the signers being registered
+template <>
+struct Instruction<Token_TokenInstruction_InitializeMultisig> {
+  static constexpr Token_TokenInstruction_Tag tag =
+      Token_TokenInstruction_InitializeMultisig;
+  static constexpr size_t max_data_len = 2;
+  static constexpr size_t accounts_len = 2;
+
+  static size_t pack(uint8_t *data, uint8_t m) {
+    data[0] = tag;
+    data[1] = m;
+    return 2;
+  }
+};
+
+template <>
+struct Instruction<Token_TokenInstruction_Transfer>
+    : Amount<Token_TokenInstruction_Transfer, 3> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_Approve>
+    : Amount<Token_TokenInstruction_Approve, 3> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_Revoke>
+    : TagOnly<Token_TokenInstruction_Revoke, 2> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_SetAuthority> {
+  static constexpr Token_TokenInstruction_Tag tag =
+      Token_TokenInstruction_SetAuthority;
+  static constexpr size_t max_data_len = 35;
+  static constexpr size_t accounts_len = 2;
+
+  /// `new_authority` may be `NO_PUBKEY` to remove the authority
+  static size_t pack(uint8_t *data, Token_AuthorityType authority_type,
+                     const uint8_t *new_authority) {
+    data[0] = tag;
+    data[1] = (uint8_t)authority_type;
+    return 2 + pack_pubkey_option(data + 2, new_authority);
+  }
+};
+
+template <>
+struct Instruction<Token_TokenInstruction_MintTo>
+    : Amount<Token_TokenInstruction_MintTo, 3> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_Burn>
+    : Amount<Token_TokenInstruction_Burn, 3> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_CloseAccount>
+    : TagOnly<Token_TokenInstruction_CloseAccount, 3> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_FreezeAccount>
+    : TagOnly<Token_TokenInstruction_FreezeAccount, 3> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_ThawAccount>
+    : TagOnly<Token_TokenInstruction_ThawAccount, 3> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_TransferChecked>
+    : AmountChecked<Token_TokenInstruction_TransferChecked, 4> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_ApproveChecked>
+    : AmountChecked<Token_TokenInstruction_ApproveChecked, 4> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_MintToChecked>
+    : AmountChecked<Token_TokenInstruction_MintToChecked, 3> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_BurnChecked>
+    : AmountChecked<Token_TokenInstruction_BurnChecked, 3> {};
+
+template <>
+struct Instruction<Token_TokenInstruction_InitializeAccount2> {
+  static constexpr Token_TokenInstruction_Tag tag =
+      Token_TokenInstruction_InitializeAccount2;
+  static constexpr size_t max_data_len = 33;
+  static constexpr size_t accounts_len = 3;
+
+  static size_t pack(uint8_t *data, const uint8_t *owner) {
+    data[0] = tag;
+    __builtin_memcpy(data + 1, owner, 32);
+    return 33;
+  }
+};
+
+/// Most data bytes of the instruction with `Tag`
+template <Token_TokenInstruction_Tag Tag>
+inline constexpr size_t max_data_len = Instruction<Tag>::max_data_len;
+
+/// Bytes that always hold the data of instructions with `Tags`, in order
+template <Token_TokenInstruction_Tag... Tags>
+inline constexpr size_t batch_data_len = (max_data_len<Tags> + ... + 0);
+
+/**
+ * Encodes the instruction with `Tag` at the start of `data`, returning the
+ * encoded bytes
+ *
+ * A `data` with a static extent is checked against `max_data_len` at compile
+ * time, a dynamic one only by `assert`.
+ */
+template <Token_TokenInstruction_Tag Tag, size_t Extent, typename... Args>
+inline std::span<const uint8_t> encode(std::span<uint8_t, Extent> data,
+                                       Args... args) {
+  static_assert(Extent == std::dynamic_extent ||
+                    Extent >= max_data_len<Tag>,
+                "buffer is too small for the instruction");
+  assert(data.size() >= max_data_len<Tag>);
+  size_t len = Instruction<Tag>::pack(data.data(), args...);
+  return std::span<const uint8_t>(data.data(), len);
+}
+
+/**
+ * Encodes instructions one after another into a single buffer
+ *
+ * Each instruction takes only the bytes it encodes to, so a buffer of
+ * `batch_data_len` bytes always has room for the batch.
+ */
+class Encoder {
+public:
+  explicit Encoder(std::span<uint8_t> buffer) : buffer_(buffer) {}
+
+  /// Encodes the next instruction, returning its data
+  template <Token_TokenInstruction_Tag Tag, typename... Args>
+  std::span<const uint8_t> push(Args... args) {
+    std::span<const uint8_t> data =
+        encode<Tag>(buffer_.subspan(len_), args...);
+    len_ += data.size();
+    return data;
+  }
+
+  /// Bytes encoded so far
+  size_t len() const { return len_; }
+
+private:
+  std::span<uint8_t> buffer_;
+  size_t len_ = 0;
+};
+
+} // namespace Token
@@ -0,0 +1,719 @@
+/* Autogenerated SPL Token program packed account layout */
+
+#pragma once
+
+#include "token.h"
+#include "spl-pubkey.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "packed account data is little-endian"
+#endif
+
+static inline uint32_t Token_read_u32(const uint8_t *src) {
+    uint32_t value;
+    __builtin_memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+static inline uint64_t Token_read_u64(const uint8_t *src) {
+    uint64_t value;
+    __builtin_memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+static inline void Token_write_u32(uint8_t *dst, uint32_t value) {
+    __builtin_memcpy(dst, &value, sizeof(value));
+}
+
+static inline void Token_write_u64(uint8_t *dst, uint64_t value) {
+    __builtin_memcpy(dst, &value, sizeof(value));
+}
+
+
+#ifdef __cplusplus
+#define Token_STATIC_ASSERT static_assert
+#else
+#define Token_STATIC_ASSERT _Static_assert
+#endif
+
+/**
+ * Packed length of `Token_Mint` account data
+ */
+#define Token_Mint_LEN 82
+
+/**
+ * Optional authority used to mint new tokens.
+ */
+#define Token_Mint_mint_authority_OFFSET 0
+
+/**
+ * Returns `NULL` if the field is `None`
+ */
+static inline const uint8_t *Token_Mint_get_mint_authority(const uint8_t *data) {
+    if (Token_read_u32(data + Token_Mint_mint_authority_OFFSET) != 1) {
+        return NULL;
+    }
+    return data + Token_Mint_mint_authority_OFFSET + 4;
+}
+
+/**
+ * Passing `NULL` sets the field to `None`
+ */
+static inline void Token_Mint_set_mint_authority(uint8_t *data, const uint8_t *value) {
+    if (value == NULL) {
+        Token_write_u32(data + Token_Mint_mint_authority_OFFSET, 0);
+    } else {
+        Token_write_u32(data + Token_Mint_mint_authority_OFFSET, 1);
+        __builtin_memcpy(data + Token_Mint_mint_authority_OFFSET + 4, value, 32);
+    }
+}
+
+/**
+ * Returns `false` if the field is `None`
+ */
+static inline bool Token_Mint_mint_authority_is(const uint8_t *data, const uint8_t *key) {
+    return Token_read_u32(data + Token_Mint_mint_authority_OFFSET) == 1 && SplPubkey_eq(data + Token_Mint_mint_authority_OFFSET + 4, key);
+}
+
+/**
+ * Total supply of tokens.
+ */
+#define Token_Mint_supply_OFFSET 36
+
+static inline uint64_t Token_Mint_get_supply(const uint8_t *data) {
+    return Token_read_u64(data + Token_Mint_supply_OFFSET);
+}
+
+static inline void Token_Mint_set_supply(uint8_t *data, uint64_t value) {
+    Token_write_u64(data + Token_Mint_supply_OFFSET, value);
+}
+
+/**
+ * Number of base 10 digits to the right of the decimal place.
+ */
+#define Token_Mint_decimals_OFFSET 44
+
+static inline uint8_t Token_Mint_get_decimals(const uint8_t *data) {
+    return data[Token_Mint_decimals_OFFSET];
+}
+
+static inline void Token_Mint_set_decimals(uint8_t *data, uint8_t value) {
+    data[Token_Mint_decimals_OFFSET] = value;
+}
+
+/**
+ * Is `true` if this structure has been initialized
+ */
+#define Token_Mint_is_initialized_OFFSET 45
+
+static inline bool Token_Mint_get_is_initialized(const uint8_t *data) {
+    return data[Token_Mint_is_initialized_OFFSET] == 1;
+}
+
+static inline void Token_Mint_set_is_initialized(uint8_t *data, bool value) {
+    data[Token_Mint_is_initialized_OFFSET] = value ? 1 : 0;
+}
+
+/**
+ * Optional authority to freeze token accounts.
+ */
+#define Token_Mint_freeze_authority_OFFSET 46
+
+/**
+ * Returns `NULL` if the field is `None`
+ */
+static inline const uint8_t *Token_Mint_get_freeze_authority(const uint8_t *data) {
+    if (Token_read_u32(data + Token_Mint_freeze_authority_OFFSET) != 1) {
+        return NULL;
+    }
+    return data + Token_Mint_freeze_authority_OFFSET + 4;
+}
+
+/**
+ * Passing `NULL` sets the field to `None`
+ */
+static inline void Token_Mint_set_freeze_authority(uint8_t *data, const uint8_t *value) {
+    if (value == NULL) {
+        Token_write_u32(data + Token_Mint_freeze_authority_OFFSET, 0);
+    } else {
+        Token_write_u32(data + Token_Mint_freeze_authority_OFFSET, 1);
+        __builtin_memcpy(data + Token_Mint_freeze_authority_OFFSET + 4, value, 32);
+    }
+}
+
+/**
+ * Returns `false` if the field is `None`
+ */
+static inline bool Token_Mint_freeze_authority_is(const uint8_t *data, const uint8_t *key) {
+    return Token_read_u32(data + Token_Mint_freeze_authority_OFFSET) == 1 && SplPubkey_eq(data + Token_Mint_freeze_authority_OFFSET + 4, key);
+}
+
+/**
+ * Checks the length and every tag of packed `Token_Mint` data, accepting exactly
+ * what the program's `unpack_unchecked` accepts
+ */
+static inline bool Token_Mint_is_valid(const uint8_t *data, uint64_t data_len) {
+    return data_len == Token_Mint_LEN &&
+           (Token_read_u32(data + Token_Mint_mint_authority_OFFSET) <= 1) &&
+           (data[Token_Mint_is_initialized_OFFSET] <= 1) &&
+           (Token_read_u32(data + Token_Mint_freeze_authority_OFFSET) <= 1);
+}
+
+/**
+ * Checks packed `Token_Mint` data like `Token_Mint_is_valid` and that it is initialized,
+ * accepting exactly what the program's `unpack` accepts
+ */
+static inline bool Token_Mint_is_initialized(const uint8_t *data, uint64_t data_len) {
+    return Token_Mint_is_valid(data, data_len) && data[Token_Mint_is_initialized_OFFSET] != 0;
+}
+
+/*
+ * `Token_Mint` fields must be contiguous, and sized like the cbindgen struct members
+ * they are read into
+ */
+Token_STATIC_ASSERT(Token_Mint_mint_authority_OFFSET == 0, "Token_Mint.mint_authority is not the first packed field");
+Token_STATIC_ASSERT(Token_Mint_mint_authority_OFFSET + 36 == Token_Mint_supply_OFFSET, "Token_Mint.mint_authority does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Mint_supply_OFFSET + 8 == Token_Mint_decimals_OFFSET, "Token_Mint.supply does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Mint_decimals_OFFSET + 1 == Token_Mint_is_initialized_OFFSET, "Token_Mint.decimals does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Mint_is_initialized_OFFSET + 1 == Token_Mint_freeze_authority_OFFSET, "Token_Mint.is_initialized does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Mint_freeze_authority_OFFSET + 36 == Token_Mint_LEN, "Token_Mint.freeze_authority does not end where the next packed field starts");
+Token_STATIC_ASSERT(sizeof(((Token_Mint *)0)->mint_authority.some) == 32, "Token_Mint.mint_authority does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Mint *)0)->supply) == 8, "Token_Mint.supply does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Mint *)0)->decimals) == 1, "Token_Mint.decimals does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Mint *)0)->is_initialized) == 1, "Token_Mint.is_initialized does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Mint *)0)->freeze_authority.some) == 32, "Token_Mint.freeze_authority does not match its packed size");
+
+/**
+ * Packed length of `Token_Account` account data
+ */
+#define Token_Account_LEN 165
+
+/**
+ * The mint associated with this account
+ */
+#define Token_Account_mint_OFFSET 0
+
+static inline const uint8_t *Token_Account_get_mint(const uint8_t *data) {
+    return data + Token_Account_mint_OFFSET;
+}
+
+static inline void Token_Account_set_mint(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + Token_Account_mint_OFFSET, value, 32);
+}
+
+static inline bool Token_Account_mint_is(const uint8_t *data, const uint8_t *key) {
+    return SplPubkey_eq(data + Token_Account_mint_OFFSET, key);
+}
+
+/**
+ * The owner of this account.
+ */
+#define Token_Account_owner_OFFSET 32
+
+static inline const uint8_t *Token_Account_get_owner(const uint8_t *data) {
+    return data + Token_Account_owner_OFFSET;
+}
+
+static inline void Token_Account_set_owner(uint8_t *data, const uint8_t *value) {
+    __builtin_memcpy(data + Token_Account_owner_OFFSET, value, 32);
+}
+
+static inline bool Token_Account_owner_is(const uint8_t *data, const uint8_t *key) {
+    return SplPubkey_eq(data + Token_Account_owner_OFFSET, key);
+}
+
+/**
+ * The amount of tokens this account holds.
+ */
+#define Token_Account_amount_OFFSET 64
+
+static inline uint64_t Token_Account_get_amount(const uint8_t *data) {
+    return Token_read_u64(data + Token_Account_amount_OFFSET);
+}
+
+static inline void Token_Account_set_amount(uint8_t *data, uint64_t value) {
+    Token_write_u64(data + Token_Account_amount_OFFSET, value);
+}
+
+/**
+ * If `delegate` is `Some` then `delegated_amount` is the amount authorized
+ */
+#define Token_Account_delegate_OFFSET 72
+
+/**
+ * Returns `NULL` if the field is `None`
+ */
+static inline const uint8_t *Token_Account_get_delegate(const uint8_t *data) {
+    if (Token_read_u32(data + Token_Account_delegate_OFFSET) != 1) {
+        return NULL;
+    }
+    return data + Token_Account_delegate_OFFSET + 4;
+}
+
+/**
+ * Passing `NULL` sets the field to `None`
+ */
+static inline void Token_Account_set_delegate(uint8_t *data, const uint8_t *value) {
+    if (value == NULL) {
+        Token_write_u32(data + Token_Account_delegate_OFFSET, 0);
+    } else {
+        Token_write_u32(data + Token_Account_delegate_OFFSET, 1);
+        __builtin_memcpy(data + Token_Account_delegate_OFFSET + 4, value, 32);
+    }
+}
+
+/**
+ * Returns `false` if the field is `None`
+ */
+static inline bool Token_Account_delegate_is(const uint8_t *data, const uint8_t *key) {
+    return Token_read_u32(data + Token_Account_delegate_OFFSET) == 1 && SplPubkey_eq(data + Token_Account_delegate_OFFSET + 4, key);
+}
+
+/**
+ * The account's state
+ */
+#define Token_Account_state_OFFSET 108
+
+static inline Token_AccountState Token_Account_get_state(const uint8_t *data) {
+    return (Token_AccountState)data[Token_Account_state_OFFSET];
+}
+
+static inline void Token_Account_set_state(uint8_t *data, Token_AccountState value) {
+    data[Token_Account_state_OFFSET] = (uint8_t)value;
+}
+
+/**
+ * If is_some, this is a native token, and the value logs the rent-exempt reserve.
+ */
+#define Token_Account_is_native_OFFSET 109
+
+/**
+ * Returns `false` if the field is `None`, otherwise stores the value
+ */
+static inline bool Token_Account_get_is_native(const uint8_t *data, uint64_t *value) {
+    if (Token_read_u32(data + Token_Account_is_native_OFFSET) != 1) {
+        return false;
+    }
+    *value = Token_read_u64(data + Token_Account_is_native_OFFSET + 4);
+    return true;
+}
+
+/**
+ * Passing `NULL` sets the field to `None`
+ */
+static inline void Token_Account_set_is_native(uint8_t *data, const uint64_t *value) {
+    if (value == NULL) {
+        Token_write_u32(data + Token_Account_is_native_OFFSET, 0);
+    } else {
+        Token_write_u32(data + Token_Account_is_native_OFFSET, 1);
+        Token_write_u64(data + Token_Account_is_native_OFFSET + 4, *value);
+    }
+}
+
+/**
+ * The amount delegated
+ */
+#define Token_Account_delegated_amount_OFFSET 121
+
+static inline uint64_t Token_Account_get_delegated_amount(const uint8_t *data) {
+    return Token_read_u64(data + Token_Account_delegated_amount_OFFSET);
+}
+
+static inline void Token_Account_set_delegated_amount(uint8_t *data, uint64_t value) {
+    Token_write_u64(data + Token_Account_delegated_amount_OFFSET, value);
+}
+
+/**
+ * Optional authority to close the account.
+ */
+#define Token_Account_close_authority_OFFSET 129
+
+/**
+ * Returns `NULL` if the field is `None`
+ */
+static inline const uint8_t *Token_Account_get_close_authority(const uint8_t *data) {
+    if (Token_read_u32(data + Token_Account_close_authority_OFFSET) != 1) {
+        return NULL;
+    }
+    return data + Token_Account_close_authority_OFFSET + 4;
+}
+
+/**
+ * Passing `NULL` sets the field to `None`
+ */
+static inline void Token_Account_set_close_authority(uint8_t *data, const uint8_t *value) {
+    if (value == NULL) {
+        Token_write_u32(data + Token_Account_close_authority_OFFSET, 0);
+    } else {
+        Token_write_u32(data + Token_Account_close_authority_OFFSET, 1);
+        __builtin_memcpy(data + Token_Account_close_authority_OFFSET + 4, value, 32);
+    }
+}
+
+/**
+ * Returns `false` if the field is `None`
+ */
+static inline bool Token_Account_close_authority_is(const uint8_t *data, const uint8_t *key) {
+    return Token_read_u32(data + Token_Account_close_authority_OFFSET) == 1 && SplPubkey_eq(data + Token_Account_close_authority_OFFSET + 4, key);
+}
+
+/**
+ * Checks the length and every tag of packed `Token_Account` data, accepting exactly
+ * what the program's `unpack_unchecked` accepts
+ */
+static inline bool Token_Account_is_valid(const uint8_t *data, uint64_t data_len) {
+    return data_len == Token_Account_LEN &&
+           (Token_read_u32(data + Token_Account_delegate_OFFSET) <= 1) &&
+           (data[Token_Account_state_OFFSET] <= Token_AccountState_Frozen) &&
+           (Token_read_u32(data + Token_Account_is_native_OFFSET) <= 1) &&
+           (Token_read_u32(data + Token_Account_close_authority_OFFSET) <= 1);
+}
+
+/**
+ * Checks packed `Token_Account` data like `Token_Account_is_valid` and that it is initialized,
+ * accepting exactly what the program's `unpack` accepts
+ */
+static inline bool Token_Account_is_initialized(const uint8_t *data, uint64_t data_len) {
+    return Token_Account_is_valid(data, data_len) && data[Token_Account_state_OFFSET] != 0;
+}
+
+/*
+ * `Token_Account` fields must be contiguous, and sized like the cbindgen struct members
+ * they are read into
+ */
+Token_STATIC_ASSERT(Token_Account_mint_OFFSET == 0, "Token_Account.mint is not the first packed field");
+Token_STATIC_ASSERT(Token_Account_mint_OFFSET + 32 == Token_Account_owner_OFFSET, "Token_Account.mint does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Account_owner_OFFSET + 32 == Token_Account_amount_OFFSET, "Token_Account.owner does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Account_amount_OFFSET + 8 == Token_Account_delegate_OFFSET, "Token_Account.amount does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Account_delegate_OFFSET + 36 == Token_Account_state_OFFSET, "Token_Account.delegate does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Account_state_OFFSET + 1 == Token_Account_is_native_OFFSET, "Token_Account.state does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Account_is_native_OFFSET + 12 == Token_Account_delegated_amount_OFFSET, "Token_Account.is_native does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Account_delegated_amount_OFFSET + 8 == Token_Account_close_authority_OFFSET, "Token_Account.delegated_amount does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Account_close_authority_OFFSET + 36 == Token_Account_LEN, "Token_Account.close_authority does not end where the next packed field starts");
+Token_STATIC_ASSERT(sizeof(((Token_Account *)0)->mint) == 32, "Token_Account.mint does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Account *)0)->owner) == 32, "Token_Account.owner does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Account *)0)->amount) == 8, "Token_Account.amount does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Account *)0)->delegate.some) == 32, "Token_Account.delegate does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Account *)0)->is_native.some) == 8, "Token_Account.is_native does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Account *)0)->delegated_amount) == 8, "Token_Account.delegated_amount does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Account *)0)->close_authority.some) == 32, "Token_Account.close_authority does not match its packed size");
+
+/**
+ * Packed length of `Token_Multisig` account data
+ */
+#define Token_Multisig_LEN 355
+
+/**
+ * Number of signers required
+ */
+#define Token_Multisig_m_OFFSET 0
+
+static inline uint8_t Token_Multisig_get_m(const uint8_t *data) {
+    return data[Token_Multisig_m_OFFSET];
+}
+
+static inline void Token_Multisig_set_m(uint8_t *data, uint8_t value) {
+    data[Token_Multisig_m_OFFSET] = value;
+}
+
+/**
+ * Number of valid signers
+ */
+#define Token_Multisig_n_OFFSET 1
+
+static inline uint8_t Token_Multisig_get_n(const uint8_t *data) {
+    return data[Token_Multisig_n_OFFSET];
+}
+
+static inline void Token_Multisig_set_n(uint8_t *data, uint8_t value) {
+    data[Token_Multisig_n_OFFSET] = value;
+}
+
+/**
+ * Is `true` if this structure has been initialized
+ */
+#define Token_Multisig_is_initialized_OFFSET 2
+
+static inline bool Token_Multisig_get_is_initialized(const uint8_t *data) {
+    return data[Token_Multisig_is_initialized_OFFSET] == 1;
+}
+
+static inline void Token_Multisig_set_is_initialized(uint8_t *data, bool value) {
+    data[Token_Multisig_is_initialized_OFFSET] = value ? 1 : 0;
+}
+
+/**
+ * Signer public keys
+ */
+#define Token_Multisig_signers_OFFSET 3
+
+/**
+ * `index` must be less than `Token_MAX_SIGNERS`
+ */
+static inline const uint8_t *Token_Multisig_get_signers(const uint8_t *data, size_t index) {
+    return data + Token_Multisig_signers_OFFSET + 32 * index;
+}
+
+/**
+ * `index` must be less than `Token_MAX_SIGNERS`
+ */
+static inline void Token_Multisig_set_signers(uint8_t *data, size_t index, const uint8_t *value) {
+    __builtin_memcpy(data + Token_Multisig_signers_OFFSET + 32 * index, value, 32);
+}
+
+/**
+ * Checks the length and every tag of packed `Token_Multisig` data, accepting exactly
+ * what the program's `unpack_unchecked` accepts
+ */
+static inline bool Token_Multisig_is_valid(const uint8_t *data, uint64_t data_len) {
+    return data_len == Token_Multisig_LEN &&
+           (data[Token_Multisig_is_initialized_OFFSET] <= 1);
+}
+
+/**
+ * Checks packed `Token_Multisig` data like `Token_Multisig_is_valid` and that it is initialized,
+ * accepting exactly what the program's `unpack` accepts
+ */
+static inline bool Token_Multisig_is_initialized(const uint8_t *data, uint64_t data_len) {
+    return Token_Multisig_is_valid(data, data_len) && data[Token_Multisig_is_initialized_OFFSET] != 0;
+}
+
+/*
+ * `Token_Multisig` fields must be contiguous, and sized like the cbindgen struct members
+ * they are read into
+ */
+Token_STATIC_ASSERT(Token_Multisig_m_OFFSET == 0, "Token_Multisig.m is not the first packed field");
+Token_STATIC_ASSERT(Token_Multisig_m_OFFSET + 1 == Token_Multisig_n_OFFSET, "Token_Multisig.m does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Multisig_n_OFFSET + 1 == Token_Multisig_is_initialized_OFFSET, "Token_Multisig.n does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Multisig_is_initialized_OFFSET + 1 == Token_Multisig_signers_OFFSET, "Token_Multisig.is_initialized does not end where the next packed field starts");
+Token_STATIC_ASSERT(Token_Multisig_signers_OFFSET + 352 == Token_Multisig_LEN, "Token_Multisig.signers does not end where the next packed field starts");
+Token_STATIC_ASSERT(sizeof(((Token_Multisig *)0)->m) == 1, "Token_Multisig.m does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Multisig *)0)->n) == 1, "Token_Multisig.n does not match its packed size");
+Token_STATIC_ASSERT(sizeof(((Token_Multisig *)0)->is_initialized) == 1, "Token_Multisig.is_initialized does not match its packed size");
+Token_STATIC_ASSERT(Token_MAX_SIGNERS == 11, "Token_Multisig.signers does not hold Token_MAX_SIGNERS keys");
+Token_STATIC_ASSERT(sizeof(((Token_Multisig *)0)->signers) == 32 * Token_MAX_SIGNERS, "Token_Multisig.signers does not match its packed size");
+
+#ifdef __cplusplus
+namespace Token {
+
+/**
+ * Reads a field through its C accessor, e.g.
+ * `Token::get<Token::Mint::supply>(data)`, which the compiler inlines to the load itself
+ */
+template <typename Field, typename... Args>
+inline auto get(const uint8_t *data, Args... args) -> decltype(Field::get(data, args...)) {
+    return Field::get(data, args...);
+}
+
+template <typename Field, typename... Args>
+inline void set(uint8_t *data, Args... args) {
+    Field::set(data, args...);
+}
+
+/**
+ * Compares a public key field, `false` if an optional one is `None`
+ */
+template <typename Field>
+inline bool is(const uint8_t *data, const uint8_t *key) {
+    return Field::is(data, key);
+}
+
+/**
+ * Packed `Token_Mint` fields
+ */
+struct Mint {
+    static constexpr size_t LEN = Token_Mint_LEN;
+
+    /**
+     * Optional authority used to mint new tokens.
+     */
+    struct mint_authority {
+        static constexpr size_t offset = Token_Mint_mint_authority_OFFSET;
+        static constexpr size_t size = 36;
+        static constexpr auto get = Token_Mint_get_mint_authority;
+        static constexpr auto set = Token_Mint_set_mint_authority;
+        static constexpr auto is = Token_Mint_mint_authority_is;
+    };
+
+    /**
+     * Total supply of tokens.
+     */
+    struct supply {
+        static constexpr size_t offset = Token_Mint_supply_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = Token_Mint_get_supply;
+        static constexpr auto set = Token_Mint_set_supply;
+    };
+
+    /**
+     * Number of base 10 digits to the right of the decimal place.
+     */
+    struct decimals {
+        static constexpr size_t offset = Token_Mint_decimals_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = Token_Mint_get_decimals;
+        static constexpr auto set = Token_Mint_set_decimals;
+    };
+
+    /**
+     * Is `true` if this structure has been initialized
+     */
+    struct is_initialized {
+        static constexpr size_t offset = Token_Mint_is_initialized_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = Token_Mint_get_is_initialized;
+        static constexpr auto set = Token_Mint_set_is_initialized;
+    };
+
+    /**
+     * Optional authority to freeze token accounts.
+     */
+    struct freeze_authority {
+        static constexpr size_t offset = Token_Mint_freeze_authority_OFFSET;
+        static constexpr size_t size = 36;
+        static constexpr auto get = Token_Mint_get_freeze_authority;
+        static constexpr auto set = Token_Mint_set_freeze_authority;
+        static constexpr auto is = Token_Mint_freeze_authority_is;
+    };
+};
+
+/**
+ * Packed `Token_Account` fields
+ */
+struct Account {
+    static constexpr size_t LEN = Token_Account_LEN;
+
+    /**
+     * The mint associated with this account
+     */
+    struct mint {
+        static constexpr size_t offset = Token_Account_mint_OFFSET;
+        static constexpr size_t size = 32;
+        static constexpr auto get = Token_Account_get_mint;
+        static constexpr auto set = Token_Account_set_mint;
+        static constexpr auto is = Token_Account_mint_is;
+    };
+
+    /**
+     * The owner of this account.
+     */
+    struct owner {
+        static constexpr size_t offset = Token_Account_owner_OFFSET;
+        static constexpr size_t size = 32;
+        static constexpr auto get = Token_Account_get_owner;
+        static constexpr auto set = Token_Account_set_owner;
+        static constexpr auto is = Token_Account_owner_is;
+    };
+
+    /**
+     * The amount of tokens this account holds.
+     */
+    struct amount {
+        static constexpr size_t offset = Token_Account_amount_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = Token_Account_get_amount;
+        static constexpr auto set = Token_Account_set_amount;
+    };
+
+    /**
+     * If `delegate` is `Some` then `delegated_amount` is the amount authorized
+     */
+    struct delegate {
+        static constexpr size_t offset = Token_Account_delegate_OFFSET;
+        static constexpr size_t size = 36;
+        static constexpr auto get = Token_Account_get_delegate;
+        static constexpr auto set = Token_Account_set_delegate;
+        static constexpr auto is = Token_Account_delegate_is;
+    };
+
+    /**
+     * The account's state
+     */
+    struct state {
+        static constexpr size_t offset = Token_Account_state_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = Token_Account_get_state;
+        static constexpr auto set = Token_Account_set_state;
+    };
+
+    /**
+     * If is_some, this is a native token, and the value logs the rent-exempt reserve.
+     */
+    struct is_native {
+        static constexpr size_t offset = Token_Account_is_native_OFFSET;
+        static constexpr size_t size = 12;
+        static constexpr auto get = Token_Account_get_is_native;
+        static constexpr auto set = Token_Account_set_is_native;
+    };
+
+    /**
+     * The amount delegated
+     */
+    struct delegated_amount {
+        static constexpr size_t offset = Token_Account_delegated_amount_OFFSET;
+        static constexpr size_t size = 8;
+        static constexpr auto get = Token_Account_get_delegated_amount;
+        static constexpr auto set = Token_Account_set_delegated_amount;
+    };
+
+    /**
+     * Optional authority to close the account.
+     */
+    struct close_authority {
+        static constexpr size_t offset = Token_Account_close_authority_OFFSET;
+        static constexpr size_t size = 36;
+        static constexpr auto get = Token_Account_get_close_authority;
+        static constexpr auto set = Token_Account_set_close_authority;
+        static constexpr auto is = Token_Account_close_authority_is;
+    };
+};
+
+/**
+ * Packed `Token_Multisig` fields
+ */
+struct Multisig {
+    static constexpr size_t LEN = Token_Multisig_LEN;
+
+    /**
+     * Number of signers required
+     */
+    struct m {
+        static constexpr size_t offset = Token_Multisig_m_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = Token_Multisig_get_m;
+        static constexpr auto set = Token_Multisig_set_m;
+    };
+
+    /**
+     * Number of valid signers
+     */
+    struct n {
+        static constexpr size_t offset = Token_Multisig_n_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = Token_Multisig_get_n;
+        static constexpr auto set = Token_Multisig_set_n;
+    };
+
+    /**
+     * Is `true` if this structure has been initialized
+     */
+    struct is_initialized {
+        static constexpr size_t offset = Token_Multisig_is_initialized_OFFSET;
+        static constexpr size_t size = 1;
+        static constexpr auto get = Token_Multisig_get_is_initialized;
+        static constexpr auto set = Token_Multisig_set_is_initialized;
+    };
+
+    /**
+     * Signer public keys
+     */
+    struct signers {
+        static constexpr size_t offset = Token_Multisig_signers_OFFSET;
+        static constexpr size_t size = 352;
+        static constexpr auto get = Token_Multisig_get_signers;
+        static constexpr auto set = Token_Multisig_set_signers;
+    };
+};
+
+} // namespace Token
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @brief SPL Token multisig validation for C programs
+ *
+ * Mirrors the multisig branch of `Processor::validate_owner`: every position
+ * of the multisig whose key matches a signer account counts once towards `m`,
+ * and a matching account that did not sign the transaction is an error.
+ *
+ * Instead of comparing every account against every multisig key, the keys are
+ * placed in a small open-addressing table that maps each distinct key to the
+ * bitmask of positions holding it.  A single pass over the accounts then ORs
+ * the masks together and the popcount of the result is compared with `m`.
+ * `Token_validate_owner` adds the single-owner branch on top.
+ */
+#pragma once
+
+#include <solana_sdk.h>
+#include "token-layout.h"
+
+/// `TokenError::OwnerMismatch`
+#define Token_ERROR_OWNER_MISMATCH 4
+
+/// Slots in a `Token_MultisigSigners` table, a power of two above
+/// `Token_MAX_SIGNERS` so probe sequences stay short
+#define Token_MULTISIG_SLOTS 16
+
+/// Marks an unused slot
+#define Token_MULTISIG_EMPTY_SLOT 0xff
+
+/// Multisig keys indexed by pubkey hash
+typedef struct {
+  /// Packed multisig data the positions refer to
+  const uint8_t *data;
+  /// Number of valid signers `m`
+  uint8_t m;
+  /// Position of the first key stored in each slot, or
+  /// `Token_MULTISIG_EMPTY_SLOT`
+  uint8_t positions[Token_MULTISIG_SLOTS];
+  /// Every position holding the slot's key
+  uint16_t masks[Token_MULTISIG_SLOTS];
+} Token_MultisigSigners;
+
+/**
+ * Indexes the keys of packed multisig `data`
+ *
+ * Returns `ERROR_INVALID_ACCOUNT_DATA` if `data` does not unpack, holds more
+ * than `Token_MAX_SIGNERS` keys or an `m` outside of `1..=n`, which
+ * `InitializeMultisig` rejects, and `ERROR_UNINITIALIZED_ACCOUNT` if the
+ * multisig is not initialized.  `data` must outlive `table`.
+ */
+static inline uint64_t Token_MultisigSigners_init(Token_MultisigSigners *table,
+                                                  const uint8_t *data,
+                                                  uint64_t data_len) {
+  if (!Token_Multisig_is_valid(data, data_len)) {
+    return ERROR_INVALID_ACCOUNT_DATA;
+  }
+  if (!Token_Multisig_get_is_initialized(data)) {
+    return ERROR_UNINITIALIZED_ACCOUNT;
+  }
+  uint8_t n = Token_Multisig_get_n(data);
+  uint8_t m = Token_Multisig_get_m(data);
+  if (n > Token_MAX_SIGNERS || m == 0 || m > n) {
+    return ERROR_INVALID_ACCOUNT_DATA;
+  }
+
+  table->data = data;
+  table->m = m;
+  for (int i = 0; i < Token_MULTISIG_SLOTS; i++) {
+    table->positions[i] = Token_MULTISIG_EMPTY_SLOT;
+    table->masks[i] = 0;
+  }
+  for (uint8_t position = 0; position < n; position++) {
+    const uint8_t *key = Token_Multisig_get_signers(data, position);
+    uint64_t slot = SplPubkey_hash(key) & (Token_MULTISIG_SLOTS - 1);
+    while (table->positions[slot] != Token_MULTISIG_EMPTY_SLOT &&
+           !SplPubkey_eq(
+               Token_Multisig_get_signers(data, table->positions[slot]), key)) {
+      slot = (slot + 1) & (Token_MULTISIG_SLOTS - 1);
+    }
+    if (table->positions[slot] == Token_MULTISIG_EMPTY_SLOT) {
+      table->positions[slot] = position;
+    }
+    table->masks[slot] |= (uint16_t)(1 << position);
+  }
+  return SUCCESS;
+}
+
+/// Returns the positions holding `key`, zero if it is not a multisig signer
+static inline uint16_t
+Token_MultisigSigners_positions(const Token_MultisigSigners *table,
+                                const SolPubkey *key) {
+  uint64_t slot = SplPubkey_hash(key->x) & (Token_MULTISIG_SLOTS - 1);
+  while (table->positions[slot] != Token_MULTISIG_EMPTY_SLOT) {
+    if (SplPubkey_eq(
+            Token_Multisig_get_signers(table->data, table->positions[slot]),
+            key->x)) {
+      return table->masks[slot];
+    }
+    slot = (slot + 1) & (Token_MULTISIG_SLOTS - 1);
+  }
+  return 0;
+}
+
+/**
+ * Checks that `signers` satisfy the multisig
+ *
+ * Returns `ERROR_MISSING_REQUIRED_SIGNATURES` if an account matching an
+ * unmatched position did not sign, or fewer than `m` positions were matched.
+ */
+static inline uint64_t
+Token_MultisigSigners_validate(const Token_MultisigSigners *table,
+                               const SolAccountInfo *signers,
+                               uint64_t signers_len) {
+  uint16_t matched = 0;
+  for (uint64_t i = 0; i < signers_len; i++) {
+    uint16_t positions =
+        Token_MultisigSigners_positions(table, signers[i].key) & ~matched;
+    if (positions != 0) {
+      if (!signers[i].is_signer) {
+        return ERROR_MISSING_REQUIRED_SIGNATURES;
+      }
+      matched |= positions;
+    }
+  }
+  if (__builtin_popcount(matched) < table->m) {
+    return ERROR_MISSING_REQUIRED_SIGNATURES;
+  }
+  return SUCCESS;
+}
+
+/// Indexes packed multisig `data` and validates `signers` against it in one
+/// call, for programs that check a multisig only once per instruction
+static inline uint64_t Token_validate_multisig(const uint8_t *data,
+                                               uint64_t data_len,
+                                               const SolAccountInfo *signers,
+                                               uint64_t signers_len) {
+  Token_MultisigSigners table;
+  uint64_t result = Token_MultisigSigners_init(&table, data, data_len);
+  if (result != SUCCESS) {
+    return result;
+  }
+  return Token_MultisigSigners_validate(&table, signers, signers_len);
+}
+
+/**
+ * Checks that `owner` is `expected_owner` and that it or, if it is a multisig
+ * account of `program_id`, enough of its `signers` signed, as
+ * `Processor::validate_owner` does
+ *
+ * Returns `Token_ERROR_OWNER_MISMATCH` if `owner` is not `expected_owner`,
+ * the errors of `Token_validate_multisig` for a multisig owner and
+ * `ERROR_MISSING_REQUIRED_SIGNATURES` if a single owner did not sign.
+ */
+static inline uint64_t Token_validate_owner(const SolPubkey *program_id,
+                                            const uint8_t *expected_owner,
+                                            const SolAccountInfo *owner,
+                                            const SolAccountInfo *signers,
+                                            uint64_t signers_len) {
+  if (!SplPubkey_eq(expected_owner, owner->key->x)) {
+    return Token_ERROR_OWNER_MISMATCH;
+  }
+  if (SplPubkey_eq(owner->owner->x, program_id->x) &&
+      owner->data_len == Token_Multisig_LEN) {
+    return Token_validate_multisig(owner->data, owner->data_len, signers,
+                                   signers_len);
+  }
+  if (!owner->is_signer) {
+    return ERROR_MISSING_REQUIRED_SIGNATURES;
+  }
+  return SUCCESS;
+}
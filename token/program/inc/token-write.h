@@ -0,0 +1,173 @@
+/**
+ * @brief In-place writes to packed SPL Token accounts for C programs
+ *
+ * `Token_Account_borrow_mut` checks once per instruction everything a write to
+ * a token account depends on: owned by the running program, writable, data
+ * that unpacks, initialized and not frozen.  The packed data it returns is
+ * then changed field by field with the `token-layout.h` setters or the
+ * balance helpers below, so no write unpacks and repacks the whole account.
+ *
+ * The helpers mirror the checks of `spl_token::processor::Processor`, with
+ * custom errors numbered like `spl_token::error::TokenError`.  Checking the
+ * authority that signed for a write is left to the caller, see
+ * `token-multisig.h`.
+ */
+#pragma once
+
+#include <solana_sdk.h>
+#include "token-layout.h"
+
+/// `TokenError::InsufficientFunds`
+#define Token_ERROR_INSUFFICIENT_FUNDS 1
+/// `TokenError::MintMismatch`
+#define Token_ERROR_MINT_MISMATCH 3
+/// `TokenError::Overflow`
+#define Token_ERROR_OVERFLOW 14
+/// `TokenError::AccountFrozen`
+#define Token_ERROR_ACCOUNT_FROZEN 17
+
+/**
+ * Checks that `account` is a token account `program_id` may write and returns
+ * its packed data in `data`
+ *
+ * Returns `ERROR_INCORRECT_PROGRAM_ID` if the account is not owned by
+ * `program_id`, the only program whose writes the runtime keeps,
+ * `ERROR_INVALID_ARGUMENT` if it is not writable, `ERROR_INVALID_ACCOUNT_DATA`
+ * if its data does not unpack, `ERROR_UNINITIALIZED_ACCOUNT` if it is not
+ * initialized and `Token_ERROR_ACCOUNT_FROZEN` if it is frozen.
+ */
+static inline uint64_t Token_Account_borrow_mut(const SolAccountInfo *account,
+                                                const SolPubkey *program_id,
+                                                uint8_t **data) {
+  if (!SplPubkey_eq(account->owner->x, program_id->x)) {
+    return ERROR_INCORRECT_PROGRAM_ID;
+  }
+  if (!account->is_writable) {
+    return ERROR_INVALID_ARGUMENT;
+  }
+  if (!Token_Account_is_valid(account->data, account->data_len)) {
+    return ERROR_INVALID_ACCOUNT_DATA;
+  }
+  switch (Token_Account_get_state(account->data)) {
+  case Token_AccountState_Uninitialized:
+    return ERROR_UNINITIALIZED_ACCOUNT;
+  case Token_AccountState_Frozen:
+    return Token_ERROR_ACCOUNT_FROZEN;
+  default:
+    *data = account->data;
+    return SUCCESS;
+  }
+}
+
+/// Adds `amount` to the balance of packed account `data`, returning
+/// `Token_ERROR_OVERFLOW` and leaving it unchanged if it would overflow
+static inline uint64_t Token_Account_credit(uint8_t *data, uint64_t amount) {
+  uint64_t balance;
+  if (__builtin_add_overflow(Token_Account_get_amount(data), amount,
+                             &balance)) {
+    return Token_ERROR_OVERFLOW;
+  }
+  Token_Account_set_amount(data, balance);
+  return SUCCESS;
+}
+
+/// Subtracts `amount` from the balance of packed account `data`, returning
+/// `Token_ERROR_INSUFFICIENT_FUNDS` and leaving it unchanged if it is short
+static inline uint64_t Token_Account_debit(uint8_t *data, uint64_t amount) {
+  uint64_t balance;
+  if (__builtin_sub_overflow(Token_Account_get_amount(data), amount,
+                             &balance)) {
+    return Token_ERROR_INSUFFICIENT_FUNDS;
+  }
+  Token_Account_set_amount(data, balance);
+  return SUCCESS;
+}
+
+/**
+ * Spends `amount` of the delegated amount of packed account `data`, revoking
+ * the delegate once nothing is left, as a transfer or burn by the delegate does
+ *
+ * Returns `Token_ERROR_INSUFFICIENT_FUNDS` and leaves the account unchanged if
+ * less than `amount` is delegated.  Debiting the balance itself is up to the
+ * caller.
+ */
+static inline uint64_t Token_Account_spend_delegated(uint8_t *data,
+                                                     uint64_t amount) {
+  uint64_t delegated;
+  if (__builtin_sub_overflow(Token_Account_get_delegated_amount(data), amount,
+                             &delegated)) {
+    return Token_ERROR_INSUFFICIENT_FUNDS;
+  }
+  Token_Account_set_delegated_amount(data, delegated);
+  if (delegated == 0) {
+    Token_Account_set_delegate(data, NULL);
+  }
+  return SUCCESS;
+}
+
+/**
+ * Moves `amount` tokens between two token accounts owned by `program_id`,
+ * and the lamports backing them if the mint is native
+ *
+ * Checks no authority: the caller must first validate that the source's
+ * owner or delegate signed, see `Token_validate_owner`, and spend a
+ * delegate's allowance with `Token_Account_spend_delegated`.
+ *
+ * Fails with the errors of `Token_Account_borrow_mut`, with
+ * `Token_ERROR_MINT_MISMATCH` if the accounts hold different mints and with
+ * the errors of the balance helpers, leaving both accounts unchanged.  A
+ * transfer from an account to itself only checks the balance.
+ */
+static inline uint64_t
+Token_transfer_in_place_unauthorized(const SolAccountInfo *source,
+                                     const SolAccountInfo *destination,
+                                     const SolPubkey *program_id,
+                                     uint64_t amount) {
+  uint8_t *source_data;
+  uint8_t *destination_data;
+  uint64_t result = Token_Account_borrow_mut(source, program_id, &source_data);
+  if (result != SUCCESS) {
+    return result;
+  }
+  result = Token_Account_borrow_mut(destination, program_id, &destination_data);
+  if (result != SUCCESS) {
+    return result;
+  }
+  if (!SplPubkey_eq(Token_Account_get_mint(source_data),
+                    Token_Account_get_mint(destination_data))) {
+    return Token_ERROR_MINT_MISMATCH;
+  }
+
+  uint64_t source_amount;
+  uint64_t destination_amount;
+  if (__builtin_sub_overflow(Token_Account_get_amount(source_data), amount,
+                             &source_amount)) {
+    return Token_ERROR_INSUFFICIENT_FUNDS;
+  }
+  // The runtime passes a duplicated account as the same memory
+  if (source_data == destination_data) {
+    return SUCCESS;
+  }
+  if (__builtin_add_overflow(Token_Account_get_amount(destination_data), amount,
+                             &destination_amount)) {
+    return Token_ERROR_OVERFLOW;
+  }
+  // Accounts of the same mint are either both native or both not
+  uint64_t native;
+  if (Token_Account_get_is_native(source_data, &native)) {
+    uint64_t source_lamports;
+    uint64_t destination_lamports;
+    if (__builtin_sub_overflow(*source->lamports, amount, &source_lamports)) {
+      return Token_ERROR_INSUFFICIENT_FUNDS;
+    }
+    if (__builtin_add_overflow(*destination->lamports, amount,
+                               &destination_lamports)) {
+      return Token_ERROR_OVERFLOW;
+    }
+    *source->lamports = source_lamports;
+    *destination->lamports = destination_lamports;
+  }
+  Token_Account_set_amount(source_data, source_amount);
+  Token_Account_set_amount(destination_data, destination_amount);
+  return SUCCESS;
+}
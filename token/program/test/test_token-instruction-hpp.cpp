@@ -0,0 +1,195 @@
+#include "token-instruction.h"
+#include "token-instruction.hpp"
+#include <array>
+#include <criterion/criterion.h>
+
+using Token::Instruction;
+
+// The encoders' sizes agree with the C builders'
+static_assert(Token::max_data_len<Token_TokenInstruction_Transfer> ==
+              Token_TRANSFER_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_Approve> ==
+              Token_APPROVE_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_Revoke> ==
+              Token_REVOKE_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_SetAuthority> ==
+              Token_SET_AUTHORITY_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_MintTo> ==
+              Token_MINT_TO_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_Burn> ==
+              Token_BURN_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_CloseAccount> ==
+              Token_CLOSE_ACCOUNT_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_FreezeAccount> ==
+              Token_FREEZE_ACCOUNT_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_ThawAccount> ==
+              Token_THAW_ACCOUNT_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_TransferChecked> ==
+              Token_TRANSFER_CHECKED_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_ApproveChecked> ==
+              Token_APPROVE_CHECKED_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_MintToChecked> ==
+              Token_MINT_TO_CHECKED_DATA_LEN);
+static_assert(Token::max_data_len<Token_TokenInstruction_BurnChecked> ==
+              Token_BURN_CHECKED_DATA_LEN);
+
+// Instructions without a C builder, sized as `TokenInstruction::pack` writes
+// them with every optional key present
+static_assert(Token::max_data_len<Token_TokenInstruction_InitializeMint> ==
+              1 + 1 + 32 + 1 + 32);
+static_assert(Token::max_data_len<Token_TokenInstruction_InitializeAccount> ==
+              1);
+static_assert(Token::max_data_len<Token_TokenInstruction_InitializeMultisig> ==
+              2);
+static_assert(Token::max_data_len<Token_TokenInstruction_InitializeAccount2> ==
+              1 + 32);
+
+// Accounts before any multisig signers, as the C builders push them
+static_assert(Instruction<Token_TokenInstruction_InitializeMint>::accounts_len ==
+              2);
+static_assert(Instruction<Token_TokenInstruction_Transfer>::accounts_len == 3);
+static_assert(Instruction<Token_TokenInstruction_Revoke>::accounts_len == 2);
+static_assert(Instruction<Token_TokenInstruction_SetAuthority>::accounts_len ==
+              2);
+static_assert(
+    Instruction<Token_TokenInstruction_TransferChecked>::accounts_len == 4);
+static_assert(Instruction<Token_TokenInstruction_MintToChecked>::accounts_len ==
+              3);
+
+static_assert(Token::batch_data_len<> == 0);
+static_assert(Token::batch_data_len<Token_TokenInstruction_Transfer> == 9);
+static_assert(Token::batch_data_len<Token_TokenInstruction_Transfer,
+                                    Token_TokenInstruction_CloseAccount> ==
+              10);
+static_assert(Token::batch_data_len<Token_TokenInstruction_SetAuthority,
+                                    Token_TokenInstruction_TransferChecked,
+                                    Token_TokenInstruction_InitializeMint> ==
+              35 + 10 + 67);
+
+static SolPubkey program_id = {{6, 221, 246, 225}};
+static SolPubkey keys[4] = {{{1}}, {{2}}, {{3}}, {{4}}};
+
+#define AMOUNT 0x0807060504030201
+
+/// Checks that `encoded` holds exactly the data of the C builder's
+/// `instruction`
+static void check(std::span<const uint8_t> encoded,
+                  const SolInstruction &instruction) {
+  cr_assert(encoded.size() == instruction.data_len);
+  cr_assert(0 == sol_memcmp(encoded.data(), instruction.data,
+                            instruction.data_len));
+}
+
+Test(token_instruction_hpp, encode_matches_c_builders) {
+  SolInstruction instruction;
+  uint8_t data[Token_SET_AUTHORITY_DATA_LEN];
+  SolAccountMeta accounts[Token_MAX_INSTRUCTION_ACCOUNTS];
+  std::array<uint8_t, Token_SET_AUTHORITY_DATA_LEN> buffer;
+  std::span<uint8_t, Token_SET_AUTHORITY_DATA_LEN> out(buffer);
+
+  Token_transfer(&instruction, data, accounts, &program_id, &keys[0], &keys[1],
+                 &keys[2], NULL, 0, AMOUNT);
+  check(Token::encode<Token_TokenInstruction_Transfer>(out, AMOUNT),
+        instruction);
+  Token_approve(&instruction, data, accounts, &program_id, &keys[0], &keys[1],
+                &keys[2], NULL, 0, AMOUNT);
+  check(Token::encode<Token_TokenInstruction_Approve>(out, AMOUNT),
+        instruction);
+  Token_revoke(&instruction, data, accounts, &program_id, &keys[0], &keys[2],
+               NULL, 0);
+  check(Token::encode<Token_TokenInstruction_Revoke>(out), instruction);
+  Token_mint_to(&instruction, data, accounts, &program_id, &keys[0], &keys[1],
+                &keys[2], NULL, 0, AMOUNT);
+  check(Token::encode<Token_TokenInstruction_MintTo>(out, AMOUNT),
+        instruction);
+  Token_burn(&instruction, data, accounts, &program_id, &keys[0], &keys[1],
+             &keys[2], NULL, 0, AMOUNT);
+  check(Token::encode<Token_TokenInstruction_Burn>(out, AMOUNT), instruction);
+  Token_close_account(&instruction, data, accounts, &program_id, &keys[0],
+                      &keys[1], &keys[2], NULL, 0);
+  check(Token::encode<Token_TokenInstruction_CloseAccount>(out), instruction);
+  Token_freeze_account(&instruction, data, accounts, &program_id, &keys[0],
+                       &keys[1], &keys[2], NULL, 0);
+  check(Token::encode<Token_TokenInstruction_FreezeAccount>(out),
+        instruction);
+  Token_thaw_account(&instruction, data, accounts, &program_id, &keys[0],
+                     &keys[1], &keys[2], NULL, 0);
+  check(Token::encode<Token_TokenInstruction_ThawAccount>(out), instruction);
+
+  Token_transfer_checked(&instruction, data, accounts, &program_id, &keys[0],
+                         &keys[1], &keys[2], &keys[3], NULL, 0, AMOUNT, 6);
+  check(Token::encode<Token_TokenInstruction_TransferChecked>(out, AMOUNT,
+                                                              (uint8_t)6),
+        instruction);
+  Token_approve_checked(&instruction, data, accounts, &program_id, &keys[0],
+                        &keys[1], &keys[2], &keys[3], NULL, 0, AMOUNT, 6);
+  check(Token::encode<Token_TokenInstruction_ApproveChecked>(out, AMOUNT,
+                                                             (uint8_t)6),
+        instruction);
+  Token_mint_to_checked(&instruction, data, accounts, &program_id, &keys[0],
+                        &keys[1], &keys[2], NULL, 0, AMOUNT, 6);
+  check(Token::encode<Token_TokenInstruction_MintToChecked>(out, AMOUNT,
+                                                            (uint8_t)6),
+        instruction);
+  Token_burn_checked(&instruction, data, accounts, &program_id, &keys[0],
+                     &keys[1], &keys[2], NULL, 0, AMOUNT, 6);
+  check(Token::encode<Token_TokenInstruction_BurnChecked>(out, AMOUNT,
+                                                          (uint8_t)6),
+        instruction);
+}
+
+Test(token_instruction_hpp, set_authority_matches_c_builder) {
+  SolInstruction instruction;
+  uint8_t data[Token_SET_AUTHORITY_DATA_LEN];
+  SolAccountMeta accounts[Token_MAX_INSTRUCTION_ACCOUNTS];
+  std::array<uint8_t, Token_SET_AUTHORITY_DATA_LEN> buffer;
+
+  Token_set_authority(&instruction, data, accounts, &program_id, &keys[0],
+                      &keys[3], Token_AuthorityType_CloseAccount, &keys[2],
+                      NULL, 0);
+  check(Token::encode<Token_TokenInstruction_SetAuthority>(
+            std::span(buffer), Token_AuthorityType_CloseAccount, keys[3].x),
+        instruction);
+
+  // Removing the authority packs only the `None` tag, through a buffer whose
+  // size is only known at run time
+  Token_set_authority(&instruction, data, accounts, &program_id, &keys[0],
+                      NULL, Token_AuthorityType_MintTokens, &keys[2], NULL, 0);
+  std::span<uint8_t> dynamic(buffer.data(), buffer.size());
+  check(Token::encode<Token_TokenInstruction_SetAuthority>(
+            dynamic, Token_AuthorityType_MintTokens, Token::NO_PUBKEY),
+        instruction);
+}
+
+Test(token_instruction_hpp, encoder_packs_a_batch) {
+  SolInstruction instruction;
+  uint8_t data[Token_SET_AUTHORITY_DATA_LEN];
+  SolAccountMeta accounts[Token_MAX_INSTRUCTION_ACCOUNTS];
+  std::array<uint8_t, Token::batch_data_len<Token_TokenInstruction_Transfer,
+                                            Token_TokenInstruction_SetAuthority,
+                                            Token_TokenInstruction_CloseAccount>>
+      buffer;
+  Token::Encoder encoder(buffer);
+
+  auto transfer = encoder.push<Token_TokenInstruction_Transfer>(AMOUNT);
+  auto set_authority = encoder.push<Token_TokenInstruction_SetAuthority>(
+      Token_AuthorityType_AccountOwner, Token::NO_PUBKEY);
+  auto close = encoder.push<Token_TokenInstruction_CloseAccount>();
+
+  // Each instruction follows the last, taking only the bytes it encodes to
+  cr_assert(transfer.data() == buffer.data());
+  cr_assert(set_authority.data() == transfer.data() + transfer.size());
+  cr_assert(close.data() == set_authority.data() + set_authority.size());
+  cr_assert(encoder.len() == 9 + 3 + 1);
+
+  Token_transfer(&instruction, data, accounts, &program_id, &keys[0], &keys[1],
+                 &keys[2], NULL, 0, AMOUNT);
+  check(transfer, instruction);
+  Token_set_authority(&instruction, data, accounts, &program_id, &keys[0],
+                      NULL, Token_AuthorityType_AccountOwner, &keys[2], NULL,
+                      0);
+  check(set_authority, instruction);
+  Token_close_account(&instruction, data, accounts, &program_id, &keys[0],
+                      &keys[1], &keys[2], NULL, 0);
+  check(close, instruction);
+}
@@ -0,0 +1,237 @@
+#include "token-instruction.h"
+#include <criterion/criterion.h>
+
+/// Expected account meta, as pushed by the `spl_token::instruction` builder
+typedef struct {
+  SolPubkey *pubkey;
+  bool is_writable;
+  bool is_signer;
+} Meta;
+
+static SolPubkey program_id = {{6, 221, 246, 225}};
+static SolPubkey keys[6] = {{{1}}, {{2}}, {{3}}, {{4}}, {{5}}, {{6}}};
+static SolPubkey *const signers[2] = {&keys[4], &keys[5]};
+
+/// 0x0807060504030201 packs as `amount.to_le_bytes()` 01 02 ... 08
+#define AMOUNT 0x0807060504030201
+#define AMOUNT_BYTES 1, 2, 3, 4, 5, 6, 7, 8
+
+static void check(const SolInstruction *instruction, const uint8_t *data,
+                  uint64_t data_len, const Meta *metas, uint64_t metas_len) {
+  cr_assert(instruction->program_id == &program_id);
+  cr_assert(instruction->data_len == data_len);
+  cr_assert(0 == sol_memcmp(instruction->data, data, data_len));
+  cr_assert(instruction->account_len == metas_len);
+  for (uint64_t i = 0; i < metas_len; i++) {
+    cr_assert(instruction->accounts[i].pubkey == metas[i].pubkey);
+    cr_assert(instruction->accounts[i].is_writable == metas[i].is_writable);
+    cr_assert(instruction->accounts[i].is_signer == metas[i].is_signer);
+  }
+}
+
+Test(token_instruction, transfer) {
+  SolInstruction instruction;
+  uint8_t data[Token_TRANSFER_DATA_LEN];
+  SolAccountMeta accounts[Token_MAX_INSTRUCTION_ACCOUNTS];
+  const uint8_t expected[] = {3, AMOUNT_BYTES};
+
+  Token_transfer(&instruction, data, accounts, &program_id, &keys[0], &keys[1],
+                 &keys[2], NULL, 0, AMOUNT);
+  const Meta single[] = {
+      {&keys[0], true, false}, {&keys[1], true, false}, {&keys[2], false, true}};
+  check(&instruction, expected, sizeof(expected), single, 3);
+
+  // With multisig signers the authority itself does not sign
+  Token_transfer(&instruction, data, accounts, &program_id, &keys[0], &keys[1],
+                 &keys[2], signers, 2, AMOUNT);
+  const Meta multisig[] = {{&keys[0], true, false},
+                           {&keys[1], true, false},
+                           {&keys[2], false, false},
+                           {&keys[4], false, true},
+                           {&keys[5], false, true}};
+  check(&instruction, expected, sizeof(expected), multisig, 5);
+}
+
+Test(token_instruction, approve_and_revoke) {
+  SolInstruction instruction;
+  uint8_t data[Token_APPROVE_DATA_LEN];
+  SolAccountMeta accounts[Token_MAX_INSTRUCTION_ACCOUNTS];
+
+  Token_approve(&instruction, data, accounts, &program_id, &keys[0], &keys[1],
+                &keys[2], signers, 1, AMOUNT);
+  const uint8_t approve[] = {4, AMOUNT_BYTES};
+  const Meta approve_metas[] = {{&keys[0], true, false},
+                                {&keys[1], false, false},
+                                {&keys[2], false, false},
+                                {&keys[4], false, true}};
+  check(&instruction, approve, sizeof(approve), approve_metas, 4);
+
+  Token_revoke(&instruction, data, accounts, &program_id, &keys[0], &keys[2],
+               NULL, 0);
+  const uint8_t revoke[] = {5};
+  const Meta revoke_metas[] = {{&keys[0], true, false},
+                               {&keys[2], false, true}};
+  check(&instruction, revoke, sizeof(revoke), revoke_metas, 2);
+}
+
+Test(token_instruction, set_authority) {
+  SolInstruction instruction;
+  uint8_t data[Token_SET_AUTHORITY_DATA_LEN];
+  SolAccountMeta accounts[Token_MAX_INSTRUCTION_ACCOUNTS];
+  const Meta metas[] = {{&keys[0], true, false}, {&keys[2], false, true}};
+
+  Token_set_authority(&instruction, data, accounts, &program_id, &keys[0],
+                      &keys[3], Token_AuthorityType_CloseAccount, &keys[2],
+                      NULL, 0);
+  uint8_t some[Token_SET_AUTHORITY_DATA_LEN] = {6, 3, 1, 4};
+  check(&instruction, some, sizeof(some), metas, 2);
+
+  Token_set_authority(&instruction, data, accounts, &program_id, &keys[0],
+                      NULL, Token_AuthorityType_MintTokens, &keys[2], NULL, 0);
+  const uint8_t none[] = {6, 0, 0};
+  check(&instruction, none, sizeof(none), metas, 2);
+}
+
+Test(token_instruction, mint_to_and_burn) {
+  SolInstruction instruction;
+  uint8_t data[Token_BURN_CHECKED_DATA_LEN];
+  SolAccountMeta accounts[Token_MAX_INSTRUCTION_ACCOUNTS];
+  const Meta mint_metas[] = {
+      {&keys[3], true, false}, {&keys[0], true, false}, {&keys[2], false, true}};
+  const Meta burn_metas[] = {
+      {&keys[0], true, false}, {&keys[3], true, false}, {&keys[2], false, true}};
+
+  Token_mint_to(&instruction, data, accounts, &program_id, &keys[3], &keys[0],
+                &keys[2], NULL, 0, AMOUNT);
+  const uint8_t mint_to[] = {7, AMOUNT_BYTES};
+  check(&instruction, mint_to, sizeof(mint_to), mint_metas, 3);
+
+  Token_mint_to_checked(&instruction, data, accounts, &program_id, &keys[3],
+                        &keys[0], &keys[2], NULL, 0, AMOUNT, 9);
+  const uint8_t mint_to_checked[] = {14, AMOUNT_BYTES, 9};
+  check(&instruction, mint_to_checked, sizeof(mint_to_checked), mint_metas, 3);
+
+  Token_burn(&instruction, data, accounts, &program_id, &keys[0], &keys[3],
+             &keys[2], NULL, 0, AMOUNT);
+  const uint8_t burn[] = {8, AMOUNT_BYTES};
+  check(&instruction, burn, sizeof(burn), burn_metas, 3);
+
+  Token_burn_checked(&instruction, data, accounts, &program_id, &keys[0],
+                     &keys[3], &keys[2], NULL, 0, AMOUNT, 9);
+  const uint8_t burn_checked[] = {15, AMOUNT_BYTES, 9};
+  check(&instruction, burn_checked, sizeof(burn_checked), burn_metas, 3);
+}
+
+Test(token_instruction, close_freeze_and_thaw) {
+  SolInstruction instruction;
+  uint8_t data[Token_CLOSE_ACCOUNT_DATA_LEN];
+  SolAccountMeta accounts[Token_MAX_INSTRUCTION_ACCOUNTS];
+
+  Token_close_account(&instruction, data, accounts, &program_id, &keys[0],
+                      &keys[1], &keys[2], NULL, 0);
+  const uint8_t close[] = {9};
+  const Meta close_metas[] = {
+      {&keys[0], true, false}, {&keys[1], true, false}, {&keys[2], false, true}};
+  check(&instruction, close, sizeof(close), close_metas, 3);
+
+  const Meta freeze_metas[] = {{&keys[0], true, false},
+                               {&keys[3], false, false},
+                               {&keys[2], false, true}};
+  Token_freeze_account(&instruction, data, accounts, &program_id, &keys[0],
+                       &keys[3], &keys[2], NULL, 0);
+  const uint8_t freeze[] = {10};
+  check(&instruction, freeze, sizeof(freeze), freeze_metas, 3);
+
+  Token_thaw_account(&instruction, data, accounts, &program_id, &keys[0],
+                     &keys[3], &keys[2], NULL, 0);
+  const uint8_t thaw[] = {11};
+  check(&instruction, thaw, sizeof(thaw), freeze_metas, 3);
+}
+
+Test(token_instruction, checked) {
+  SolInstruction instruction;
+  uint8_t data[Token_TRANSFER_CHECKED_DATA_LEN];
+  SolAccountMeta accounts[Token_MAX_INSTRUCTION_ACCOUNTS];
+
+  Token_transfer_checked(&instruction, data, accounts, &program_id, &keys[0],
+                         &keys[3], &keys[1], &keys[2], signers, 2, AMOUNT, 6);
+  const uint8_t transfer[] = {12, AMOUNT_BYTES, 6};
+  const Meta transfer_metas[] = {{&keys[0], true, false},
+                                 {&keys[3], false, false},
+                                 {&keys[1], true, false},
+                                 {&keys[2], false, false},
+                                 {&keys[4], false, true},
+                                 {&keys[5], false, true}};
+  check(&instruction, transfer, sizeof(transfer), transfer_metas, 6);
+
+  Token_approve_checked(&instruction, data, accounts, &program_id, &keys[0],
+                        &keys[3], &keys[1], &keys[2], NULL, 0, AMOUNT, 6);
+  const uint8_t approve[] = {13, AMOUNT_BYTES, 6};
+  const Meta approve_metas[] = {{&keys[0], true, false},
+                                {&keys[3], false, false},
+                                {&keys[1], false, false},
+                                {&keys[2], false, true}};
+  check(&instruction, approve, sizeof(approve), approve_metas, 4);
+}
+
+/// Transfers seen by the invoke syscall, which the SDK leaves to tests
+static struct {
+  uint8_t data[4][Token_TRANSFER_DATA_LEN];
+  SolPubkey *sources[4];
+  SolPubkey *destinations[4];
+  const SolSignerSeeds *signers_seeds;
+  int calls;
+  int fail_at;
+} invoked;
+
+uint64_t sol_invoke_signed_c(const SolInstruction *instruction,
+                             const SolAccountInfo *account_infos,
+                             int account_infos_len,
+                             const SolSignerSeeds *signers_seeds,
+                             int signers_seeds_len) {
+  (void)account_infos;
+  (void)account_infos_len;
+  (void)signers_seeds_len;
+  int call = invoked.calls++;
+  sol_memcpy(invoked.data[call], instruction->data, instruction->data_len);
+  invoked.sources[call] = instruction->accounts[0].pubkey;
+  invoked.destinations[call] = instruction->accounts[1].pubkey;
+  invoked.signers_seeds = signers_seeds;
+  // Every transfer of a batch is signed by its authority
+  cr_assert(instruction->program_id == &program_id);
+  cr_assert(instruction->account_len == 3);
+  cr_assert(instruction->accounts[2].pubkey == &keys[2]);
+  cr_assert(instruction->accounts[2].is_signer);
+  return call == invoked.fail_at ? ERROR_INSUFFICIENT_FUNDS : SUCCESS;
+}
+
+Test(token_instruction, transfer_batch) {
+  const SolSignerSeed seed = {(const uint8_t *)"seed", 4};
+  const SolSignerSeeds seeds = {&seed, 1};
+  Token_TransferBatch batch;
+  Token_TransferBatch_init(&batch, &program_id, &keys[2], NULL, 0, &seeds, 1);
+  const Token_TransferBatchEntry entries[] = {{&keys[0], &keys[1], AMOUNT},
+                                              {&keys[3], &keys[4], 5},
+                                              {&keys[1], &keys[0], 6}};
+
+  sol_memset(&invoked, 0, sizeof(invoked));
+  invoked.fail_at = -1;
+  cr_assert(SUCCESS == Token_TransferBatch_invoke_all(&batch, entries, 3));
+  cr_assert(3 == invoked.calls);
+  cr_assert(invoked.signers_seeds == &seeds);
+  const uint8_t first[] = {3, AMOUNT_BYTES};
+  const uint8_t second[] = {3, 5, 0, 0, 0, 0, 0, 0, 0};
+  cr_assert(0 == sol_memcmp(invoked.data[0], first, sizeof(first)));
+  cr_assert(0 == sol_memcmp(invoked.data[1], second, sizeof(second)));
+  for (int i = 0; i < 3; i++) {
+    cr_assert(invoked.sources[i] == entries[i].source);
+    cr_assert(invoked.destinations[i] == entries[i].destination);
+  }
+
+  // The first failure stops the batch and is returned
+  sol_memset(&invoked, 0, sizeof(invoked));
+  invoked.fail_at = 1;
+  cr_assert(ERROR_INSUFFICIENT_FUNDS ==
+            Token_TransferBatch_invoke_all(&batch, entries, 3));
+  cr_assert(2 == invoked.calls);
+}
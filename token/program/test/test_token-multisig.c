@@ -0,0 +1,171 @@
+#include "token-multisig.h"
+#include <criterion/criterion.h>
+
+static SolPubkey program_id = {{6, 221, 246, 225}};
+static SolPubkey other_program_id = {{7}};
+static SolPubkey keys[Token_MAX_SIGNERS + 1];
+
+/// Packs an initialized `m` of `n` multisig over the first `n` keys
+static void multisig(uint8_t *data, uint8_t m, uint8_t n) {
+  sol_memset(data, 0, Token_Multisig_LEN);
+  Token_Multisig_set_m(data, m);
+  Token_Multisig_set_n(data, n);
+  Token_Multisig_set_is_initialized(data, true);
+  for (uint8_t i = 0; i < n && i < Token_MAX_SIGNERS; i++) {
+    Token_Multisig_set_signers(data, i, keys[i].x);
+  }
+}
+
+static SolAccountInfo signer(SolPubkey *key, bool is_signer) {
+  SolAccountInfo info;
+  sol_memset(&info, 0, sizeof(info));
+  info.key = key;
+  info.is_signer = is_signer;
+  return info;
+}
+
+/// Distinct keys, the last one outside of every multisig
+static void setup(void) {
+  for (int i = 0; i <= Token_MAX_SIGNERS; i++) {
+    sol_memset(keys[i].x, 0, sizeof(SolPubkey));
+    keys[i].x[0] = 1 + i;
+    keys[i].x[31] = 0xa0 + i;
+  }
+}
+
+Test(token_multisig, exactly_m_signers) {
+  setup();
+  uint8_t data[Token_Multisig_LEN];
+  multisig(data, 3, 5);
+  SolAccountInfo signers[] = {signer(&keys[4], true), signer(&keys[0], true),
+                              signer(&keys[2], true)};
+  cr_assert(SUCCESS == Token_validate_multisig(data, sizeof(data), signers, 3));
+  cr_assert(ERROR_MISSING_REQUIRED_SIGNATURES ==
+            Token_validate_multisig(data, sizeof(data), signers, 2));
+  cr_assert(ERROR_MISSING_REQUIRED_SIGNATURES ==
+            Token_validate_multisig(data, sizeof(data), signers, 0));
+}
+
+Test(token_multisig, duplicate_signers_count_once) {
+  setup();
+  uint8_t data[Token_Multisig_LEN];
+  multisig(data, 2, 3);
+  SolAccountInfo signers[] = {signer(&keys[1], true), signer(&keys[1], true)};
+  cr_assert(ERROR_MISSING_REQUIRED_SIGNATURES ==
+            Token_validate_multisig(data, sizeof(data), signers, 2));
+
+  // A key held at two positions counts for both, as each position matches
+  Token_Multisig_set_signers(data, 2, keys[1].x);
+  cr_assert(SUCCESS == Token_validate_multisig(data, sizeof(data), signers, 1));
+}
+
+Test(token_multisig, matching_key_must_sign) {
+  setup();
+  uint8_t data[Token_Multisig_LEN];
+  multisig(data, 1, 3);
+  SolAccountInfo signers[] = {signer(&keys[0], false), signer(&keys[1], true)};
+  cr_assert(ERROR_MISSING_REQUIRED_SIGNATURES ==
+            Token_validate_multisig(data, sizeof(data), signers, 2));
+
+  // Accounts that are not multisig keys are ignored whether or not they sign
+  signers[0] = signer(&keys[Token_MAX_SIGNERS], false);
+  cr_assert(SUCCESS == Token_validate_multisig(data, sizeof(data), signers, 2));
+
+  // Once a key's positions are matched a duplicate that did not sign is too
+  signers[0] = signer(&keys[1], false);
+  SolAccountInfo duplicated[] = {signers[1], signers[0]};
+  cr_assert(SUCCESS ==
+            Token_validate_multisig(data, sizeof(data), duplicated, 2));
+}
+
+Test(token_multisig, every_key_of_a_full_multisig) {
+  setup();
+  uint8_t data[Token_Multisig_LEN];
+  multisig(data, Token_MAX_SIGNERS, Token_MAX_SIGNERS);
+  SolAccountInfo signers[Token_MAX_SIGNERS];
+  for (int i = 0; i < Token_MAX_SIGNERS; i++) {
+    signers[i] = signer(&keys[Token_MAX_SIGNERS - 1 - i], true);
+  }
+  Token_MultisigSigners table;
+  cr_assert(SUCCESS == Token_MultisigSigners_init(&table, data, sizeof(data)));
+  for (int i = 0; i < Token_MAX_SIGNERS; i++) {
+    cr_assert(1 << i == Token_MultisigSigners_positions(&table, &keys[i]));
+  }
+  cr_assert(0 ==
+            Token_MultisigSigners_positions(&table, &keys[Token_MAX_SIGNERS]));
+  cr_assert(SUCCESS == Token_MultisigSigners_validate(&table, signers,
+                                                      Token_MAX_SIGNERS));
+  cr_assert(ERROR_MISSING_REQUIRED_SIGNATURES ==
+            Token_MultisigSigners_validate(&table, signers,
+                                           Token_MAX_SIGNERS - 1));
+}
+
+Test(token_multisig, invalid_multisig) {
+  setup();
+  uint8_t data[Token_Multisig_LEN];
+  Token_MultisigSigners table;
+
+  multisig(data, 1, Token_MAX_SIGNERS + 1);
+  cr_assert(ERROR_INVALID_ACCOUNT_DATA ==
+            Token_MultisigSigners_init(&table, data, sizeof(data)));
+  multisig(data, 4, 3);
+  cr_assert(ERROR_INVALID_ACCOUNT_DATA ==
+            Token_MultisigSigners_init(&table, data, sizeof(data)));
+  multisig(data, 0, 3);
+  cr_assert(ERROR_INVALID_ACCOUNT_DATA ==
+            Token_MultisigSigners_init(&table, data, sizeof(data)));
+  multisig(data, 1, 3);
+  cr_assert(ERROR_INVALID_ACCOUNT_DATA ==
+            Token_MultisigSigners_init(&table, data, sizeof(data) - 1));
+
+  Token_Multisig_set_is_initialized(data, false);
+  cr_assert(ERROR_UNINITIALIZED_ACCOUNT ==
+            Token_MultisigSigners_init(&table, data, sizeof(data)));
+  data[Token_Multisig_is_initialized_OFFSET] = 2;
+  cr_assert(ERROR_INVALID_ACCOUNT_DATA ==
+            Token_MultisigSigners_init(&table, data, sizeof(data)));
+}
+
+Test(token_multisig, single_owner) {
+  setup();
+  uint8_t data[1] = {0};
+  SolAccountInfo owner = signer(&keys[0], true);
+  owner.owner = &other_program_id;
+  owner.data = data;
+  owner.data_len = sizeof(data);
+
+  cr_assert(SUCCESS ==
+            Token_validate_owner(&program_id, keys[0].x, &owner, NULL, 0));
+  cr_assert(Token_ERROR_OWNER_MISMATCH ==
+            Token_validate_owner(&program_id, keys[1].x, &owner, NULL, 0));
+  owner.is_signer = false;
+  cr_assert(ERROR_MISSING_REQUIRED_SIGNATURES ==
+            Token_validate_owner(&program_id, keys[0].x, &owner, NULL, 0));
+}
+
+Test(token_multisig, multisig_owner) {
+  setup();
+  uint8_t data[Token_Multisig_LEN];
+  multisig(data, 2, 3);
+  SolAccountInfo owner = signer(&keys[Token_MAX_SIGNERS], false);
+  owner.owner = &program_id;
+  owner.data = data;
+  owner.data_len = sizeof(data);
+  SolAccountInfo signers[] = {signer(&keys[0], true), signer(&keys[2], true)};
+  const uint8_t *expected = keys[Token_MAX_SIGNERS].x;
+
+  cr_assert(SUCCESS ==
+            Token_validate_owner(&program_id, expected, &owner, signers, 2));
+  cr_assert(ERROR_MISSING_REQUIRED_SIGNATURES ==
+            Token_validate_owner(&program_id, expected, &owner, signers, 1));
+
+  // The multisig signing itself does not stand in for its keys
+  owner.is_signer = true;
+  cr_assert(ERROR_MISSING_REQUIRED_SIGNATURES ==
+            Token_validate_owner(&program_id, expected, &owner, signers, 1));
+
+  // Multisig data owned by another program is a single owner that signed
+  owner.owner = &other_program_id;
+  cr_assert(SUCCESS ==
+            Token_validate_owner(&program_id, expected, &owner, signers, 0));
+}
@@ -0,0 +1,203 @@
+#include "token-write.h"
+#include <criterion/criterion.h>
+
+static SolPubkey program_id = {{6, 221, 246, 225}};
+static SolPubkey other_program_id = {{7}};
+static SolPubkey mint = {{3}};
+static SolPubkey other_mint = {{4}};
+static SolPubkey keys[2] = {{{1}}, {{2}}};
+
+static uint8_t source_data[Token_Account_LEN];
+static uint8_t destination_data[Token_Account_LEN];
+static uint64_t source_lamports;
+static uint64_t destination_lamports;
+static SolAccountInfo source;
+static SolAccountInfo destination;
+
+static SolAccountInfo account(SolPubkey *key, uint64_t *lamports,
+                              uint8_t *data) {
+  SolAccountInfo info;
+  sol_memset(&info, 0, sizeof(info));
+  info.key = key;
+  info.lamports = lamports;
+  info.data_len = Token_Account_LEN;
+  info.data = data;
+  info.owner = &program_id;
+  info.is_writable = true;
+  return info;
+}
+
+static void token_account(uint8_t *data, uint64_t amount) {
+  sol_memset(data, 0, Token_Account_LEN);
+  Token_Account_set_mint(data, mint.x);
+  Token_Account_set_owner(data, keys[1].x);
+  Token_Account_set_amount(data, amount);
+  Token_Account_set_state(data, Token_AccountState_Initialized);
+}
+
+/// A source holding 50 tokens and a destination holding 7, of the same mint
+static void setup(void) {
+  token_account(source_data, 50);
+  token_account(destination_data, 7);
+  source_lamports = 100;
+  destination_lamports = 5;
+  source = account(&keys[0], &source_lamports, source_data);
+  destination = account(&keys[1], &destination_lamports, destination_data);
+}
+
+/// Checks that transferring `amount` fails with `expected` and writes neither
+/// account
+static void check_rejected(uint64_t expected, uint64_t amount) {
+  uint8_t source_before[Token_Account_LEN];
+  uint8_t destination_before[Token_Account_LEN];
+  sol_memcpy(source_before, source_data, Token_Account_LEN);
+  sol_memcpy(destination_before, destination_data, Token_Account_LEN);
+  uint64_t lamports[] = {source_lamports, destination_lamports};
+
+  cr_assert(expected == Token_transfer_in_place_unauthorized(
+                            &source, &destination, &program_id, amount));
+  cr_assert(0 == sol_memcmp(source_before, source_data, Token_Account_LEN));
+  cr_assert(0 == sol_memcmp(destination_before, destination_data,
+                            Token_Account_LEN));
+  cr_assert(lamports[0] == source_lamports);
+  cr_assert(lamports[1] == destination_lamports);
+}
+
+Test(token_write, borrow_mut) {
+  setup();
+  uint8_t *data = NULL;
+  cr_assert(SUCCESS == Token_Account_borrow_mut(&source, &program_id, &data));
+  cr_assert(data == source_data);
+
+  cr_assert(ERROR_INCORRECT_PROGRAM_ID ==
+            Token_Account_borrow_mut(&source, &other_program_id, &data));
+  source.is_writable = false;
+  cr_assert(ERROR_INVALID_ARGUMENT ==
+            Token_Account_borrow_mut(&source, &program_id, &data));
+  source.is_writable = true;
+  source.data_len--;
+  cr_assert(ERROR_INVALID_ACCOUNT_DATA ==
+            Token_Account_borrow_mut(&source, &program_id, &data));
+  source.data_len++;
+  source_data[Token_Account_state_OFFSET] = Token_AccountState_Frozen + 1;
+  cr_assert(ERROR_INVALID_ACCOUNT_DATA ==
+            Token_Account_borrow_mut(&source, &program_id, &data));
+  Token_Account_set_state(source_data, Token_AccountState_Uninitialized);
+  cr_assert(ERROR_UNINITIALIZED_ACCOUNT ==
+            Token_Account_borrow_mut(&source, &program_id, &data));
+  Token_Account_set_state(source_data, Token_AccountState_Frozen);
+  cr_assert(Token_ERROR_ACCOUNT_FROZEN ==
+            Token_Account_borrow_mut(&source, &program_id, &data));
+}
+
+Test(token_write, transfer) {
+  setup();
+  cr_assert(SUCCESS == Token_transfer_in_place_unauthorized(
+                           &source, &destination, &program_id, 20));
+  cr_assert(30 == Token_Account_get_amount(source_data));
+  cr_assert(27 == Token_Account_get_amount(destination_data));
+  // Lamports only back the balance of native accounts
+  cr_assert(100 == source_lamports && 5 == destination_lamports);
+  cr_assert(SUCCESS == Token_transfer_in_place_unauthorized(
+                           &source, &destination, &program_id, 30));
+  cr_assert(0 == Token_Account_get_amount(source_data));
+}
+
+Test(token_write, rejected_accounts) {
+  setup();
+  Token_Account_set_state(source_data, Token_AccountState_Frozen);
+  check_rejected(Token_ERROR_ACCOUNT_FROZEN, 1);
+  setup();
+  Token_Account_set_state(destination_data, Token_AccountState_Frozen);
+  check_rejected(Token_ERROR_ACCOUNT_FROZEN, 1);
+  setup();
+  Token_Account_set_state(destination_data, Token_AccountState_Uninitialized);
+  check_rejected(ERROR_UNINITIALIZED_ACCOUNT, 1);
+
+  setup();
+  destination.owner = &other_program_id;
+  check_rejected(ERROR_INCORRECT_PROGRAM_ID, 1);
+  setup();
+  destination.is_writable = false;
+  check_rejected(ERROR_INVALID_ARGUMENT, 1);
+  setup();
+  source.is_writable = false;
+  check_rejected(ERROR_INVALID_ARGUMENT, 1);
+
+  setup();
+  Token_Account_set_mint(destination_data, other_mint.x);
+  check_rejected(Token_ERROR_MINT_MISMATCH, 1);
+}
+
+Test(token_write, rejected_amounts) {
+  setup();
+  check_rejected(Token_ERROR_INSUFFICIENT_FUNDS, 51);
+  Token_Account_set_amount(destination_data, UINT64_MAX - 1);
+  check_rejected(Token_ERROR_OVERFLOW, 2);
+  cr_assert(SUCCESS == Token_transfer_in_place_unauthorized(
+                           &source, &destination, &program_id, 1));
+
+  // A native account whose lamports fall short of its balance fails whole
+  setup();
+  uint64_t rent = 1;
+  Token_Account_set_is_native(source_data, &rent);
+  Token_Account_set_is_native(destination_data, &rent);
+  source_lamports = 40;
+  check_rejected(Token_ERROR_INSUFFICIENT_FUNDS, 45);
+  destination_lamports = UINT64_MAX;
+  check_rejected(Token_ERROR_OVERFLOW, 1);
+}
+
+Test(token_write, self_transfer) {
+  setup();
+  // The runtime passes both accounts as the same memory
+  SolAccountInfo duplicate = source;
+  cr_assert(SUCCESS == Token_transfer_in_place_unauthorized(
+                           &source, &duplicate, &program_id, 50));
+  cr_assert(50 == Token_Account_get_amount(source_data));
+  cr_assert(100 == source_lamports);
+  cr_assert(Token_ERROR_INSUFFICIENT_FUNDS ==
+            Token_transfer_in_place_unauthorized(&source, &duplicate,
+                                                 &program_id, 51));
+  cr_assert(50 == Token_Account_get_amount(source_data));
+}
+
+Test(token_write, native_transfer) {
+  setup();
+  uint64_t rent = 2;
+  Token_Account_set_is_native(source_data, &rent);
+  Token_Account_set_is_native(destination_data, &rent);
+  cr_assert(SUCCESS == Token_transfer_in_place_unauthorized(
+                           &source, &destination, &program_id, 10));
+  cr_assert(40 == Token_Account_get_amount(source_data));
+  cr_assert(17 == Token_Account_get_amount(destination_data));
+  cr_assert(90 == source_lamports && 15 == destination_lamports);
+}
+
+Test(token_write, delegated) {
+  setup();
+  Token_Account_set_delegate(source_data, keys[1].x);
+  Token_Account_set_delegated_amount(source_data, 5);
+  cr_assert(Token_ERROR_INSUFFICIENT_FUNDS ==
+            Token_Account_spend_delegated(source_data, 6));
+  cr_assert(5 == Token_Account_get_delegated_amount(source_data));
+  cr_assert(SUCCESS == Token_Account_spend_delegated(source_data, 2));
+  cr_assert(Token_Account_delegate_is(source_data, keys[1].x));
+  cr_assert(SUCCESS == Token_Account_spend_delegated(source_data, 3));
+  cr_assert(NULL == Token_Account_get_delegate(source_data));
+  cr_assert(0 == Token_Account_get_delegated_amount(source_data));
+  cr_assert(Token_Account_is_valid(source_data, Token_Account_LEN));
+}
+
+Test(token_write, balance) {
+  setup();
+  cr_assert(Token_ERROR_OVERFLOW ==
+            Token_Account_credit(source_data, UINT64_MAX));
+  cr_assert(50 == Token_Account_get_amount(source_data));
+  cr_assert(SUCCESS == Token_Account_credit(source_data, 10));
+  cr_assert(SUCCESS == Token_Account_debit(source_data, 60));
+  cr_assert(0 == Token_Account_get_amount(source_data));
+  cr_assert(Token_ERROR_INSUFFICIENT_FUNDS ==
+            Token_Account_debit(source_data, 1));
+  cr_assert(0 == Token_Account_get_amount(source_data));
+}
@@ -0,0 +1,762 @@
+//! Packed account layouts and the zero-copy C accessors generated from them.
+//!
+//! cbindgen describes the Rust structs with C layout, which does not match the
+//! packed account data the programs store.  The tables here mirror the
+//! `array_refs!` splits in each program's `Pack` implementation.
+
+use std::fmt::Write;
+
+/// How a packed field is encoded
+#[derive(Clone, Copy, Debug, PartialEq)]
+pub enum FieldKind {
+    /// 32-byte public key
+    Pubkey,
+    /// Little-endian `u64`
+    U64,
+    /// Single byte
+    U8,
+    /// Single byte, `0` or `1`
+    Bool,
+    /// Single byte C-like enum, with the exported type name and last variant
+    /// without prefix
+    Enum(&'static str, &'static str),
+    /// Single byte that must hold the given value, such as a version
+    Tag(u8),
+    /// 4-byte little-endian tag followed by a 32-byte public key
+    COptionPubkey,
+    /// 4-byte little-endian tag followed by a little-endian `u64`
+    COptionU64,
+    /// Fixed number of consecutive 32-byte public keys, with the C constant
+    /// holding the count
+    PubkeyArray(usize, &'static str),
+    /// Opaque fixed-length bytes
+    Bytes(usize),
+}
+
+impl FieldKind {
+    /// Number of bytes the field occupies in packed account data
+    pub fn size(self) -> usize {
+        match self {
+            FieldKind::Pubkey => 32,
+            FieldKind::U64 => 8,
+            FieldKind::U8 | FieldKind::Bool | FieldKind::Enum(..) | FieldKind::Tag(_) => 1,
+            FieldKind::COptionPubkey => 36,
+            FieldKind::COptionU64 => 12,
+            FieldKind::PubkeyArray(count, _) => 32 * count,
+            FieldKind::Bytes(len) => len,
+        }
+    }
+}
+
+/// A single packed field
+pub struct Field {
+    pub name: &'static str,
+    pub kind: FieldKind,
+    pub doc: &'static str,
+}
+
+/// Packed layout of an account type
+pub struct Layout {
+    /// Exported C name, including prefix
+    pub name: &'static str,
+    /// Packed length, `Pack::LEN`
+    pub len: usize,
+    /// Whether the cbindgen header declares a struct of the same name with the
+    /// same fields, whose member sizes are then checked against the packing
+    pub bindings: bool,
+    /// Field that is non-zero once the account is initialized, as checked by
+    /// the program's `IsInitialized` implementation
+    pub initialized: &'static str,
+    pub fields: &'static [Field],
+}
+
+impl Layout {
+    /// Fields paired with their byte offset, checking that they exactly cover
+    /// the packed length
+    pub fn offsets(&self) -> Vec<(usize, &Field)> {
+        let mut offset = 0;
+        let mut offsets = Vec::with_capacity(self.fields.len());
+        for field in self.fields {
+            offsets.push((offset, field));
+            offset += field.kind.size();
+        }
+        assert_eq!(
+            offset, self.len,
+            "{} fields do not cover its packed length",
+            self.name
+        );
+        offsets
+    }
+}
+
+/// `spl_token::state::Mint`
+pub const TOKEN_MINT: Layout = Layout {
+    name: "Token_Mint",
+    len: 82,
+    bindings: true,
+    initialized: "is_initialized",
+    fields: &[
+        Field {
+            name: "mint_authority",
+            kind: FieldKind::COptionPubkey,
+            doc: "Optional authority used to mint new tokens.",
+        },
+        Field {
+            name: "supply",
+            kind: FieldKind::U64,
+            doc: "Total supply of tokens.",
+        },
+        Field {
+            name: "decimals",
+            kind: FieldKind::U8,
+            doc: "Number of base 10 digits to the right of the decimal place.",
+        },
+        Field {
+            name: "is_initialized",
+            kind: FieldKind::Bool,
+            doc: "Is `true` if this structure has been initialized",
+        },
+        Field {
+            name: "freeze_authority",
+            kind: FieldKind::COptionPubkey,
+            doc: "Optional authority to freeze token accounts.",
+        },
+    ],
+};
+
+/// `spl_token::state::Account`
+pub const TOKEN_ACCOUNT: Layout = Layout {
+    name: "Token_Account",
+    len: 165,
+    bindings: true,
+    initialized: "state",
+    fields: &[
+        Field {
+            name: "mint",
+            kind: FieldKind::Pubkey,
+            doc: "The mint associated with this account",
+        },
+        Field {
+            name: "owner",
+            kind: FieldKind::Pubkey,
+            doc: "The owner of this account.",
+        },
+        Field {
+            name: "amount",
+            kind: FieldKind::U64,
+            doc: "The amount of tokens this account holds.",
+        },
+        Field {
+            name: "delegate",
+            kind: FieldKind::COptionPubkey,
+            doc: "If `delegate` is `Some` then `delegated_amount` is the amount authorized",
+        },
+        Field {
+            name: "state",
+            kind: FieldKind::Enum("AccountState", "AccountState_Frozen"),
+            doc: "The account's state",
+        },
+        Field {
+            name: "is_native",
+            kind: FieldKind::COptionU64,
+            doc: "If is_some, this is a native token, and the value logs the rent-exempt reserve.",
+        },
+        Field {
+            name: "delegated_amount",
+            kind: FieldKind::U64,
+            doc: "The amount delegated",
+        },
+        Field {
+            name: "close_authority",
+            kind: FieldKind::COptionPubkey,
+            doc: "Optional authority to close the account.",
+        },
+    ],
+};
+
+/// `spl_token::state::Multisig`
+pub const TOKEN_MULTISIG: Layout = Layout {
+    name: "Token_Multisig",
+    len: 355,
+    bindings: true,
+    initialized: "is_initialized",
+    fields: &[
+        Field {
+            name: "m",
+            kind: FieldKind::U8,
+            doc: "Number of signers required",
+        },
+        Field {
+            name: "n",
+            kind: FieldKind::U8,
+            doc: "Number of valid signers",
+        },
+        Field {
+            name: "is_initialized",
+            kind: FieldKind::Bool,
+            doc: "Is `true` if this structure has been initialized",
+        },
+        Field {
+            name: "signers",
+            kind: FieldKind::PubkeyArray(11, "Token_MAX_SIGNERS"),
+            doc: "Signer public keys",
+        },
+    ],
+};
+
+/// Layouts exported for the token program
+pub const TOKEN_LAYOUTS: &[&Layout] = &[&TOKEN_MINT, &TOKEN_ACCOUNT, &TOKEN_MULTISIG];
+
+/// `spl_token_swap::state::SwapVersion::SwapV1`, including the version byte
+pub const TOKEN_SWAP_INFO: Layout = Layout {
+    name: "TokenSwap_SwapInfo",
+    len: 324,
+    bindings: false,
+    initialized: "is_initialized",
+    fields: &[
+        Field {
+            name: "version",
+            kind: FieldKind::Tag(1),
+            doc: "Swap state version, only version 1 is supported",
+        },
+        Field {
+            name: "is_initialized",
+            kind: FieldKind::Bool,
+            doc: "Initialized state.",
+        },
+        Field {
+            name: "nonce",
+            kind: FieldKind::U8,
+            doc: "Nonce used in program address.",
+        },
+        Field {
+            name: "token_program_id",
+            kind: FieldKind::Pubkey,
+            doc: "Program ID of the tokens being exchanged.",
+        },
+        Field {
+            name: "token_a",
+            kind: FieldKind::Pubkey,
+            doc: "Token A liquidity account",
+        },
+        Field {
+            name: "token_b",
+            kind: FieldKind::Pubkey,
+            doc: "Token B liquidity account",
+        },
+        Field {
+            name: "pool_mint",
+            kind: FieldKind::Pubkey,
+            doc: "Pool tokens are issued when A or B tokens are deposited.",
+        },
+        Field {
+            name: "token_a_mint",
+            kind: FieldKind::Pubkey,
+            doc: "Mint information for token A",
+        },
+        Field {
+            name: "token_b_mint",
+            kind: FieldKind::Pubkey,
+            doc: "Mint information for token B",
+        },
+        Field {
+            name: "pool_fee_account",
+            kind: FieldKind::Pubkey,
+            doc: "Pool token account to receive trading and / or withdrawal fees",
+        },
+        Field {
+            name: "trade_fee_numerator",
+            kind: FieldKind::U64,
+            doc: "Trade fee numerator",
+        },
+        Field {
+            name: "trade_fee_denominator",
+            kind: FieldKind::U64,
+            doc: "Trade fee denominator",
+        },
+        Field {
+            name: "owner_trade_fee_numerator",
+            kind: FieldKind::U64,
+            doc: "Owner trade fee numerator",
+        },
+        Field {
+            name: "owner_trade_fee_denominator",
+            kind: FieldKind::U64,
+            doc: "Owner trade fee denominator",
+        },
+        Field {
+            name: "owner_withdraw_fee_numerator",
+            kind: FieldKind::U64,
+            doc: "Owner withdraw fee numerator",
+        },
+        Field {
+            name: "owner_withdraw_fee_denominator",
+            kind: FieldKind::U64,
+            doc: "Owner withdraw fee denominator",
+        },
+        Field {
+            name: "host_fee_numerator",
+            kind: FieldKind::U64,
+            doc: "Host trading fee numerator",
+        },
+        Field {
+            name: "host_fee_denominator",
+            kind: FieldKind::U64,
+            doc: "Host trading fee denominator",
+        },
+        Field {
+            name: "curve_type",
+            kind: FieldKind::Enum("CurveType", "CurveType_Offset"),
+            doc: "The type of curve contained in the calculator",
+        },
+        Field {
+            name: "curve_parameter",
+            kind: FieldKind::U64,
+            doc: "`token_b_price` of a constant price curve, `amp` of a stable curve, `token_b_offset` of an offset curve, unused by a constant product curve",
+        },
+        Field {
+            name: "curve_padding",
+            kind: FieldKind::Bytes(24),
+            doc: "Calculator bytes no curve uses yet",
+        },
+    ],
+};
+
+/// Layouts exported for the token-swap program
+pub const TOKEN_SWAP_LAYOUTS: &[&Layout] = &[&TOKEN_SWAP_INFO];
+
+/// Token program layouts of the accounts a swap holds, whose offsets the
+/// token-swap headers read
+pub const TOKEN_SWAP_FOREIGN_LAYOUTS: &[&Layout] = &[&TOKEN_MINT, &TOKEN_ACCOUNT];
+
+fn doc(out: &mut String, text: &str) {
+    out.push_str("/**\n");
+    writeln!(out, " * {}", text).unwrap();
+    out.push_str(" */\n");
+}
+
+fn accessors(out: &mut String, prefix: &str, layout: &Layout, offset: usize, field: &Field) {
+    let name = layout.name;
+    let field_name = field.name;
+    let at = format!("{}_{}_OFFSET", name, field_name);
+
+    doc(out, field.doc);
+    writeln!(out, "#define {} {}", at, offset).unwrap();
+    out.push('\n');
+
+    match field.kind {
+        FieldKind::Pubkey => {
+            writeln!(
+                out,
+                "static inline const uint8_t *{}_get_{}(const uint8_t *data) {{\n    return data + {};\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+            writeln!(
+                out,
+                "static inline void {}_set_{}(uint8_t *data, const uint8_t *value) {{\n    __builtin_memcpy(data + {}, value, 32);\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+            writeln!(
+                out,
+                "static inline bool {}_{}_is(const uint8_t *data, const uint8_t *key) {{\n    return SplPubkey_eq(data + {}, key);\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+        }
+        FieldKind::U64 => {
+            writeln!(
+                out,
+                "static inline uint64_t {}_get_{}(const uint8_t *data) {{\n    return {}_read_u64(data + {});\n}}\n",
+                name, field_name, prefix, at
+            )
+            .unwrap();
+            writeln!(
+                out,
+                "static inline void {}_set_{}(uint8_t *data, uint64_t value) {{\n    {}_write_u64(data + {}, value);\n}}\n",
+                name, field_name, prefix, at
+            )
+            .unwrap();
+        }
+        FieldKind::U8 | FieldKind::Tag(_) => {
+            writeln!(
+                out,
+                "static inline uint8_t {}_get_{}(const uint8_t *data) {{\n    return data[{}];\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+            writeln!(
+                out,
+                "static inline void {}_set_{}(uint8_t *data, uint8_t value) {{\n    data[{}] = value;\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+        }
+        FieldKind::Bool => {
+            writeln!(
+                out,
+                "static inline bool {}_get_{}(const uint8_t *data) {{\n    return data[{}] == 1;\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+            writeln!(
+                out,
+                "static inline void {}_set_{}(uint8_t *data, bool value) {{\n    data[{}] = value ? 1 : 0;\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+        }
+        FieldKind::Enum(type_name, _) => {
+            writeln!(
+                out,
+                "static inline {p}_{t} {}_get_{}(const uint8_t *data) {{\n    return ({p}_{t})data[{}];\n}}\n",
+                name,
+                field_name,
+                at,
+                p = prefix,
+                t = type_name
+            )
+            .unwrap();
+            writeln!(
+                out,
+                "static inline void {}_set_{}(uint8_t *data, {}_{} value) {{\n    data[{}] = (uint8_t)value;\n}}\n",
+                name, field_name, prefix, type_name, at
+            )
+            .unwrap();
+        }
+        FieldKind::COptionPubkey => {
+            out.push_str("/**\n * Returns `NULL` if the field is `None`\n */\n");
+            writeln!(
+                out,
+                "static inline const uint8_t *{}_get_{}(const uint8_t *data) {{\n    if ({}_read_u32(data + {at}) != 1) {{\n        return NULL;\n    }}\n    return data + {at} + 4;\n}}\n",
+                name,
+                field_name,
+                prefix,
+                at = at
+            )
+            .unwrap();
+            out.push_str("/**\n * Passing `NULL` sets the field to `None`\n */\n");
+            writeln!(
+                out,
+                "static inline void {}_set_{}(uint8_t *data, const uint8_t *value) {{\n    if (value == NULL) {{\n        {p}_write_u32(data + {at}, 0);\n    }} else {{\n        {p}_write_u32(data + {at}, 1);\n        __builtin_memcpy(data + {at} + 4, value, 32);\n    }}\n}}\n",
+                name,
+                field_name,
+                p = prefix,
+                at = at
+            )
+            .unwrap();
+            out.push_str("/**\n * Returns `false` if the field is `None`\n */\n");
+            writeln!(
+                out,
+                "static inline bool {}_{}_is(const uint8_t *data, const uint8_t *key) {{\n    return {}_read_u32(data + {at}) == 1 && SplPubkey_eq(data + {at} + 4, key);\n}}\n",
+                name,
+                field_name,
+                prefix,
+                at = at
+            )
+            .unwrap();
+        }
+        FieldKind::COptionU64 => {
+            out.push_str(
+                "/**\n * Returns `false` if the field is `None`, otherwise stores the value\n */\n",
+            );
+            writeln!(
+                out,
+                "static inline bool {}_get_{}(const uint8_t *data, uint64_t *value) {{\n    if ({p}_read_u32(data + {at}) != 1) {{\n        return false;\n    }}\n    *value = {p}_read_u64(data + {at} + 4);\n    return true;\n}}\n",
+                name,
+                field_name,
+                p = prefix,
+                at = at
+            )
+            .unwrap();
+            out.push_str("/**\n * Passing `NULL` sets the field to `None`\n */\n");
+            writeln!(
+                out,
+                "static inline void {}_set_{}(uint8_t *data, const uint64_t *value) {{\n    if (value == NULL) {{\n        {p}_write_u32(data + {at}, 0);\n    }} else {{\n        {p}_write_u32(data + {at}, 1);\n        {p}_write_u64(data + {at} + 4, *value);\n    }}\n}}\n",
+                name,
+                field_name,
+                p = prefix,
+                at = at
+            )
+            .unwrap();
+        }
+        FieldKind::PubkeyArray(_, count) => {
+            writeln!(out, "/**\n * `index` must be less than `{}`\n */", count).unwrap();
+            writeln!(
+                out,
+                "static inline const uint8_t *{}_get_{}(const uint8_t *data, size_t index) {{\n    return data + {} + 32 * index;\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+            writeln!(out, "/**\n * `index` must be less than `{}`\n */", count).unwrap();
+            writeln!(
+                out,
+                "static inline void {}_set_{}(uint8_t *data, size_t index, const uint8_t *value) {{\n    __builtin_memcpy(data + {} + 32 * index, value, 32);\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+        }
+        FieldKind::Bytes(len) => {
+            writeln!(
+                out,
+                "static inline const uint8_t *{}_get_{}(const uint8_t *data) {{\n    return data + {};\n}}\n",
+                name, field_name, at
+            )
+            .unwrap();
+            writeln!(
+                out,
+                "static inline void {}_set_{}(uint8_t *data, const uint8_t *value) {{\n    __builtin_memcpy(data + {}, value, {});\n}}\n",
+                name, field_name, at, len
+            )
+            .unwrap();
+        }
+    }
+}
+
+fn validator(out: &mut String, prefix: &str, layout: &Layout, offsets: &[(usize, &Field)]) {
+    let name = layout.name;
+    assert!(
+        offsets
+            .iter()
+            .any(|(_, field)| field.name == layout.initialized),
+        "{} has no field {}",
+        name,
+        layout.initialized
+    );
+    let mut checks = vec![format!("data_len == {}_LEN", name)];
+    for (_, field) in offsets {
+        let at = format!("{}_{}_OFFSET", name, field.name);
+        match field.kind {
+            FieldKind::Bool => checks.push(format!("(data[{}] <= 1)", at)),
+            FieldKind::Enum(_, last) => {
+                checks.push(format!("(data[{}] <= {}_{})", at, prefix, last))
+            }
+            FieldKind::Tag(value) => checks.push(format!("(data[{}] == {})", at, value)),
+            FieldKind::COptionPubkey | FieldKind::COptionU64 => {
+                checks.push(format!("({}_read_u32(data + {}) <= 1)", prefix, at))
+            }
+            _ => {}
+        }
+    }
+    writeln!(
+        out,
+        "/**\n * Checks the length and every tag of packed `{}` data, accepting exactly\n * what the program's `unpack_unchecked` accepts\n */",
+        name
+    )
+    .unwrap();
+    writeln!(
+        out,
+        "static inline bool {}_is_valid(const uint8_t *data, uint64_t data_len) {{\n    return {};\n}}\n",
+        name,
+        checks.join(" &&\n           ")
+    )
+    .unwrap();
+    writeln!(
+        out,
+        "/**\n * Checks packed `{}` data like `{}_is_valid` and that it is initialized,\n * accepting exactly what the program's `unpack` accepts\n */",
+        name, name
+    )
+    .unwrap();
+    writeln!(
+        out,
+        "static inline bool {}_is_initialized(const uint8_t *data, uint64_t data_len) {{\n    return {}_is_valid(data, data_len) && data[{}_{}_OFFSET] != 0;\n}}\n",
+        name, name, name, layout.initialized
+    )
+    .unwrap();
+}
+
+fn assertions(out: &mut String, prefix: &str, layout: &Layout, offsets: &[(usize, &Field)]) {
+    let name = layout.name;
+    writeln!(
+        out,
+        "/*\n * `{}` fields must be contiguous, and sized like the cbindgen struct members\n * they are read into\n */",
+        name
+    )
+    .unwrap();
+    if let Some((_, first)) = offsets.first() {
+        writeln!(
+            out,
+            "{}_STATIC_ASSERT({}_{}_OFFSET == 0, \"{}.{} is not the first packed field\");",
+            prefix, name, first.name, name, first.name
+        )
+        .unwrap();
+    }
+    for (i, (_, field)) in offsets.iter().enumerate() {
+        let end = match offsets.get(i + 1) {
+            Some((_, next)) => format!("{}_{}_OFFSET", name, next.name),
+            None => format!("{}_LEN", name),
+        };
+        writeln!(
+            out,
+            "{}_STATIC_ASSERT({}_{}_OFFSET + {} == {}, \"{}.{} does not end where the next packed field starts\");",
+            prefix,
+            name,
+            field.name,
+            field.kind.size(),
+            end,
+            name,
+            field.name
+        )
+        .unwrap();
+    }
+    if !layout.bindings {
+        out.push('\n');
+        return;
+    }
+    for (_, field) in offsets {
+        let (member, size) = match field.kind {
+            FieldKind::Pubkey | FieldKind::U64 | FieldKind::U8 | FieldKind::Bool => {
+                (field.name.to_string(), field.kind.size().to_string())
+            }
+            FieldKind::COptionPubkey | FieldKind::COptionU64 => (
+                format!("{}.some", field.name),
+                (field.kind.size() - 4).to_string(),
+            ),
+            FieldKind::PubkeyArray(count, constant) => {
+                writeln!(
+                    out,
+                    "{}_STATIC_ASSERT({} == {}, \"{}.{} does not hold {} keys\");",
+                    prefix, constant, count, name, field.name, constant
+                )
+                .unwrap();
+                (field.name.to_string(), format!("32 * {}", constant))
+            }
+            // Enums are decoded from their byte into the C enum type, whatever
+            // its size
+            FieldKind::Enum(..) | FieldKind::Tag(_) | FieldKind::Bytes(_) => continue,
+        };
+        writeln!(
+            out,
+            "{}_STATIC_ASSERT(sizeof((({} *)0)->{}) == {}, \"{}.{} does not match its packed size\");",
+            prefix, name, member, size, name, field.name
+        )
+        .unwrap();
+    }
+    out.push('\n');
+}
+
+/// Lengths and field offsets of `layouts` of another program, named under
+/// `prefix` so they do not clash with that program's own layout header
+fn foreign_offsets(out: &mut String, prefix: &str, layouts: &[&Layout]) {
+    for layout in layouts {
+        let name = format!("{}_{}", prefix, layout.name);
+        doc(
+            out,
+            &format!("Packed length of `{}` account data", layout.name),
+        );
+        writeln!(out, "#define {}_LEN {}\n", name, layout.len).unwrap();
+        for (offset, field) in layout.offsets() {
+            doc(out, field.doc);
+            writeln!(out, "#define {}_{}_OFFSET {}\n", name, field.name, offset).unwrap();
+        }
+    }
+}
+
+fn cpp_accessors(out: &mut String, prefix: &str, layouts: &[&Layout]) {
+    writeln!(out, "#ifdef __cplusplus\nnamespace {} {{\n", prefix).unwrap();
+    writeln!(
+        out,
+        "/**\n * Reads a field through its C accessor, e.g.\n * `{p}::get<{p}::{l}::{f}>(data)`, which the compiler inlines to the load itself\n */",
+        p = prefix,
+        l = &layouts[0].name[prefix.len() + 1..],
+        f = layouts[0].fields[1].name
+    )
+    .unwrap();
+    out.push_str("template <typename Field, typename... Args>\ninline auto get(const uint8_t *data, Args... args) -> decltype(Field::get(data, args...)) {\n    return Field::get(data, args...);\n}\n\n");
+    out.push_str("template <typename Field, typename... Args>\ninline void set(uint8_t *data, Args... args) {\n    Field::set(data, args...);\n}\n\n");
+    out.push_str(
+        "/**\n * Compares a public key field, `false` if an optional one is `None`\n */\n",
+    );
+    out.push_str("template <typename Field>\ninline bool is(const uint8_t *data, const uint8_t *key) {\n    return Field::is(data, key);\n}\n\n");
+
+    for layout in layouts {
+        let name = layout.name;
+        doc(out, &format!("Packed `{}` fields", name));
+        writeln!(
+            out,
+            "struct {} {{\n    static constexpr size_t LEN = {}_LEN;\n",
+            &name[prefix.len() + 1..],
+            name
+        )
+        .unwrap();
+        for (i, field) in layout.fields.iter().enumerate() {
+            if i > 0 {
+                out.push('\n');
+            }
+            writeln!(out, "    /**\n     * {}\n     */", field.doc).unwrap();
+            writeln!(
+                out,
+                "    struct {f} {{\n        static constexpr size_t offset = {n}_{f}_OFFSET;\n        static constexpr size_t size = {};\n        static constexpr auto get = {n}_get_{f};\n        static constexpr auto set = {n}_set_{f};",
+                field.kind.size(),
+                n = name,
+                f = field.name
+            )
+            .unwrap();
+            if let FieldKind::Pubkey | FieldKind::COptionPubkey = field.kind {
+                writeln!(
+                    out,
+                    "        static constexpr auto is = {}_{}_is;",
+                    name, field.name
+                )
+                .unwrap();
+            }
+            out.push_str("    };\n");
+        }
+        out.push_str("};\n\n");
+    }
+    writeln!(out, "}} // namespace {}\n#endif", prefix).unwrap();
+}
+
+/// Generates the packed layout header for `layouts`, which must all be
+/// exported with `prefix` by the cbindgen header named `bindings`, and the
+/// offsets of the `foreign` layouts of other programs the headers read
+pub fn generate(
+    header: &str,
+    bindings: &str,
+    prefix: &str,
+    layouts: &[&Layout],
+    foreign: &[&Layout],
+) -> String {
+    let mut out = String::new();
+    writeln!(out, "{}\n", header).unwrap();
+    out.push_str("#pragma once\n\n");
+    writeln!(
+        out,
+        "#include \"{}\"\n#include \"spl-pubkey.h\"\n",
+        bindings
+    )
+    .unwrap();
+    out.push_str(
+        "#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__\n#error \"packed account data is little-endian\"\n#endif\n\n",
+    );
+    writeln!(
+        out,
+        "static inline uint32_t {p}_read_u32(const uint8_t *src) {{\n    uint32_t value;\n    __builtin_memcpy(&value, src, sizeof(value));\n    return value;\n}}\n\nstatic inline uint64_t {p}_read_u64(const uint8_t *src) {{\n    uint64_t value;\n    __builtin_memcpy(&value, src, sizeof(value));\n    return value;\n}}\n\nstatic inline void {p}_write_u32(uint8_t *dst, uint32_t value) {{\n    __builtin_memcpy(dst, &value, sizeof(value));\n}}\n\nstatic inline void {p}_write_u64(uint8_t *dst, uint64_t value) {{\n    __builtin_memcpy(dst, &value, sizeof(value));\n}}\n",
+        p = prefix
+    )
+    .unwrap();
+    writeln!(
+        out,
+        "\n#ifdef __cplusplus\n#define {p}_STATIC_ASSERT static_assert\n#else\n#define {p}_STATIC_ASSERT _Static_assert\n#endif\n",
+        p = prefix
+    )
+    .unwrap();
+
+    for layout in layouts {
+        let offsets = layout.offsets();
+        doc(
+            &mut out,
+            &format!("Packed length of `{}` account data", layout.name),
+        );
+        writeln!(out, "#define {}_LEN {}\n", layout.name, layout.len).unwrap();
+        for (offset, field) in &offsets {
+            accessors(&mut out, prefix, layout, *offset, field);
+        }
+        validator(&mut out, prefix, layout, &offsets);
+        assertions(&mut out, prefix, layout, &offsets);
+    }
+    foreign_offsets(&mut out, prefix, foreign);
+    cpp_accessors(&mut out, prefix, layouts);
+    out
+}
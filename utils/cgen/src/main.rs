@@ -1,7 +1,11 @@
 extern crate cbindgen;
 
+mod layout;
+mod manifest;
+
 use std::env;
-use std::path::Path;
+use std::fs;
+use std::path::{Path, PathBuf};
 
 fn token<P: AsRef<Path>>(crate_dir: P) {
     let output_file = crate_dir.as_ref().join("inc/token.h");
@@ -45,16 +49,132 @@ fn token<P: AsRef<Path>>(crate_dir: P) {
         .write_to_file(output_file);
 }
 
+fn token_layout<P: AsRef<Path>>(crate_dir: P) {
+    let output_file = crate_dir.as_ref().join("inc/token-layout.h");
+    println!("Generating {}", output_file.display());
+
+    let header = layout::generate(
+        "/* Autogenerated SPL Token program packed account layout */",
+        "token.h",
+        "Token",
+        layout::TOKEN_LAYOUTS,
+        &[],
+    );
+    fs::write(output_file, header).unwrap();
+}
+
+fn pubkey<P: AsRef<Path>>(crate_dir: P) {
+    let output_file = crate_dir.as_ref().join("inc/spl-pubkey.h");
+    println!("Generating {}", output_file.display());
+
+    fs::write(output_file, include_str!("spl-pubkey.h")).unwrap();
+}
+
 fn token_swap<P: AsRef<Path>>(crate_dir: P) {
     let output_file = crate_dir.as_ref().join("inc/token-swap.h");
     println!("Generating {}", output_file.display());
 
-    cbindgen::generate(crate_dir)
+    let config = cbindgen::Config {
+        header: Some("/* Autogenerated SPL Token-Swap program C Bindings */".to_string()),
+        language: cbindgen::Language::C,
+        line_length: 80,
+        style: cbindgen::Style::Both,
+        tab_width: 4,
+        cpp_compat: true,
+        pragma_once: true,
+        enumeration: cbindgen::EnumConfig {
+            prefix_with_name: true,
+            ..cbindgen::EnumConfig::default()
+        },
+        export: cbindgen::ExportConfig {
+            prefix: Some("TokenSwap_".to_string()),
+            // `SwapCurve` holds a boxed trait object with no C representation,
+            // so the types embedding it are described by token-swap-layout.h
+            include: vec![
+                "CurveType".to_string(),
+                "Swap".to_string(),
+                "DepositAllTokenTypes".to_string(),
+                "WithdrawAllTokenTypes".to_string(),
+                "DepositSingleTokenTypeExactAmountIn".to_string(),
+                "WithdrawSingleTokenTypeExactAmountOut".to_string(),
+            ],
+            exclude: vec![
+                "SwapInstruction".to_string(),
+                "Initialize".to_string(),
+                "SwapCurve".to_string(),
+                "SwapV1".to_string(),
+            ],
+            ..cbindgen::ExportConfig::default()
+        },
+        parse: cbindgen::ParseConfig {
+            parse_deps: true,
+            include: Some(vec!["solana-program".to_string()]),
+            ..cbindgen::ParseConfig::default()
+        },
+        ..cbindgen::Config::default()
+    };
+    cbindgen::Builder::new()
+        .with_crate(crate_dir)
+        .with_config(config)
+        .generate()
         .unwrap()
         .write_to_file(output_file);
 }
 
+fn token_swap_layout<P: AsRef<Path>>(crate_dir: P) {
+    let output_file = crate_dir.as_ref().join("inc/token-swap-layout.h");
+    println!("Generating {}", output_file.display());
+
+    let header = layout::generate(
+        "/* Autogenerated SPL Token-Swap program packed account layout */",
+        "token-swap.h",
+        "TokenSwap",
+        layout::TOKEN_SWAP_LAYOUTS,
+        layout::TOKEN_SWAP_FOREIGN_LAYOUTS,
+    );
+    fs::write(output_file, header).unwrap();
+}
+
+/// Writes `inc/<name>-manifest.json` describing `layouts` and the variants of
+/// the `instruction` enum
+fn write_manifest(
+    crate_dir: &Path,
+    name: &str,
+    hash: &str,
+    prefix: &str,
+    headers: &[&str],
+    layouts: &[&layout::Layout],
+    instruction: &str,
+) {
+    let output_file = manifest_path(crate_dir, name);
+    println!("Generating {}", output_file.display());
+
+    let source = fs::read_to_string(crate_dir.join("src/instruction.rs")).unwrap();
+    let instructions = manifest::enum_variants(&source, instruction);
+    let manifest = manifest::generate(hash, prefix, headers, layouts, instruction, &instructions);
+    fs::write(output_file, manifest).unwrap();
+}
+
+fn manifest_path(crate_dir: &Path, name: &str) -> PathBuf {
+    crate_dir.join(format!("inc/{}-manifest.json", name))
+}
+
+/// Returns whether the headers of the crate need regenerating, always when
+/// `force` is set
+fn is_stale(crate_dir: &Path, name: &str, hash: &str, headers: &[&str], force: bool) -> bool {
+    let outputs: Vec<PathBuf> = headers
+        .iter()
+        .map(|header| crate_dir.join("inc").join(header))
+        .collect();
+    if force || !manifest::is_current(&manifest_path(crate_dir, name), hash, &outputs) {
+        return true;
+    }
+    println!("Skipping {}, unchanged", crate_dir.display());
+    false
+}
+
 fn main() {
+    let force = env::args().skip(1).any(|arg| arg == "--force");
     let cargo_manifest_dir = env::var("CARGO_MANIFEST_DIR").unwrap();
     let workspace_root = Path::new(&cargo_manifest_dir)
         .parent()
@@ -62,6 +182,45 @@ fn main() {
         .parent()
         .unwrap();
 
-    token(&workspace_root.join("token/program"));
-    token_swap(&workspace_root.join("token-swap/program"));
+    let token_dir = workspace_root.join("token/program");
+    let token_headers = ["token.h", "token-layout.h", "spl-pubkey.h"];
+    let hash = manifest::source_hash(&token_dir);
+    if is_stale(&token_dir, "token", &hash, &token_headers, force) {
+        token(&token_dir);
+        token_layout(&token_dir);
+        pubkey(&token_dir);
+        write_manifest(
+            &token_dir,
+            "token",
+            &hash,
+            "Token",
+            &token_headers,
+            layout::TOKEN_LAYOUTS,
+            "TokenInstruction",
+        );
+    }
+
+    let token_swap_dir = workspace_root.join("token-swap/program");
+    let token_swap_headers = ["token-swap.h", "token-swap-layout.h", "spl-pubkey.h"];
+    let hash = manifest::source_hash(&token_swap_dir);
+    if is_stale(
+        &token_swap_dir,
+        "token-swap",
+        &hash,
+        &token_swap_headers,
+        force,
+    ) {
+        token_swap(&token_swap_dir);
+        token_swap_layout(&token_swap_dir);
+        pubkey(&token_swap_dir);
+        write_manifest(
+            &token_swap_dir,
+            "token-swap",
+            &hash,
+            "TokenSwap",
+            &token_swap_headers,
+            layout::TOKEN_SWAP_LAYOUTS,
+            "SwapInstruction",
+        );
+    }
 }
@@ -0,0 +1,181 @@
+//! Layout manifests written next to the generated headers.
+//!
+//! A manifest lists the packed size and field offsets of each layout and the
+//! tag of each instruction as JSON, so downstream generators can read them
+//! without parsing the programs.  It also records a hash of the program crate
+//! and of this generator, which lets a rerun skip a program that has not
+//! changed since its headers were written.
+
+use crate::layout::{FieldKind, Layout};
+use std::fmt::Write;
+use std::fs;
+use std::path::{Path, PathBuf};
+
+/// FNV-1a, stable across Rust releases unlike `DefaultHasher`
+struct Fnv(u64);
+
+impl Fnv {
+    fn new() -> Self {
+        Fnv(0xcbf2_9ce4_8422_2325)
+    }
+
+    fn write(&mut self, bytes: &[u8]) {
+        for byte in bytes {
+            self.0 ^= u64::from(*byte);
+            self.0 = self.0.wrapping_mul(0x0100_0000_01b3);
+        }
+        // Separates consecutive inputs so their boundaries are hashed too
+        self.0 ^= bytes.len() as u64;
+        self.0 = self.0.wrapping_mul(0x0100_0000_01b3);
+    }
+}
+
+fn source_files(dir: &Path, files: &mut Vec<PathBuf>) {
+    for entry in fs::read_dir(dir).unwrap() {
+        let path = entry.unwrap().path();
+        if path.is_dir() {
+            source_files(&path, files);
+        } else {
+            files.push(path);
+        }
+    }
+}
+
+/// Hashes the crate's manifest and sources together with the generator
+/// itself, so a change to either regenerates the headers.
+///
+/// Dependencies are covered only through the version requirements in
+/// `Cargo.toml`, pass `--force` after updating them in place.
+pub fn source_hash(crate_dir: &Path) -> String {
+    let mut hash = Fnv::new();
+    hash.write(include_str!("main.rs").as_bytes());
+    hash.write(include_str!("layout.rs").as_bytes());
+    hash.write(include_str!("manifest.rs").as_bytes());
+    hash.write(include_str!("spl-pubkey.h").as_bytes());
+
+    let mut files = vec![crate_dir.join("Cargo.toml")];
+    source_files(&crate_dir.join("src"), &mut files);
+    files[1..].sort();
+    for file in files {
+        let name = file.strip_prefix(crate_dir).unwrap();
+        hash.write(name.to_string_lossy().as_bytes());
+        hash.write(&fs::read(&file).unwrap());
+    }
+    format!("{:016x}", hash.0)
+}
+
+/// Returns whether the manifest at `path` was written for `hash` and every
+/// one of `outputs` still exists
+pub fn is_current(path: &Path, hash: &str, outputs: &[PathBuf]) -> bool {
+    let manifest = match fs::read_to_string(path) {
+        Ok(manifest) => manifest,
+        Err(_) => return false,
+    };
+    let recorded = format!("\"source_hash\": \"{}\"", hash);
+    manifest.contains(&recorded) && outputs.iter().all(|output| output.exists())
+}
+
+/// Names of the variants of `enum_name` in `source`, in declaration order,
+/// which is also their tag order
+pub fn enum_variants(source: &str, enum_name: &str) -> Vec<String> {
+    let start = format!("pub enum {} {{", enum_name);
+    let mut lines = source.lines().skip_while(|line| *line != start);
+    assert!(lines.next().is_some(), "enum {} not found", enum_name);
+    lines
+        .take_while(|line| *line != "}")
+        .filter_map(|line| {
+            let variant = line.strip_prefix("    ")?;
+            if !variant.starts_with(|c: char| c.is_ascii_uppercase()) {
+                return None;
+            }
+            let end = variant
+                .find(|c: char| !c.is_ascii_alphanumeric() && c != '_')
+                .unwrap_or_else(|| variant.len());
+            Some(variant[..end].to_string())
+        })
+        .collect()
+}
+
+fn kind(kind: FieldKind) -> String {
+    match kind {
+        FieldKind::Pubkey => "\"kind\": \"pubkey\"".to_string(),
+        FieldKind::U64 => "\"kind\": \"u64\"".to_string(),
+        FieldKind::U8 => "\"kind\": \"u8\"".to_string(),
+        FieldKind::Bool => "\"kind\": \"bool\"".to_string(),
+        FieldKind::Enum(type_name, _) => format!("\"kind\": \"enum\", \"type\": \"{}\"", type_name),
+        FieldKind::Tag(value) => format!("\"kind\": \"tag\", \"value\": {}", value),
+        FieldKind::COptionPubkey => "\"kind\": \"coption_pubkey\"".to_string(),
+        FieldKind::COptionU64 => "\"kind\": \"coption_u64\"".to_string(),
+        FieldKind::PubkeyArray(count, _) => {
+            format!("\"kind\": \"pubkey_array\", \"count\": {}", count)
+        }
+        FieldKind::Bytes(_) => "\"kind\": \"bytes\"".to_string(),
+    }
+}
+
+/// Generates the manifest of the layouts and instructions exported with
+/// `prefix` by `headers`
+pub fn generate(
+    hash: &str,
+    prefix: &str,
+    headers: &[&str],
+    layouts: &[&Layout],
+    instruction: &str,
+    instructions: &[String],
+) -> String {
+    let mut out = String::new();
+    out.push_str("{\n");
+    writeln!(out, "  \"source_hash\": \"{}\",", hash).unwrap();
+    writeln!(out, "  \"prefix\": \"{}\",", prefix).unwrap();
+    let headers: Vec<String> = headers.iter().map(|h| format!("\"{}\"", h)).collect();
+    writeln!(out, "  \"headers\": [{}],", headers.join(", ")).unwrap();
+
+    out.push_str("  \"layouts\": [\n");
+    for (i, layout) in layouts.iter().enumerate() {
+        writeln!(
+            out,
+            "    {{\n      \"name\": \"{}\",\n      \"len\": {},\n      \"fields\": [",
+            layout.name, layout.len
+        )
+        .unwrap();
+        let offsets = layout.offsets();
+        for (j, (offset, field)) in offsets.iter().enumerate() {
+            writeln!(
+                out,
+                "        {{\"name\": \"{}\", \"offset\": {}, \"size\": {}, {}}}{}",
+                field.name,
+                offset,
+                field.kind.size(),
+                kind(field.kind),
+                if j + 1 < offsets.len() { "," } else { "" }
+            )
+            .unwrap();
+        }
+        writeln!(
+            out,
+            "      ]\n    }}{}",
+            if i + 1 < layouts.len() { "," } else { "" }
+        )
+        .unwrap();
+    }
+    out.push_str("  ],\n");
+
+    writeln!(out, "  \"instruction\": \"{}\",", instruction).unwrap();
+    out.push_str("  \"instructions\": [\n");
+    for (tag, name) in instructions.iter().enumerate() {
+        writeln!(
+            out,
+            "    {{\"name\": \"{}\", \"tag\": {}}}{}",
+            name,
+            tag,
+            if tag + 1 < instructions.len() {
+                ","
+            } else {
+                ""
+            }
+        )
+        .unwrap();
+    }
+    out.push_str("  ]\n}\n");
+    out
+}